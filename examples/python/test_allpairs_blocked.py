@@ -0,0 +1,107 @@
+from monosat import *
+import collections
+import random
+import sys
+
+# Cross-checks the cache-blocked Floyd-Warshall all-pairs detector (-allpairs=blocked-floyd-warshall), with one and
+# with several threads, against the separate single-source detectors (-allpairs-frac=1), on random graphs with forward,
+# backward and bounded reachability constraints from many sources. Some instances have more than two tiles of nodes,
+# so that the tile rows are relaxed in parallel. Each instance is solved repeatedly under random assumptions over its
+# edges, and every model is checked against a direct evaluation of the constraints on the edges it enables.
+
+seed = random.randint(1, 100000)
+if len(sys.argv) > 1:
+    seed = int(sys.argv[1])
+random.seed(seed)
+print("RandomSeed=" + str(seed))
+
+
+def hops(n, edges, enabled, s):
+    out = [[] for _ in range(n)]
+    for (u, v, e) in edges:
+        if enabled[e]:
+            out[u].append(v)
+    dist = [None] * n
+    dist[s] = 0
+    q = collections.deque([s])
+    while q:
+        u = q.popleft()
+        for v in out[u]:
+            if dist[v] is None:
+                dist[v] = dist[u] + 1
+                q.append(v)
+    return dist
+
+
+def build(n, instance_seed):
+    rnd = random.Random(instance_seed)
+    g = Graph()
+    nodes = [g.addNode() for _ in range(n)]
+    edges = []
+    for i in range(rnd.randint(n, 3 * n)):
+        u = rnd.randrange(n)
+        v = rnd.randrange(n)
+        edges.append((u, v, g.addEdge(nodes[u], nodes[v])))
+    preds = []
+    for i in range(rnd.randint(4, 16)):
+        u = rnd.randrange(n)
+        v = rnd.randrange(n)
+        kind = rnd.choice(["reaches", "reaches", "backward", "within"])
+        if kind == "reaches":
+            preds.append((kind, u, v, None, g.reaches(nodes[u], nodes[v])))
+        elif kind == "backward":
+            preds.append((kind, u, v, None, g.reachesBackward(nodes[u], nodes[v])))
+        else:
+            steps = rnd.randint(1, n - 1)
+            preds.append((kind, u, v, steps, g.reaches(nodes[u], nodes[v], steps)))
+    lits = [e for (u, v, e) in edges] + [p[4] for p in preds]
+    clauses = []
+    for i in range(rnd.randint(len(lits) // 2, 2 * len(lits))):
+        clause = [(rnd.randrange(len(lits)), rnd.random() < 0.5) for _ in range(rnd.randint(2, 3))]
+        clauses.append(clause)
+        AssertClause([lits[l] if positive else Not(lits[l]) for l, positive in clause])
+    return edges, preds, lits, clauses
+
+
+def check_model(n, edges, preds, lits, clauses):
+    for clause in clauses:
+        assert any(lits[l].value() == positive for l, positive in clause), "Model violates clause %s" % (str(clause))
+    enabled = {e: e.value() for (u, v, e) in edges}
+    for (kind, u, v, steps, p) in preds:
+        if kind == "backward":
+            # u reaches v backwards if v reaches u forwards
+            d = hops(n, edges, enabled, v)[u]
+        else:
+            d = hops(n, edges, enabled, u)[v]
+        holds = d is not None and (steps is None or d <= steps)
+        assert holds == p.value(), "Model violates %s %d %d %s" % (kind, u, v, steps)
+
+
+for arguments in ["-allpairs-frac=0 -allpairs=blocked-floyd-warshall -allpairs-threads=1",
+                  "-allpairs-frac=0 -allpairs=blocked-floyd-warshall -allpairs-threads=3"]:
+    for i in range(16):
+        instance_seed = random.randint(1, 1000000)
+        rnd = random.Random(instance_seed)
+        # the blocked algorithm uses tiles of 64 nodes, and only relaxes tile rows in parallel with at least 3 tiles
+        n = rnd.randint(4, 14) if i % 2 == 0 else rnd.randint(130, 260)
+        sequence = [[]]
+        for r in range(10):
+            sequence.append([(rnd.randrange(4 * n), rnd.random() < 0.5) for _ in range(rnd.randint(0, 2 * n))])
+
+        results = {}
+        for args in ["-allpairs-frac=1", arguments]:
+            Monosat().newSolver(args)
+            edges, preds, lits, clauses = build(n, instance_seed)
+            results[args] = []
+            for assumptions in sequence:
+                # at most one assumption per edge
+                assumed = dict((e % len(edges), positive) for e, positive in assumptions)
+                r = Solve([edges[e][2] if positive else Not(edges[e][2]) for e, positive in assumed.items()])
+                if r:
+                    check_model(n, edges, preds, lits, clauses)
+                results[args].append(r)
+        print("%s instance %d: %s" % (arguments, instance_seed, results[arguments]))
+        assert results[arguments] == results["-allpairs-frac=1"], \
+            "'%s' disagrees with the single-source detectors on instance seed %d" % (arguments, instance_seed)
+
+print("Done")
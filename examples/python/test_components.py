@@ -0,0 +1,118 @@
+from monosat import *
+import os
+import random
+import sys
+
+# Checks connected components constraints under the union-find algorithm (-components=disjoint-sets, which rolls back
+# its unions when edges are disabled), on random graphs small enough to solve by enumerating every edge assignment.
+# Components constraints are only available in the GNF format, so each instance is written to a GNF file and loaded
+# with loadConstraints. Each instance is solved repeatedly under random assumptions over its edges, so that unions are
+# rolled back and re-applied many times. Every model is checked against a direct count of the components of the edges
+# it enables, and every unsatisfiable result against the enumeration.
+
+seed = random.randint(1, 100000)
+if len(sys.argv) > 1:
+    seed = int(sys.argv[1])
+random.seed(seed)
+print("RandomSeed=" + str(seed))
+
+
+def components(n, edges, enabled):
+    parent = list(range(n))
+
+    def find(x):
+        while parent[x] != x:
+            x = parent[x]
+        return x
+
+    count = n
+    for (u, v, e) in edges:
+        if enabled[e]:
+            a = find(u)
+            b = find(v)
+            if a != b:
+                parent[a] = b
+                count -= 1
+    return count
+
+
+def build(n, instance_seed, filename):
+    # edge i is GNF variable i+1, and components constraint j is GNF variable len(edges)+j+1
+    rnd = random.Random(instance_seed)
+    edges = []
+    for i in range(rnd.randint(n, 2 * n)):
+        edges.append((rnd.randrange(n), rnd.randrange(n), i))
+    preds = []
+    for k in sorted(set(rnd.randint(1, n) for _ in range(rnd.randint(1, 4)))):
+        preds.append((k, len(edges) + len(preds)))
+    n_lits = len(edges) + len(preds)
+    clauses = []
+    for i in range(rnd.randint(n_lits // 2, 2 * n_lits)):
+        clauses.append([(rnd.randrange(n_lits), rnd.random() < 0.5) for _ in range(rnd.randint(2, 3))])
+    # the parser numbers the variables in the order they first appear, so the clauses are written last
+    with open(filename, "w") as f:
+        f.write("p cnf %d %d\n" % (n_lits, len(clauses)))
+        f.write("digraph %d %d 0\n" % (n, len(edges)))
+        for (u, v, e) in edges:
+            f.write("edge 0 %d %d %d\n" % (u, v, e + 1))
+        for (k, p) in preds:
+            # true iff the graph has more than k connected components
+            f.write("connected_component_count_lt 0 %d %d\n" % (k, p + 1))
+        for clause in clauses:
+            f.write(" ".join(str(l + 1 if positive else -(l + 1)) for l, positive in clause) + " 0\n")
+    return edges, preds, clauses
+
+
+def value(l):
+    return Monosat().getModel_Literal(2 * l) == 0
+
+
+def check_model(n, edges, preds, clauses):
+    for clause in clauses:
+        assert any(value(l) == positive for l, positive in clause), "Model violates clause %s" % (str(clause))
+    enabled = dict((e, value(e)) for (u, v, e) in edges)
+    count = components(n, edges, enabled)
+    for (k, p) in preds:
+        assert (count > k) == value(p), "Model violates components constraint %d (found %d components)" % (k, count)
+
+
+def satisfiable(n, edges, preds, clauses, assumed):
+    for bits in range(1 << len(edges)):
+        values = [(bits >> i) & 1 == 1 for i in range(len(edges))]
+        if any(values[e] != positive for e, positive in assumed.items()):
+            continue
+        enabled = dict((e, values[e]) for (u, v, e) in edges)
+        count = components(n, edges, enabled)
+        values += [count > k for (k, p) in preds]
+        if all(any(values[l] == positive for l, positive in clause) for clause in clauses):
+            return True
+    return False
+
+
+for i in range(40):
+    instance_seed = random.randint(1, 1000000)
+    rnd = random.Random(instance_seed)
+    n = rnd.randint(4, 6)
+    sequence = [[]]
+    for r in range(10):
+        sequence.append([(rnd.randrange(3 * n), rnd.random() < 0.5) for _ in range(rnd.randint(0, 2 * n))])
+
+    filename = "test_components_%d.gnf" % (instance_seed)
+    edges, preds, clauses = build(n, instance_seed, filename)
+    Monosat().newSolver("-components=disjoint-sets", define_true=False)
+    Monosat().loadConstraints(filename)
+    os.remove(filename)
+    results = []
+    for assumptions in sequence:
+        # at most one assumption per edge
+        assumed = dict((e % len(edges), positive) for e, positive in assumptions)
+        r = Monosat().solve([2 * e + (0 if positive else 1) for e, positive in assumed.items()])
+        if r:
+            check_model(n, edges, preds, clauses)
+        else:
+            assert not satisfiable(n, edges, preds, clauses, assumed), \
+                "-components=disjoint-sets wrongly found instance seed %d unsatisfiable" % (instance_seed)
+        results.append(r)
+    print("instance %d: %s" % (instance_seed, results))
+
+print("Done")
@@ -0,0 +1,116 @@
+from monosat import *
+import random
+import sys
+
+# Cube-and-conquer: generateCubes splits the search space into cubes, which are then either solved one at a time as
+# assumptions (with their outcomes recorded through setCubeStatus), or all together with solveCubes. Both must agree
+# with a plain solve of the same instance, and any model must satisfy the instance and one of the cubes.
+
+seed = random.randint(1, 100000)
+if len(sys.argv) > 1:
+    seed = int(sys.argv[1])
+random.seed(seed)
+print("RandomSeed=" + str(seed))
+
+
+def build(n_vars, n_clauses, instance_seed):
+    rnd = random.Random(instance_seed)
+    vars = [Var() for _ in range(n_vars)]
+    clauses = []
+    for _ in range(n_clauses):
+        clause = [(rnd.randrange(n_vars), rnd.random() < 0.5) for _ in range(3)]
+        clauses.append(clause)
+        AssertClause([vars[v] if positive else Not(vars[v]) for v, positive in clause])
+    # a small graph over the first few variables, so that the cubes also split theory atoms
+    g = Graph()
+    nodes = [g.addNode() for _ in range(6)]
+    edges = []
+    for i in range(12):
+        edges.append(g.addEdge(nodes[rnd.randrange(6)], nodes[rnd.randrange(6)]))
+        Assert(Equal(edges[-1], vars[i]))
+    Assert(g.reaches(nodes[0], nodes[5]))
+    return vars, clauses
+
+
+def check_model(vars, clauses):
+    for clause in clauses:
+        assert any(vars[v].value() == positive for v, positive in clause), "Model violates clause %s" % (str(clause))
+
+
+def model_satisfies_cube(cube):
+    # cube literals are external literals: 2*var+sign
+    return all(Monosat().getModel_Literal(l) == 0 for l in cube)
+
+
+for i in range(10):
+    instance_seed = random.randint(1, 1000000)
+    n_vars = random.choice([60, 80, 100])
+    n_clauses = int(n_vars * 4.26)
+    depth = random.randint(1, 4)
+
+    Monosat().newSolver()
+    vars, clauses = build(n_vars, n_clauses, instance_seed)
+    expect = Solve()
+
+    # solve each cube separately, recording the outcomes
+    Monosat().newSolver()
+    vars, clauses = build(n_vars, n_clauses, instance_seed)
+    n = Monosat().generateCubes(depth)
+    assert n == Monosat().nCubes()
+    assert n <= 2 ** depth
+    cubes = [Monosat().getCube(c) for c in range(n)]
+    for c in range(n):
+        assert Monosat().getCubeStatus(c) is None
+    any_sat = False
+    for c in range(n):
+        r = Monosat().solve(cubes[c])
+        if r:
+            check_model(vars, clauses)
+            assert model_satisfies_cube(cubes[c])
+            any_sat = True
+        Monosat().setCubeStatus(c, r)
+        assert Monosat().getCubeStatus(c) == r
+    print("instance %d, %d cubes: expected %s, found %s" % (instance_seed, n, expect, any_sat))
+    assert any_sat == expect, "Cubes disagree with a plain solve on instance seed %d" % (instance_seed)
+
+    # once every cube has a known status, solveCubes has nothing left to solve
+    if n > 0 and not any_sat:
+        assert Monosat().solveCubes(1) is False
+
+    # solve all the cubes with a portfolio of threads
+    Monosat().newSolver("-threads=2")
+    vars, clauses = build(n_vars, n_clauses, instance_seed)
+    n = Monosat().generateCubes(depth)
+    cubes = [Monosat().getCube(c) for c in range(n)]
+    r = Monosat().solveCubes(2)
+    assert r == expect, "solveCubes disagrees with a plain solve on instance seed %d" % (instance_seed)
+    if r:
+        check_model(vars, clauses)
+        assert any(model_satisfies_cube(cube) for cube in cubes)
+
+    # cubes generated under assumptions: if every cube is refuted, the conflict clause must still be implied by the
+    # instance, even though generating the cubes pruned some branches (failed literals) without solving them
+    assumption_vars = random.sample(range(n_vars), random.randint(1, 8))
+    Monosat().newSolver()
+    vars, clauses = build(n_vars, n_clauses, instance_seed)
+    assumptions = [(vars[v] if random.random() < 0.5 else Not(vars[v])).getLit() for v in assumption_vars]
+    expect = Monosat().solve(assumptions)
+
+    Monosat().newSolver("-threads=2")
+    vars, clauses = build(n_vars, n_clauses, instance_seed)
+    Monosat().generateCubes(depth, assumptions)
+    r = Monosat().solveCubes(2)
+    assert r == expect, "solveCubes under assumptions disagrees with a plain solve on instance seed %d" % (
+        instance_seed)
+    if r:
+        check_model(vars, clauses)
+    else:
+        conflict = Monosat().getConflictClause()
+        for l in conflict:
+            assert (l ^ 1) in assumptions, "Conflict literal %d does not negate an assumption" % (l)
+        Monosat().newSolver()
+        vars, clauses = build(n_vars, n_clauses, instance_seed)
+        assert Monosat().solve([l ^ 1 for l in conflict]) is False, \
+            "Conflict clause %s is not implied by instance seed %d" % (conflict, instance_seed)
+
+print("Done")
@@ -0,0 +1,93 @@
+from monosat import *
+import random
+import sys
+
+# Cross-checks the cycle detection algorithms for acyclic_directed constraints (-cycles=two-way, -cycles=dfs) against
+# the default (-cycles=pk). Each random instance is solved repeatedly under random assumptions over its edges, so that
+# the detectors see long sequences of edge insertions and deletions, and every model is checked directly for cycles.
+
+seed = random.randint(1, 100000)
+if len(sys.argv) > 1:
+    seed = int(sys.argv[1])
+random.seed(seed)
+print("RandomSeed=" + str(seed))
+
+
+def acyclic(n, edges, enabled):
+    out = [[] for _ in range(n)]
+    for (u, v, e) in edges:
+        if enabled[e]:
+            out[u].append(v)
+    color = [0] * n
+    for root in range(n):
+        if color[root]:
+            continue
+        stack = [(root, iter(out[root]))]
+        color[root] = 1
+        while stack:
+            u, it = stack[-1]
+            for v in it:
+                if color[v] == 1:
+                    return False
+                if color[v] == 0:
+                    color[v] = 1
+                    stack.append((v, iter(out[v])))
+                    break
+            else:
+                color[u] = 2
+                stack.pop()
+    return True
+
+
+def build(n, instance_seed):
+    rnd = random.Random(instance_seed)
+    g = Graph()
+    nodes = [g.addNode() for _ in range(n)]
+    edges = []
+    for i in range(rnd.randint(n, 4 * n)):
+        u = rnd.randrange(n)
+        v = rnd.randrange(n)
+        edges.append((u, v, g.addEdge(nodes[u], nodes[v])))
+    a = g.acyclic(True)
+    lits = [e for (u, v, e) in edges] + [a]
+    clauses = []
+    for i in range(rnd.randint(len(lits) // 4, len(lits))):
+        clause = [(rnd.randrange(len(lits)), rnd.random() < 0.5) for _ in range(rnd.randint(2, 3))]
+        clauses.append(clause)
+        AssertClause([lits[l] if positive else Not(lits[l]) for l, positive in clause])
+    return edges, a, lits, clauses
+
+
+def check_model(n, edges, a, lits, clauses):
+    for clause in clauses:
+        assert any(lits[l].value() == positive for l, positive in clause), "Model violates clause %s" % (str(clause))
+    enabled = {e: e.value() for (u, v, e) in edges}
+    assert acyclic(n, edges, enabled) == a.value(), "Model violates the acyclic constraint"
+
+
+for arguments in ["-cycles=two-way", "-cycles=dfs"]:
+    for i in range(60):
+        instance_seed = random.randint(1, 1000000)
+        rnd = random.Random(instance_seed)
+        n = rnd.randint(3, 30)
+        sequence = [[]]
+        for r in range(12):
+            sequence.append([(rnd.randrange(4 * n), rnd.random() < 0.5) for _ in range(rnd.randint(0, 3 * n))])
+
+        results = {}
+        for args in ["-cycles=pk", arguments]:
+            Monosat().newSolver(args)
+            edges, a, lits, clauses = build(n, instance_seed)
+            results[args] = []
+            for assumptions in sequence:
+                # at most one assumption per edge
+                assumed = dict((e % len(edges), positive) for e, positive in assumptions)
+                r = Solve([edges[e][2] if positive else Not(edges[e][2]) for e, positive in assumed.items()])
+                if r:
+                    check_model(n, edges, a, lits, clauses)
+                results[args].append(r)
+        print("%s instance %d: %s" % (arguments, instance_seed, results[arguments]))
+        assert results[arguments] == results["-cycles=pk"], \
+            "'%s' disagrees with -cycles=pk on instance seed %d" % (arguments, instance_seed)
+
+print("Done")
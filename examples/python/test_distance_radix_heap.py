@@ -0,0 +1,117 @@
+from monosat import *
+import heapq
+import random
+import sys
+
+# Cross-checks Dijkstra's algorithm with a radix heap (or, for unweighted distances, a bucket queue) against the
+# binary heap (-radix-heap vs -no-radix-heap), on random graphs with weighted shortest path constraints and bounded
+# (unweighted) reachability constraints. Each instance is solved repeatedly under random assumptions over its edges,
+# with new edges and constraints added between some of the solves, and every model is checked against a direct
+# evaluation of the constraints on the edges it enables.
+
+seed = random.randint(1, 100000)
+if len(sys.argv) > 1:
+    seed = int(sys.argv[1])
+random.seed(seed)
+print("RandomSeed=" + str(seed))
+
+
+def shortest(n, edges, enabled, s, unit):
+    out = [[] for _ in range(n)]
+    for (u, v, w, e) in edges:
+        if enabled[e]:
+            out[u].append((v, 1 if unit else w))
+    dist = [None] * n
+    q = [(0, s)]
+    while q:
+        d, u = heapq.heappop(q)
+        if dist[u] is not None:
+            continue
+        dist[u] = d
+        for (v, w) in out[u]:
+            if dist[v] is None:
+                heapq.heappush(q, (d + w, v))
+    return dist
+
+
+class Instance:
+    def __init__(self, n, instance_seed):
+        self.rnd = random.Random(instance_seed)
+        self.n = n
+        self.g = Graph()
+        self.nodes = [self.g.addNode() for _ in range(n)]
+        self.edges = []
+        self.preds = []
+        self.clauses = []
+        self.lits = []
+        self.extend(self.rnd.randint(n, 3 * n), self.rnd.randint(4, 12))
+
+    def extend(self, n_edges, n_preds):
+        rnd = self.rnd
+        n = self.n
+        for i in range(n_edges):
+            u = rnd.randrange(n)
+            v = rnd.randrange(n)
+            w = rnd.randint(1, 5)
+            e = self.g.addEdge(self.nodes[u], self.nodes[v], w)
+            self.edges.append((u, v, w, e))
+            self.lits.append(e)
+        for i in range(n_preds):
+            u = rnd.randrange(n)
+            v = rnd.randrange(n)
+            if rnd.random() < 0.5:
+                d = rnd.randint(1, 4 * n)
+                p = self.g.distance_leq(self.nodes[u], self.nodes[v], d)
+                self.preds.append((False, u, v, d, p))
+            else:
+                d = rnd.randint(1, n - 1)
+                p = self.g.reaches(self.nodes[u], self.nodes[v], d)
+                self.preds.append((True, u, v, d, p))
+            self.lits.append(p)
+        for i in range(rnd.randint((n_edges + n_preds) // 2, 2 * (n_edges + n_preds))):
+            clause = [(rnd.randrange(len(self.lits)), rnd.random() < 0.5) for _ in range(rnd.randint(2, 3))]
+            self.clauses.append(clause)
+            AssertClause([self.lits[l] if positive else Not(self.lits[l]) for l, positive in clause])
+
+    def check_model(self):
+        for clause in self.clauses:
+            assert any(self.lits[l].value() == positive for l, positive in clause), "Model violates clause %s" % (
+                str(clause))
+        enabled = {e: e.value() for (u, v, w, e) in self.edges}
+        for (unit, u, v, d, p) in self.preds:
+            dist = shortest(self.n, self.edges, enabled, u, unit)[v]
+            holds = dist is not None and dist <= d
+            assert holds == p.value(), "Model violates distance constraint %d %d %d (unit=%s)" % (u, v, d, unit)
+
+
+for arguments in ["-dist=dijkstra -radix-heap"]:
+    for i in range(50):
+        instance_seed = random.randint(1, 1000000)
+        rnd = random.Random(instance_seed)
+        n = rnd.randint(4, 16)
+        sequence = [([], 0, 0)]
+        for r in range(10):
+            assumptions = [(rnd.randrange(6 * n), rnd.random() < 0.5) for _ in range(rnd.randint(0, 2 * n))]
+            grow = (rnd.randint(1, n), rnd.randint(0, 3)) if rnd.random() < 0.4 else (0, 0)
+            sequence.append((assumptions, grow[0], grow[1]))
+
+        results = {}
+        for args in ["-dist=dijkstra -no-radix-heap", arguments]:
+            Monosat().newSolver(args)
+            instance = Instance(n, instance_seed)
+            results[args] = []
+            for (assumptions, n_edges, n_preds) in sequence:
+                if n_edges > 0:
+                    instance.extend(n_edges, n_preds)
+                edges = instance.edges
+                # at most one assumption per edge
+                assumed = dict((e % len(edges), positive) for e, positive in assumptions)
+                r = Solve([edges[e][3] if positive else Not(edges[e][3]) for e, positive in assumed.items()])
+                if r:
+                    instance.check_model()
+                results[args].append(r)
+        print("%s instance %d: %s" % (arguments, instance_seed, results[arguments]))
+        assert results[arguments] == results["-dist=dijkstra -no-radix-heap"], \
+            "'%s' disagrees with -dist=dijkstra -no-radix-heap on instance seed %d" % (arguments, instance_seed)
+
+print("Done")
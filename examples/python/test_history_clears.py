@@ -0,0 +1,163 @@
+from monosat import *
+import collections
+import random
+import sys
+
+# Cross-checks frequent history clears of the dynamic graphs (-history-clear=N, which only discards the changes that
+# every dynamic graph algorithm has already read) against never clearing the history (-disable-history-clear), on
+# random graphs that mix reachability, shortest path, maximum flow and acyclicity constraints, so that algorithms that
+# read the history at different rates share each graph. Each instance is solved repeatedly under random assumptions
+# over its edges, and every model is checked against a direct evaluation of the constraints.
+
+seed = random.randint(1, 100000)
+if len(sys.argv) > 1:
+    seed = int(sys.argv[1])
+random.seed(seed)
+print("RandomSeed=" + str(seed))
+
+
+def hops(n, edges, enabled, s):
+    out = [[] for _ in range(n)]
+    for (u, v, c, e) in edges:
+        if enabled[e]:
+            out[u].append(v)
+    dist = [None] * n
+    dist[s] = 0
+    q = collections.deque([s])
+    while q:
+        u = q.popleft()
+        for v in out[u]:
+            if dist[v] is None:
+                dist[v] = dist[u] + 1
+                q.append(v)
+    return dist
+
+
+def maxflow(n, edges, enabled, s, t):
+    cap = collections.defaultdict(int)
+    out = [set() for _ in range(n)]
+    for (u, v, c, e) in edges:
+        if enabled[e] and u != v:
+            cap[(u, v)] += c
+            out[u].add(v)
+            out[v].add(u)
+    flow = 0
+    while True:
+        prev = {s: None}
+        q = collections.deque([s])
+        while q and t not in prev:
+            u = q.popleft()
+            for v in out[u]:
+                if v not in prev and cap[(u, v)] > 0:
+                    prev[v] = u
+                    q.append(v)
+        if t not in prev:
+            return flow
+        f = None
+        v = t
+        while prev[v] is not None:
+            f = cap[(prev[v], v)] if f is None else min(f, cap[(prev[v], v)])
+            v = prev[v]
+        v = t
+        while prev[v] is not None:
+            cap[(prev[v], v)] -= f
+            cap[(v, prev[v])] += f
+            v = prev[v]
+        flow += f
+
+
+def acyclic(n, edges, enabled):
+    indegree = [0] * n
+    out = [[] for _ in range(n)]
+    for (u, v, c, e) in edges:
+        if enabled[e]:
+            out[u].append(v)
+            indegree[v] += 1
+    ready = [u for u in range(n) if indegree[u] == 0]
+    seen = 0
+    while ready:
+        u = ready.pop()
+        seen += 1
+        for v in out[u]:
+            indegree[v] -= 1
+            if indegree[v] == 0:
+                ready.append(v)
+    return seen == n
+
+
+def build(n, instance_seed):
+    rnd = random.Random(instance_seed)
+    g = Graph()
+    nodes = [g.addNode() for _ in range(n)]
+    edges = []
+    for i in range(rnd.randint(n, 3 * n)):
+        u = rnd.randrange(n)
+        v = rnd.randrange(n)
+        c = rnd.randint(1, 4)
+        edges.append((u, v, c, g.addEdge(nodes[u], nodes[v], c)))
+    preds = []
+    for i in range(rnd.randint(4, 12)):
+        u = rnd.randrange(n)
+        v = (u + rnd.randrange(1, n)) % n
+        kind = rnd.choice(["reaches", "steps", "maxflow"])
+        if kind == "reaches":
+            preds.append((kind, u, v, None, g.reaches(nodes[u], nodes[v])))
+        elif kind == "steps":
+            steps = rnd.randint(1, n - 1)
+            preds.append((kind, u, v, steps, g.reaches(nodes[u], nodes[v], steps)))
+        else:
+            f = rnd.randint(1, 6)
+            preds.append((kind, u, v, f, g.maxFlowGreaterOrEqualTo(nodes[u], nodes[v], f)))
+    preds.append(("acyclic", None, None, None, g.acyclic(True)))
+    lits = [e for (u, v, c, e) in edges] + [p[4] for p in preds]
+    clauses = []
+    for i in range(rnd.randint(len(lits) // 2, 2 * len(lits))):
+        clause = [(rnd.randrange(len(lits)), rnd.random() < 0.5) for _ in range(rnd.randint(2, 3))]
+        clauses.append(clause)
+        AssertClause([lits[l] if positive else Not(lits[l]) for l, positive in clause])
+    return edges, preds, lits, clauses
+
+
+def check_model(n, edges, preds, lits, clauses):
+    for clause in clauses:
+        assert any(lits[l].value() == positive for l, positive in clause), "Model violates clause %s" % (str(clause))
+    enabled = {e: e.value() for (u, v, c, e) in edges}
+    for (kind, u, v, bound, p) in preds:
+        if kind == "reaches":
+            holds = hops(n, edges, enabled, u)[v] is not None
+        elif kind == "steps":
+            d = hops(n, edges, enabled, u)[v]
+            holds = d is not None and d <= bound
+        elif kind == "maxflow":
+            holds = maxflow(n, edges, enabled, u, v) >= bound
+        else:
+            holds = acyclic(n, edges, enabled)
+        assert holds == p.value(), "Model violates %s constraint %s %s %s" % (kind, u, v, bound)
+
+
+for arguments in ["-history-clear=2", "-history-clear=2 -dynamic-history-clear=2"]:
+    for i in range(30):
+        instance_seed = random.randint(1, 1000000)
+        rnd = random.Random(instance_seed)
+        n = rnd.randint(4, 14)
+        sequence = [[]]
+        for r in range(10):
+            sequence.append([(rnd.randrange(3 * n), rnd.random() < 0.5) for _ in range(rnd.randint(0, 2 * n))])
+
+        results = {}
+        for args in ["-disable-history-clear", arguments]:
+            Monosat().newSolver(args)
+            edges, preds, lits, clauses = build(n, instance_seed)
+            results[args] = []
+            for assumptions in sequence:
+                # at most one assumption per edge
+                assumed = dict((e % len(edges), positive) for e, positive in assumptions)
+                r = Solve([edges[e][3] if positive else Not(edges[e][3]) for e, positive in assumed.items()])
+                if r:
+                    check_model(n, edges, preds, lits, clauses)
+                results[args].append(r)
+        print("%s instance %d: %s" % (arguments, instance_seed, results[arguments]))
+        assert results[arguments] == results["-disable-history-clear"], \
+            "'%s' disagrees with -disable-history-clear on instance seed %d" % (arguments, instance_seed)
+
+print("Done")
@@ -0,0 +1,109 @@
+from monosat import *
+import collections
+import random
+import sys
+
+# Cross-checks the highest-label push-relabel maximum flow algorithm (-maxflow=push-relabel) against Edmonds-Karp
+# (-maxflow=edmondskarp-adj), on random graphs with several maximum flow constraints over the same source. Each instance
+# is solved repeatedly under random assumptions over its edges, and every model is checked against a direct
+# computation of the maximum flows.
+
+seed = random.randint(1, 100000)
+if len(sys.argv) > 1:
+    seed = int(sys.argv[1])
+random.seed(seed)
+print("RandomSeed=" + str(seed))
+
+
+def maxflow(n, edges, enabled, s, t):
+    cap = collections.defaultdict(int)
+    out = [set() for _ in range(n)]
+    for (u, v, c, e) in edges:
+        if enabled[e] and u != v:
+            cap[(u, v)] += c
+            out[u].add(v)
+            out[v].add(u)
+    flow = 0
+    while True:
+        prev = {s: None}
+        q = collections.deque([s])
+        while q and t not in prev:
+            u = q.popleft()
+            for v in out[u]:
+                if v not in prev and cap[(u, v)] > 0:
+                    prev[v] = u
+                    q.append(v)
+        if t not in prev:
+            return flow
+        f = None
+        v = t
+        while prev[v] is not None:
+            f = cap[(prev[v], v)] if f is None else min(f, cap[(prev[v], v)])
+            v = prev[v]
+        v = t
+        while prev[v] is not None:
+            cap[(prev[v], v)] -= f
+            cap[(v, prev[v])] += f
+            v = prev[v]
+        flow += f
+
+
+def build(n, instance_seed):
+    rnd = random.Random(instance_seed)
+    g = Graph()
+    nodes = [g.addNode() for _ in range(n)]
+    edges = []
+    for i in range(rnd.randint(n, 3 * n)):
+        u = rnd.randrange(n)
+        v = rnd.randrange(n)
+        c = rnd.randint(1, 8)
+        edges.append((u, v, c, g.addEdge(nodes[u], nodes[v], c)))
+    s = rnd.randrange(n)
+    preds = []
+    for i in range(rnd.randint(2, 8)):
+        t = (s + rnd.randrange(1, n)) % n
+        f = rnd.randint(1, 16)
+        preds.append((s, t, f, g.maxFlowGreaterOrEqualTo(nodes[s], nodes[t], f)))
+    lits = [e for (u, v, c, e) in edges] + [p[3] for p in preds]
+    clauses = []
+    for i in range(rnd.randint(len(lits) // 2, 2 * len(lits))):
+        clause = [(rnd.randrange(len(lits)), rnd.random() < 0.5) for _ in range(rnd.randint(2, 3))]
+        clauses.append(clause)
+        AssertClause([lits[l] if positive else Not(lits[l]) for l, positive in clause])
+    return edges, preds, lits, clauses
+
+
+def check_model(n, edges, preds, lits, clauses):
+    for clause in clauses:
+        assert any(lits[l].value() == positive for l, positive in clause), "Model violates clause %s" % (str(clause))
+    enabled = {e: e.value() for (u, v, c, e) in edges}
+    for (s, t, f, p) in preds:
+        flow = maxflow(n, edges, enabled, s, t)
+        assert (flow >= f) == p.value(), "Model violates maxflow constraint %d %d %d" % (s, t, f)
+
+
+for i in range(40):
+    instance_seed = random.randint(1, 1000000)
+    rnd = random.Random(instance_seed)
+    n = rnd.randint(4, 16)
+    sequence = [[]]
+    for r in range(10):
+        sequence.append([(rnd.randrange(3 * n), rnd.random() < 0.5) for _ in range(rnd.randint(0, 2 * n))])
+
+    results = {}
+    for args in ["-maxflow=edmondskarp-adj", "-maxflow=push-relabel"]:
+        Monosat().newSolver(args)
+        edges, preds, lits, clauses = build(n, instance_seed)
+        results[args] = []
+        for assumptions in sequence:
+            # at most one assumption per edge
+            assumed = dict((e % len(edges), positive) for e, positive in assumptions)
+            r = Solve([edges[e][3] if positive else Not(edges[e][3]) for e, positive in assumed.items()])
+            if r:
+                check_model(n, edges, preds, lits, clauses)
+            results[args].append(r)
+    print("instance %d: %s" % (instance_seed, results["-maxflow=push-relabel"]))
+    assert results["-maxflow=push-relabel"] == results["-maxflow=edmondskarp-adj"], \
+        "-maxflow=push-relabel disagrees with -maxflow=edmondskarp-adj on instance seed %d" % (instance_seed)
+
+print("Done")
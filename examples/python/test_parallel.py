@@ -0,0 +1,89 @@
+from monosat import *
+import random
+import sys
+
+# Cross-checks solveParallel (a portfolio of copies of the solver, sharing learnt clauses) against single-threaded
+# solving. The bitvector and pseudo-boolean constraints below create internal variables that have no external
+# mapping, and the FSM constraint creates several more, so the internal variable numbering of the primary solver
+# and of each copy differ from the external numbering (and from each other); learnt clauses, models and conflicts
+# are only correctly exchanged between the threads if they are translated through the external numbering.
+
+seed = random.randint(1, 100000)
+if len(sys.argv) > 1:
+    seed = int(sys.argv[1])
+random.seed(seed)
+print("RandomSeed=" + str(seed))
+
+
+def build(n_vars, n_clauses, instance_seed):
+    rnd = random.Random(instance_seed)
+    bv = BitVector(4)
+    Assert(bv > 3)
+    vars = []
+    clauses = []
+    for i in range(n_vars):
+        vars.append(Var())
+        if i % 16 == 0:
+            # interleave more internal-only variables with the external ones
+            AssertAtMostOne([Var() for _ in range(5)])
+            Assert(bv != (i % 16))
+    for _ in range(n_clauses):
+        clause = [(rnd.randrange(n_vars), rnd.random() < 0.5) for _ in range(3)]
+        clauses.append(clause)
+        AssertClause([vars[v] if positive else Not(vars[v]) for v, positive in clause])
+
+    # An FSM that accepts the string '1 1' only if both of its transitions are enabled; both transitions are tied
+    # to variables of the random instance, so that copies which failed to replay the FSM would find wrong models.
+    m = Monosat()
+    fsm = m.monosat_c.newFSM(m.solver._ptr, None, 2, 0)
+    s0 = m.monosat_c.newState(m.solver._ptr, None, fsm)
+    s1 = m.monosat_c.newState(m.solver._ptr, None, fsm)
+    s2 = m.monosat_c.newState(m.solver._ptr, None, fsm)
+    t0 = Var(m.monosat_c.newTransition(m.solver._ptr, None, fsm, s0, s1, 1, 0))
+    t1 = Var(m.monosat_c.newTransition(m.solver._ptr, None, fsm, s1, s2, 1, 0))
+    string = m.getIntArray([1, 1])
+    str_id = m.monosat_c.newString(m.solver._ptr, None, string, 2)
+    accepts = Var(m.monosat_c.fsmAcceptsString(m.solver._ptr, None, fsm, s0, s2, str_id))
+    Assert(accepts)
+    Assert(Equal(t0, vars[0]))
+    Assert(Equal(t1, Not(vars[1])))
+    return vars, clauses, t0, t1
+
+
+def check_model(vars, clauses, t0, t1):
+    for clause in clauses:
+        assert any(vars[v].value() == positive for v, positive in clause), "Model violates clause %s" % (str(clause))
+    assert t0.value() and t1.value(), "Model violates the FSM constraint"
+
+
+for arguments in ["-threads=4", "-threads=3 -share-size=30"]:
+    for i in range(8):
+        instance_seed = random.randint(1, 1000000)
+        n_vars = random.choice([150, 200, 250])
+        n_clauses = int(n_vars * 4.26)
+
+        Monosat().newSolver()
+        vars, clauses, t0, t1 = build(n_vars, n_clauses, instance_seed)
+        expect = Solve()
+
+        Monosat().newSolver(arguments)
+        vars, clauses, t0, t1 = build(n_vars, n_clauses, instance_seed)
+        result = Monosat().solveParallel(4)
+        print("%s instance %d: expected %s, found %s" % (arguments, instance_seed, expect, result))
+        assert result == expect, "Parallel solve disagrees with single-threaded solve on instance seed %d" % (
+            instance_seed)
+        if result:
+            check_model(vars, clauses, t0, t1)
+
+        # solve again under assumptions, after adding constraints, to exercise replaying only the new constraints
+        extra = Var()
+        AssertClause([extra, vars[2], Not(vars[3])])
+        result2 = Monosat().solveParallel(4, [Not(extra).getLit(), Not(vars[2]).getLit()])
+        Monosat().newSolver()
+        vars, clauses, t0, t1 = build(n_vars, n_clauses, instance_seed)
+        extra = Var()
+        AssertClause([extra, vars[2], Not(vars[3])])
+        expect2 = Solve([Not(extra), Not(vars[2])])
+        assert result2 == expect2, "Parallel solve under assumptions disagrees on instance seed %d" % (instance_seed)
+
+print("Done")
@@ -0,0 +1,46 @@
+from monosat import *
+
+# getProfile reports, for each theory solver, how often it was called, how many literals it propagated, how many
+# conflicts it found, and (sampled) timings, broken down into parts for each detector.
+
+g = Graph()
+nodes = [g.addNode() for _ in range(6)]
+edges = []
+for i in range(5):
+    edges.append(g.addEdge(nodes[i], nodes[i + 1], 1))
+    edges.append(g.addEdge(nodes[i], nodes[(i + 2) % 6], 1))
+Assert(g.reaches(nodes[0], nodes[5]))
+Assert(Not(g.distance_leq(nodes[0], nodes[5], 2)))
+
+bv = BitVector(4)
+Assert(bv > 5)
+Assert(Implies(edges[0], bv < 7))
+Assert(Implies(edges[1], bv == 9))
+
+result = Solve()
+assert result
+
+profile = Monosat().getProfile()
+print(profile)
+assert "sample" in profile
+theories = profile["theories"]
+types = [t["type"] for t in theories]
+assert "Graph" in types, types
+assert "BV" in types, types
+for t in theories:
+    for key in ["id", "name", "calls", "propagations", "conflicts", "time", "reasons", "reason_time", "parts"]:
+        assert key in t, "Missing %s in the profile of %s" % (key, t["type"])
+    assert t["calls"] >= 0 and t["propagations"] >= 0 and t["conflicts"] >= 0
+    for part in t["parts"]:
+        assert "name" in part and "calls" in part
+
+graph = theories[types.index("Graph")]
+assert graph["calls"] > 0
+assert len(graph["parts"]) > 0
+
+# the counts only grow as the solver is used again
+Solve([Not(edges[0])])
+graph2 = Monosat().getProfile()["theories"][types.index("Graph")]
+assert graph2["calls"] >= graph["calls"]
+assert graph2["propagations"] >= graph["propagations"]
+print("Done")
@@ -0,0 +1,97 @@
+from monosat import *
+import collections
+import random
+import sys
+
+# Cross-checks breadth-first search reachability (-reach=bfs), with and without early termination of its traversals
+# once every active target is settled (-reach-early-termination), against the default reachability engine, on random
+# graphs with forward and backward reachability constraints. Each instance is solved repeatedly under random
+# assumptions over its edges, and every model is checked against a direct evaluation of the constraints.
+
+seed = random.randint(1, 100000)
+if len(sys.argv) > 1:
+    seed = int(sys.argv[1])
+random.seed(seed)
+print("RandomSeed=" + str(seed))
+
+
+def reachable(n, edges, enabled, s):
+    out = [[] for _ in range(n)]
+    for (u, v, e) in edges:
+        if enabled[e]:
+            out[u].append(v)
+    seen = [False] * n
+    seen[s] = True
+    q = collections.deque([s])
+    while q:
+        u = q.popleft()
+        for v in out[u]:
+            if not seen[v]:
+                seen[v] = True
+                q.append(v)
+    return seen
+
+
+def build(n, instance_seed):
+    rnd = random.Random(instance_seed)
+    g = Graph()
+    nodes = [g.addNode() for _ in range(n)]
+    edges = []
+    for i in range(rnd.randint(n, 3 * n)):
+        u = rnd.randrange(n)
+        v = rnd.randrange(n)
+        edges.append((u, v, g.addEdge(nodes[u], nodes[v])))
+    sources = [rnd.randrange(n) for _ in range(rnd.randint(1, 4))]
+    preds = []
+    for i in range(rnd.randint(4, 16)):
+        u = rnd.choice(sources)
+        v = rnd.randrange(n)
+        if rnd.random() < 0.7:
+            preds.append((False, u, v, g.reaches(nodes[u], nodes[v])))
+        else:
+            preds.append((True, u, v, g.reachesBackward(nodes[u], nodes[v])))
+    lits = [e for (u, v, e) in edges] + [p[3] for p in preds]
+    clauses = []
+    for i in range(rnd.randint(len(lits) // 2, 2 * len(lits))):
+        clause = [(rnd.randrange(len(lits)), rnd.random() < 0.5) for _ in range(rnd.randint(2, 3))]
+        clauses.append(clause)
+        AssertClause([lits[l] if positive else Not(lits[l]) for l, positive in clause])
+    return edges, preds, lits, clauses
+
+
+def check_model(n, edges, preds, lits, clauses):
+    for clause in clauses:
+        assert any(lits[l].value() == positive for l, positive in clause), "Model violates clause %s" % (str(clause))
+    enabled = {e: e.value() for (u, v, e) in edges}
+    for (backward, u, v, p) in preds:
+        # u reaches v backwards if v reaches u forwards
+        holds = reachable(n, edges, enabled, v)[u] if backward else reachable(n, edges, enabled, u)[v]
+        assert holds == p.value(), "Model violates reach constraint %d %d (backward=%s)" % (u, v, backward)
+
+
+for arguments in ["-reach=bfs -reach-early-termination", "-reach=bfs -no-reach-early-termination"]:
+    for i in range(30):
+        instance_seed = random.randint(1, 1000000)
+        rnd = random.Random(instance_seed)
+        n = rnd.randint(4, 24)
+        sequence = [[]]
+        for r in range(10):
+            sequence.append([(rnd.randrange(4 * n), rnd.random() < 0.5) for _ in range(rnd.randint(0, 2 * n))])
+
+        results = {}
+        for args in ["-reach=ramal-reps", arguments]:
+            Monosat().newSolver(args)
+            edges, preds, lits, clauses = build(n, instance_seed)
+            results[args] = []
+            for assumptions in sequence:
+                # at most one assumption per edge
+                assumed = dict((e % len(edges), positive) for e, positive in assumptions)
+                r = Solve([edges[e][2] if positive else Not(edges[e][2]) for e, positive in assumed.items()])
+                if r:
+                    check_model(n, edges, preds, lits, clauses)
+                results[args].append(r)
+        print("%s instance %d: %s" % (arguments, instance_seed, results[arguments]))
+        assert results[arguments] == results["-reach=ramal-reps"], \
+            "'%s' disagrees with -reach=ramal-reps on instance seed %d" % (arguments, instance_seed)
+
+print("Done")
@@ -0,0 +1,81 @@
+from monosat import *
+import os
+import random
+import sys
+import tempfile
+
+# Solver state snapshots: a solver that is rebuilt from the same constraints and then warm-started from a state
+# saved by another solver must still find the same result (and a valid model) as a solver that starts cold.
+
+seed = random.randint(1, 100000)
+if len(sys.argv) > 1:
+    seed = int(sys.argv[1])
+random.seed(seed)
+print("RandomSeed=" + str(seed))
+
+
+def build(n_vars, n_clauses, instance_seed):
+    rnd = random.Random(instance_seed)
+    vars = [Var() for _ in range(n_vars)]
+    clauses = []
+    for _ in range(n_clauses):
+        clause = [(rnd.randrange(n_vars), rnd.random() < 0.5) for _ in range(3)]
+        clauses.append(clause)
+        AssertClause([vars[v] if positive else Not(vars[v]) for v, positive in clause])
+    g = Graph()
+    nodes = [g.addNode() for _ in range(8)]
+    for i in range(16):
+        Assert(Equal(g.addEdge(nodes[rnd.randrange(8)], nodes[rnd.randrange(8)]), vars[i]))
+    Assert(g.reaches(nodes[0], nodes[7]))
+    bv = BitVector(4)
+    Assert(bv > 2)
+    Assert(Equal(bv == 5, vars[16]))
+    return vars, clauses
+
+
+def check_model(vars, clauses):
+    for clause in clauses:
+        assert any(vars[v].value() == positive for v, positive in clause), "Model violates clause %s" % (str(clause))
+
+
+fd, filename = tempfile.mkstemp(suffix=".state")
+os.close(fd)
+try:
+    for i in range(10):
+        instance_seed = random.randint(1, 1000000)
+        n_vars = random.choice([100, 150, 200])
+        n_clauses = int(n_vars * 4.26)
+
+        Monosat().newSolver()
+        vars, clauses = build(n_vars, n_clauses, instance_seed)
+        expect = Solve()
+        # save after a second solve under assumptions, so that the state includes learnt clauses and activities
+        # from more than one search
+        Solve([vars[0], Not(vars[1])])
+        Monosat().saveSolverState(filename)
+
+        Monosat().newSolver()
+        vars, clauses = build(n_vars, n_clauses, instance_seed)
+        loaded = Monosat().loadSolverState(filename)
+        # loading may only report UNSAT for instances that really are UNSAT
+        assert loaded or not expect, "Loading the state of a satisfiable instance found it UNSAT, instance seed %d" % (
+            instance_seed)
+        result = Solve()
+        print("instance %d: expected %s, found %s" % (instance_seed, expect, result))
+        assert result == expect, "Warm-started solve disagrees with a cold solve on instance seed %d" % (
+            instance_seed)
+        if result:
+            check_model(vars, clauses)
+        # the loaded state must not have fixed any of the assumptions of the earlier solve
+        Monosat().newSolver()
+        vars, clauses = build(n_vars, n_clauses, instance_seed)
+        expect2 = Solve([Not(vars[0]), vars[1]])
+        Monosat().newSolver()
+        vars, clauses = build(n_vars, n_clauses, instance_seed)
+        Monosat().loadSolverState(filename)
+        assert Solve([Not(vars[0]), vars[1]]) == expect2, "Warm-started solve under assumptions disagrees on " \
+                                                          "instance seed %d" % (instance_seed)
+finally:
+    os.remove(filename)
+
+print("Done")
@@ -52,6 +52,8 @@
 #include "amo/AMOTheory.h"
 #include "amo/AMOParser.h"
 #include "core/Optimize.h"
+#include "core/Portfolio.h"
+#include "core/CubeAndConquer.h"
 #include "core/Config.h"
 #include "pb/Config_pb.h"
 #include "monosat/Version.h"
@@ -100,6 +102,66 @@ static void SIGINT_exit(int signum){
     _exit(1);
 }
 
+//An additional copy of the instance, parsed independently from the same input file, for use as one thread of a
+//parallel portfolio (see -threads).
+struct PortfolioCopy {
+    SimpSolver S;
+    Dimacs<StreamBuffer, SimpSolver> parser;
+    BVParser<char*, SimpSolver> bvParser;
+    SymbolParser<char*, SimpSolver> symbolParser;
+    GraphParser<char*, SimpSolver> graphParser;
+    FlowRouterParser<char*, SimpSolver> flowRouterParser;
+    PBParser<char*, SimpSolver> pbParser;
+    FSMParser<char*, SimpSolver> fsmParser;
+    AMOParser<char*, SimpSolver> amo;
+
+    PortfolioCopy(SimpSolver& primary) : graphParser(true, bvParser.theory), flowRouterParser(&graphParser),
+                                         pbParser(S){
+        S.min_decision_var = primary.min_decision_var;
+        S.max_decision_var = primary.max_decision_var;
+        S.min_priority_var = primary.min_priority_var;
+        S.max_priority_var = primary.max_priority_var;
+        S.setPBSolver(new PB::PbSolver(S));
+        if(!opt_pre)
+            S.eliminate(true);
+        parser.addParser(&bvParser);
+        parser.addParser(&symbolParser);
+        parser.addParser(&graphParser);
+        parser.addParser(&flowRouterParser);
+        parser.addParser(&pbParser);
+        parser.addParser(&fsmParser);
+        parser.addParser(&amo);
+    }
+
+    //Parse and preprocess the instance. Solve statements embedded in the file are not executed; the assumptions
+    //of the final solve statement (if any) are left in parser.assumptions.
+    void parse(const char* filename, bool ignore_solve_statements){
+        gzFile in = gzopen(filename, "rb");
+        if(in == NULL)
+            printf("ERROR! Could not open file: %s\n", filename), exit(1);
+        StreamBuffer strm(in);
+        if(opt_parser_immediate_mode){
+            new Monosat::BVTheorySolver<int64_t>(&S);
+        }
+        while(S.okay() && parser.parse(strm, S)){
+            if(*strm == EOF){
+                break;
+            }
+        }
+        gzclose(in);
+        if(ignore_solve_statements){
+            parser.assumptions.clear();
+        }
+        S.preprocess();
+        if(opt_pre){
+            for(Lit l:parser.assumptions){
+                S.setFrozen(var(l), true);
+            }
+            S.eliminate(true);
+        }
+    }
+};
+
 //Select which algorithms to apply for graph solvers, by parsing command line arguments and defaults.
 void selectAlgorithms(){
     mincutalg = MinCutAlg::ALG_EDMONSKARP;
@@ -124,6 +186,11 @@ void selectAlgorithms(){
         mincutalg = MinCutAlg::ALG_DINITZ;
     }else if(!strcasecmp(opt_maxflow_alg, "dinits-linkcut")){
         mincutalg = MinCutAlg::ALG_DINITZ_LINKCUT;
+    }else if(!strcasecmp(opt_maxflow_alg, "dinitz-dynamic") || !strcasecmp(opt_maxflow_alg, "dinics-dynamic")
+             || !strcasecmp(opt_maxflow_alg, "dinits-dynamic")){
+        mincutalg = MinCutAlg::ALG_DINITZ_DYN;
+    }else if(!strcasecmp(opt_maxflow_alg, "push-relabel")){
+        mincutalg = MinCutAlg::ALG_PUSH_RELABEL;
     }else if(!strcasecmp(opt_maxflow_alg, "kohli-torr")){
         mincutalg = MinCutAlg::ALG_KOHLI_TORR;
     }else{
@@ -148,6 +215,8 @@ void selectAlgorithms(){
         cyclealg = CycleAlg::ALG_DFS_CYCLE;
     }else if(!strcasecmp(opt_cycle_alg, "pk")){
         cyclealg = CycleAlg::ALG_PK_CYCLE;
+    }else if(!strcasecmp(opt_cycle_alg, "two-way")){
+        cyclealg = CycleAlg::ALG_TWOWAY_CYCLE;
     }else{
         fprintf(stderr, "Error: unknown cycle detection algorithm %s, aborting\n",
                 ((string) opt_cycle_alg).c_str());
@@ -187,6 +256,10 @@ void selectAlgorithms(){
         reachalg = ReachAlg::ALG_RAMAL_REPS_BATCHED;
     }else if(!strcasecmp(opt_reach_alg, "ramal-reps-batch2")){
         reachalg = ReachAlg::ALG_RAMAL_REPS_BATCHED2;
+    }else if(!strcasecmp(opt_reach_alg, "bfs-multi")){
+        reachalg = ReachAlg::ALG_BFS_MULTI_SOURCE;
+    }else if(!strcasecmp(opt_reach_alg, "bfs-do")){
+        reachalg = ReachAlg::ALG_BFS_DO;
     }else{
         fprintf(stderr, "Error: unknown reachability algorithm %s, aborting\n", ((string) opt_reach_alg).c_str());
         exit(1);
@@ -208,6 +281,8 @@ void selectAlgorithms(){
         distalg = DistAlg::ALG_RAMAL_REPS_BATCHED;
     }else if(!strcasecmp(opt_dist_alg, "ramal-reps-batch2")){
         distalg = DistAlg::ALG_RAMAL_REPS_BATCHED2;
+    }else if(!strcasecmp(opt_dist_alg, "bidirectional")){
+        distalg = DistAlg::ALG_BIDIRECTIONAL;
     }else{
         fprintf(stderr, "Error: unknown distance algorithm %s, aborting\n", ((string) opt_dist_alg).c_str());
         exit(1);
@@ -239,8 +314,12 @@ void selectAlgorithms(){
 
     if(!strcasecmp(opt_allpairs_alg, "floyd-warshall")){
         allpairsalg = AllPairsAlg::ALG_FLOYDWARSHALL;
+    }else if(!strcasecmp(opt_allpairs_alg, "blocked-floyd-warshall")){
+        allpairsalg = AllPairsAlg::ALG_BLOCKED_FLOYDWARSHALL;
     }else if(!strcasecmp(opt_allpairs_alg, "dijkstra")){
         allpairsalg = AllPairsAlg::ALG_DIJKSTRA_ALLPAIRS;
+    }else if(!strcasecmp(opt_allpairs_alg, "transitive-closure")){
+        allpairsalg = AllPairsAlg::ALG_TRANSITIVE_CLOSURE;
 
     }else{
         fprintf(stderr, "Error: unknown allpairs reachability algorithm %s, aborting\n",
@@ -720,7 +799,54 @@ int main(int argc, char** argv){
         }
 
 
-        lbool ret = optimize_and_solve(S, parser.assumptions, parser.objectives, false, found_optimal);
+        lbool ret;
+        bool parallel = opt_threads > 1 && argc > 1;
+        if((parallel || opt_cube_depth > 0) && parser.objectives.size() == 0){
+            //Each copy of the instance is parsed independently from the input file
+            vec<PortfolioCopy*> copies;
+            for(int i = 1; parallel && i < opt_threads; i++){
+                PortfolioCopy* copy = new PortfolioCopy(S);
+                copy->parse(argv[1], opt_ignore_solve_statements);
+                copies.push(copy);
+            }
+            if(parallel && opt_verb > 0){
+                printf("Portfolio setup time = %f\n", rtime(0) - after_preprocessing);
+            }
+            if(opt_cube_depth > 0){
+                //Cube-and-conquer: split the search into cubes by lookahead in the primary solver,
+                //and then solve the cubes using all of the copies.
+                double before_cubes = rtime(0);
+                vec<vec<Lit>> cubes;
+                vec<lbool> cube_status;
+                S.generateCubes(parser.assumptions, opt_cube_depth, cubes);
+                if(opt_verb > 0){
+                    printf("Generated %d cubes in %f s\n", cubes.size(), rtime(0) - before_cubes);
+                }
+                CubeAndConquer conquer;
+                conquer.addSolver(&S);
+                for(PortfolioCopy* copy:copies){
+                    conquer.addSolver(&copy->S);
+                }
+                ret = conquer.solve(parser.assumptions, cubes, cube_status);
+            }else{
+                //Run a portfolio of diversified copies of the instance in parallel; the first copy to find an answer wins.
+                Portfolio portfolio;
+                portfolio.addSolver(&S, parser.assumptions);
+                for(PortfolioCopy* copy:copies){
+                    portfolio.addSolver(&copy->S, copy->parser.assumptions);
+                }
+                ret = portfolio.solve();
+            }
+            for(PortfolioCopy* copy:copies){
+                delete copy;
+            }
+        }else{
+            if(opt_threads > 1 || opt_cube_depth > 0){
+                fprintf(stderr,
+                        "Warning: -threads requires an input file, and neither -threads nor -cube-depth support optimization objectives; solving with a single thread.\n");
+            }
+            ret = optimize_and_solve(S, parser.assumptions, parser.objectives, false, found_optimal);
+        }
         double solving_time = rtime(0) - after_preprocessing;
         if(opt_verb > 0){
             printf("Solving time = %f\n", solving_time);
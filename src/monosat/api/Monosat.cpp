@@ -47,6 +47,8 @@
 #include <algorithm>
 #include <iterator>
 #include <cstdint>
+#include <cstdlib>
+#include <unistd.h>
 
 using namespace Monosat;
 using namespace std;
@@ -179,6 +181,11 @@ void _selectAlgorithms(){
         mincutalg = MinCutAlg::ALG_DINITZ;
     }else if(!strcasecmp(opt_maxflow_alg, "dinits-linkcut")){
         mincutalg = MinCutAlg::ALG_DINITZ_LINKCUT;
+    }else if(!strcasecmp(opt_maxflow_alg, "dinitz-dynamic") || !strcasecmp(opt_maxflow_alg, "dinics-dynamic")
+             || !strcasecmp(opt_maxflow_alg, "dinits-dynamic")){
+        mincutalg = MinCutAlg::ALG_DINITZ_DYN;
+    }else if(!strcasecmp(opt_maxflow_alg, "push-relabel")){
+        mincutalg = MinCutAlg::ALG_PUSH_RELABEL;
     }else if(!strcasecmp(opt_maxflow_alg, "kohli-torr")){
         mincutalg = MinCutAlg::ALG_KOHLI_TORR;
     }else{
@@ -203,6 +210,8 @@ void _selectAlgorithms(){
         cyclealg = CycleAlg::ALG_DFS_CYCLE;
     }else if(!strcasecmp(opt_cycle_alg, "pk")){
         cyclealg = CycleAlg::ALG_PK_CYCLE;
+    }else if(!strcasecmp(opt_cycle_alg, "two-way")){
+        cyclealg = CycleAlg::ALG_TWOWAY_CYCLE;
     }else{
         api_errorf("Error: unknown cycle detection algorithm %s, aborting\n",
                    ((string) opt_cycle_alg).c_str());
@@ -242,6 +251,10 @@ void _selectAlgorithms(){
         reachalg = ReachAlg::ALG_RAMAL_REPS_BATCHED;
     }else if(!strcasecmp(opt_reach_alg, "ramal-reps-batch2")){
         reachalg = ReachAlg::ALG_RAMAL_REPS_BATCHED2;
+    }else if(!strcasecmp(opt_reach_alg, "bfs-multi")){
+        reachalg = ReachAlg::ALG_BFS_MULTI_SOURCE;
+    }else if(!strcasecmp(opt_reach_alg, "bfs-do")){
+        reachalg = ReachAlg::ALG_BFS_DO;
     }else{
         api_errorf("Error: unknown reachability algorithm %s, aborting\n", ((string) opt_reach_alg).c_str());
 
@@ -263,6 +276,8 @@ void _selectAlgorithms(){
         distalg = DistAlg::ALG_RAMAL_REPS_BATCHED;
     }else if(!strcasecmp(opt_dist_alg, "ramal-reps-batch2")){
         distalg = DistAlg::ALG_RAMAL_REPS_BATCHED2;
+    }else if(!strcasecmp(opt_dist_alg, "bidirectional")){
+        distalg = DistAlg::ALG_BIDIRECTIONAL;
     }else{
         api_errorf("Error: unknown distance algorithm %s, aborting\n", ((string) opt_dist_alg).c_str());
 
@@ -294,8 +309,12 @@ void _selectAlgorithms(){
 
     if(!strcasecmp(opt_allpairs_alg, "floyd-warshall")){
         allpairsalg = AllPairsAlg::ALG_FLOYDWARSHALL;
+    }else if(!strcasecmp(opt_allpairs_alg, "blocked-floyd-warshall")){
+        allpairsalg = AllPairsAlg::ALG_BLOCKED_FLOYDWARSHALL;
     }else if(!strcasecmp(opt_allpairs_alg, "dijkstra")){
         allpairsalg = AllPairsAlg::ALG_DIJKSTRA_ALLPAIRS;
+    }else if(!strcasecmp(opt_allpairs_alg, "transitive-closure")){
+        allpairsalg = AllPairsAlg::ALG_TRANSITIVE_CLOSURE;
 
     }else{
         api_errorf("Error: unknown allpairs reachability algorithm %s, aborting\n",
@@ -400,16 +419,34 @@ Var externalBV(Monosat::SimpSolver* S, int bvID){
     return bv->unmapBV(bvID);
 }
 
-void setOutputFile(Monosat::SimpSolver* S, const char* output){
-    MonosatData* d = (MonosatData*) S->_external_data;
-    assert(d);
+//Close the output file; if it was a temporary file created for solveParallel, also close the descriptor used to
+//read it back (the file itself was unlinked when it was created).
+static void _closeOutputFile(MonosatData* d){
     if(d->outfile){
         fclose(d->outfile);
         d->outfile = nullptr;
         d->circuit.setOutputFile(nullptr);
     }
+    if(d->replay_fd >= 0){
+        close(d->replay_fd);
+        d->replay_fd = -1;
+    }
+    d->outfile_name = "";
+    d->outfile_complete = false;
+}
+
+void setOutputFile(Monosat::SimpSolver* S, const char* output){
+    MonosatData* d = (MonosatData*) S->_external_data;
+    assert(d);
+    _closeOutputFile(d);
     if(output && strlen(output) > 0){
         d->outfile = fopen(output, "w");
+        if(d->outfile){
+            d->outfile_name = output;
+            //The output file can only be replayed by solveParallel if it has recorded all of the constraints
+            //(the constant true literal, if it exists, is written below).
+            d->outfile_complete = S->nVars() == 0 || (S->nVars() == 1 && S->const_true != lit_Undef);
+        }
     }
     write_out(S, "c monosat %s\n", d->args.c_str());
     if(S->const_true != lit_Undef){
@@ -528,6 +565,25 @@ Monosat::SimpSolver* newSolver_args(int argc, char** argv){
         ((MonosatData*) S->_external_data)->parser = parser;
         S->setVarMap(parser);
     }
+    if(opt_threads > 1){
+        //Record all constraints to a temporary file (in $TMPDIR, or /tmp), so that solveParallel can reconstruct
+        //copies of this solver. The file is unlinked as soon as it is open, and read back through the descriptor
+        //from mkstemp, so it is removed even if the solver is never deleted. If the file can't be created,
+        //solveParallel warns and solves with a single thread.
+        const char* tmp_dir = getenv("TMPDIR");
+        std::string tmp_name = std::string(tmp_dir && *tmp_dir ? tmp_dir : "/tmp") + "/monosat_XXXXXX";
+        int fd = mkstemp(&tmp_name[0]);
+        if(fd != -1){
+            setOutputFile(S, tmp_name.c_str());
+            unlink(tmp_name.c_str());
+            MonosatData* d = (MonosatData*) S->_external_data;
+            if(d->outfile){
+                d->replay_fd = fd;
+            }else{
+                close(fd);
+            }
+        }
+    }
     return S;
 }
 
@@ -544,14 +600,26 @@ void flushFile(Monosat::SimpSolver* S){
 void closeFile(Monosat::SimpSolver* S){
     if(S->_external_data){
         MonosatData* data = (MonosatData*) S->_external_data;
-        if(data->outfile){
-            fclose(data->outfile);
-            data->outfile = nullptr;
-            data->circuit.setOutputFile(nullptr);
-        }
+        _closeOutputFile(data);
     }
 }
 
+void saveSolverState(Monosat::SimpSolver* S, const char* filename){
+    S->saveState(filename);
+}
+
+bool loadSolverState(Monosat::SimpSolver* S, const char* filename){
+    return S->loadState(filename);
+}
+
+const char* getProfile(Monosat::SimpSolver* S){
+    MonosatData* d = (MonosatData*) S->_external_data;
+    std::stringstream ss;
+    S->writeProfile(ss);
+    d->profile = ss.str();
+    return d->profile.c_str();
+}
+
 void deleteSolver(Monosat::SimpSolver* S){
     S->interrupt();
     solvers.erase(S);//remove S from the list of solvers in the signal handler
@@ -566,10 +634,7 @@ void deleteSolver(Monosat::SimpSolver* S){
 #endif
             data->has_timer = false;
         }
-        if(data->outfile){
-            fclose(data->outfile);
-            data->outfile = nullptr;
-        }
+        _closeOutputFile(data);
         delete (data);
         S->_external_data = nullptr;
     }
@@ -786,6 +851,7 @@ void loadGNF(Monosat::SimpSolver* S, const char* filename){
         MonosatData* d = (MonosatData*) S->_external_data;
         auto& parser = *d->parser;
         StreamBuffer strm(in);
+        d->outfile_complete = false;//constraints loaded from a GNF are not recorded in the output file
 
         d->optimization_objectives.clear();
         while(parser.parse(strm, *S)){
@@ -811,6 +877,7 @@ void readGNF(Monosat::SimpSolver* S, const char* filename){
         MonosatData* d = (MonosatData*) S->_external_data;
         auto& parser = *d->parser;
         StreamBuffer strm(in);
+        d->outfile_complete = false;//constraints loaded from a GNF are not recorded in the output file
         vec<int> assumps;
         bool ran_last_solve = false;
         d->optimization_objectives.clear();
@@ -944,7 +1011,76 @@ int nLearnedClauses(Monosat::SimpSolver* S){
     return S->nLearnts();
 }
 
-int _solve(Monosat::SimpSolver* S, int* assumptions, int n_assumptions){
+//Solve using a portfolio of the solver and n_threads-1 copies of it, which are reconstructed (and kept up to date) by
+//replaying the constraints recorded in the solver's output file.
+//Bring the solver's portfolio copies (see solveParallel) up to date, by replaying any constraints recorded since they were
+//last updated. Returns false (after warning once) if the copies cannot be constructed.
+bool _updatePortfolioCopies(Monosat::SimpSolver* S, int n_threads){
+    MonosatData* d = (MonosatData*) S->_external_data;
+    if(!d->outfile || !d->outfile_complete){
+        static thread_local bool warned = false;
+        if(!warned){
+            warned = true;
+            fprintf(stderr,
+                    "Warning: parallel solving requires the solver to be created with '-threads=N', or an output file to be set before any constraints are added; solving with a single thread.\n");
+        }
+        return false;
+    }
+    fflush(d->outfile);
+    long recorded = ftell(d->outfile);
+    while(d->portfolio.size() > n_threads - 1){
+        delete (d->portfolio.last());
+        d->portfolio.pop();
+    }
+    while(d->portfolio.size() < n_threads - 1){
+        d->portfolio.push(new PortfolioCopy());
+    }
+    for(PortfolioCopy* copy:d->portfolio){
+        //replay any constraints recorded since this copy was last updated (including the current 'solve' statement)
+        gzFile in = NULL;
+        if(d->replay_fd >= 0){
+            int fd = dup(d->replay_fd);
+            if(fd >= 0 && (lseek(fd, 0, SEEK_SET) != 0 || (in = gzdopen(fd, "rb")) == NULL)){
+                close(fd);
+            }
+        }else{
+            in = gzopen(d->outfile_name.c_str(), "rb");
+        }
+        if(in == NULL){
+            api_errorf("Failed to read output file %s", d->outfile_name.c_str());
+        }
+        if(copy->replayed > 0 && gzseek(in, copy->replayed, SEEK_SET) < 0){
+            gzclose(in);
+            api_errorf("Failed to read output file %s", d->outfile_name.c_str());
+        }
+        StreamBuffer strm(in);
+        while(copy->S.okay() && copy->parser.parse(strm, copy->S)){
+            if(*strm == EOF){
+                break;
+            }
+        }
+        gzclose(in);
+        copy->replayed = recorded;
+        copy->S.preprocess();
+    }
+    return true;
+}
+
+lbool _solvePortfolio(Monosat::SimpSolver* S, vec<Lit>& assume, int n_threads){
+    MonosatData* d = (MonosatData*) S->_external_data;
+    if(!_updatePortfolioCopies(S, n_threads)){
+        bool found_optimal = true;
+        return optimize_and_solve(*S, assume, d->optimization_objectives, opt_pre, found_optimal);
+    }
+    Portfolio portfolio;
+    portfolio.addSolver(S, assume);
+    for(PortfolioCopy* copy:d->portfolio){
+        portfolio.addSolver(&copy->S, copy->parser.assumptions);
+    }
+    return portfolio.solve();
+}
+
+int _solve(Monosat::SimpSolver* S, int* assumptions, int n_assumptions, int n_threads = 1){
     bool found_optimal = true;
     MonosatData* d = (MonosatData*) S->_external_data;
     d->last_solution_optimal = true;
@@ -980,7 +1116,12 @@ int _solve(Monosat::SimpSolver* S, int* assumptions, int n_assumptions){
     if(d->pbsolver){
         d->pbsolver->convert();
     }
-    lbool r = optimize_and_solve(*S, assume, objectives, opt_pre, found_optimal);
+    lbool r;
+    if(n_threads > 1 && objectives.size() == 0){
+        r = _solvePortfolio(S, assume, n_threads);
+    }else{
+        r = optimize_and_solve(*S, assume, objectives, opt_pre, found_optimal);
+    }
     disableTimeLimit(S);
     d->last_solution_optimal = found_optimal;
     if(r == l_False){
@@ -1019,6 +1160,112 @@ bool solveAssumptions(Monosat::SimpSolver* S, int* assumptions, int n_assumption
     }
 }
 
+bool solveParallel(Monosat::SimpSolver* S, int n_threads){
+    return solveAssumptionsParallel(S, n_threads, nullptr, 0);
+}
+
+bool solveAssumptionsParallel(Monosat::SimpSolver* S, int n_threads, int* assumptions, int n_assumptions){
+    setTimeLimit(S, -1);//clear the time limit, if any
+    S->budgetOff();//solve() and solveAssumtpions() ignore resource limits
+    if(n_threads <= 0){
+        n_threads = opt_threads;
+    }
+    int r = _solve(S, assumptions, n_assumptions, n_threads);
+    if(r == toInt(l_True)){
+        return true;
+    }else if(r == toInt(l_False)){
+        return false;
+    }else{
+        throw std::runtime_error(
+                "Solver gave up without determining SAT or UNSAT (this might indicate an out of memory or ulimit issue.)");
+    }
+}
+
+int generateCubes(Monosat::SimpSolver* S, int depth, int* assumptions, int n_assumptions){
+    MonosatData* d = (MonosatData*) S->_external_data;
+    if(depth < 0){
+        api_errorf("Cube depth must be non-negative (was %d)", depth);
+    }
+    S->cancelUntil(0);
+    S->preprocess();
+    d->cube_assumptions.clear();
+    for(int i = 0; i < n_assumptions; i++){
+        Lit l = internalLit(S, assumptions[i]);
+        if(var(l) >= S->nVars()){
+            api_errorf("Assumption literal %d is not allocated", dimacs(S, l));
+        }
+        d->cube_assumptions.push(l);
+    }
+    S->generateCubes(d->cube_assumptions, depth, d->cubes);
+    d->cube_status.clear();
+    d->cube_status.growTo(d->cubes.size(), l_Undef);
+    return d->cubes.size();
+}
+
+int nCubes(Monosat::SimpSolver* S){
+    MonosatData* d = (MonosatData*) S->_external_data;
+    return d->cubes.size();
+}
+
+int getCube(Monosat::SimpSolver* S, int cube, int* store_cube, int max_store_size){
+    MonosatData* d = (MonosatData*) S->_external_data;
+    if(cube < 0 || cube >= d->cubes.size()){
+        api_errorf("Cube %d does not exist", cube);
+    }
+    vec<Lit>& c = d->cubes[cube];
+    for(int i = 0; i < c.size() && i < max_store_size; i++){
+        store_cube[i] = externalLit(S, c[i]);
+    }
+    return c.size();
+}
+
+int getCubeStatus(Monosat::SimpSolver* S, int cube){
+    MonosatData* d = (MonosatData*) S->_external_data;
+    if(cube < 0 || cube >= d->cube_status.size()){
+        api_errorf("Cube %d does not exist", cube);
+    }
+    return toInt(d->cube_status[cube]);
+}
+
+void setCubeStatus(Monosat::SimpSolver* S, int cube, int status){
+    MonosatData* d = (MonosatData*) S->_external_data;
+    if(cube < 0 || cube >= d->cube_status.size()){
+        api_errorf("Cube %d does not exist", cube);
+    }
+    if(status < 0 || status > 2){
+        api_errorf("Invalid cube status %d", status);
+    }
+    d->cube_status[cube] = toLbool(status);
+}
+
+int solveCubes(Monosat::SimpSolver* S, int n_threads){
+    MonosatData* d = (MonosatData*) S->_external_data;
+    d->last_solution_optimal = true;
+    d->has_conflict_clause_from_last_solution = false;
+    if(n_threads <= 0){
+        n_threads = opt_threads;
+    }
+    enforceTimeLimit(S);
+    S->cancelUntil(0);
+    S->preprocess();
+    CubeAndConquer conquer;
+    conquer.addSolver(S);
+    if(n_threads > 1 && _updatePortfolioCopies(S, n_threads)){
+        for(PortfolioCopy* copy:d->portfolio){
+            conquer.addSolver(&copy->S);
+        }
+    }
+    lbool r = conquer.solve(d->cube_assumptions, d->cubes, d->cube_status);
+    disableTimeLimit(S);
+    if(r == l_False){
+        d->has_conflict_clause_from_last_solution = true;
+    }
+    if(opt_verb >= 1){
+        printStats(S);
+    }
+    return toInt(r);
+}
+
 bool lastSolutionWasOptimal(Monosat::SimpSolver* S){
     MonosatData* d = (MonosatData*) S->_external_data;
     if(d){
@@ -93,9 +93,45 @@ void flushFile(SolverPtr S);
 //stop writing constraints to file, and close the file (if any)
 //this will be called automatically if the solver is deleted
 void closeFile(SolverPtr S);
+//Save what the solver has learnt (learnt clauses and their scores, variable and theory activities, saved phases,
+//and the facts known at the top level, including those derived by theories) to a binary file.
+void saveSolverState(SolverPtr S, const char* filename);
+//Warm-start the solver from a file written by saveSolverState(). The solver must have been built from the same
+//constraints as the one that saved the file (for example, by loading the same GNF); assumptions are not saved.
+//Returns false if the solver is now known to be UNSAT.
+bool loadSolverState(SolverPtr S, const char* filename);
+//Returns a JSON document with propagation counts and (sampled) timings for each theory solver, broken down by detector
+//or operation type. The returned string is owned by the solver, and is only valid until the next call to getProfile.
+const char* getProfile(SolverPtr S);
 
 bool solve(SolverPtr S);
 bool solveAssumptions(SolverPtr S, int* assumptions, int n_assumptions);
+//Solve using a portfolio of n_threads diversified copies of the solver, running in parallel and sharing short learnt clauses;
+//the first copy to find an answer wins, and the model (or conflict clause) is then available from S as usual.
+//The copies are reconstructed by replaying the constraints recorded in the solver's output file (rather than copied from
+//the solver's memory), so this requires the solver to have been created with '-threads=N' (which records to a temporary
+//file in $TMPDIR or /tmp), or setOutputFile() to have been called before any constraints were added
+//(otherwise, or if any optimization objectives are set, this falls back to a single-threaded solve).
+//If n_threads <= 0, the value of '-threads' is used.
+bool solveParallel(SolverPtr S, int n_threads);
+bool solveAssumptionsParallel(SolverPtr S, int n_threads, int* assumptions, int n_assumptions);
+//Cube-and-conquer: split the search space under the given assumptions into up to 2^depth cubes (conjunctions of literals),
+//by lookahead on the literals (preferring theory atoms, such as edges) that trigger the most unit and theory propagation.
+//Returns the number of cubes. If it returns 0, lookahead refuted every cube, so the instance is UNSAT under the assumptions.
+//The cubes are stored in the solver until the next call to generateCubes(). Each cube can be solved as extra assumptions
+//(for example, in another process) and its outcome recorded with setCubeStatus(), or they can all be solved with solveCubes().
+int generateCubes(SolverPtr S, int depth, int* assumptions, int n_assumptions);
+int nCubes(SolverPtr S);
+//Copies up to max_store_size literals of the cube into store_cube, and returns the number of literals in the cube.
+int getCube(SolverPtr S, int cube, int* store_cube, int max_store_size);
+//Status of a cube: 0 = SAT, 1 = UNSAT, 2 = not yet known (as for solveLimited()).
+int getCubeStatus(SolverPtr S, int cube);
+void setCubeStatus(SolverPtr S, int cube, int status);
+//Solve the cubes whose status is not yet known, using n_threads copies of the solver (see solveParallel) that each solve
+//one cube at a time and keep their learnt clauses from cube to cube. Returns 0 (SAT) as soon as any cube is SAT, in which
+//case the model is available as usual, 1 (UNSAT) once every cube is UNSAT, in which case the conflict clause is available,
+//and 2 if the time or resource limits were reached first. If n_threads <= 0, the value of '-threads' is used.
+int solveCubes(SolverPtr S, int n_threads);
 //Solve under assumptions, and also minimize a set of BVs (in order of precedence)
 //bool solveAssumptions_MinBVs(SolverPtr S,int * assumptions, int n_assumptions, int * minimize_bvs, int n_minimize_bvs);
 
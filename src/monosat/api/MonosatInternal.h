@@ -38,8 +38,12 @@
 #include "monosat/pb/PbParser.h"
 #include "monosat/amo/AMOParser.h"
 #include "monosat/core/Optimize.h"
+#include "monosat/core/Portfolio.h"
+#include "monosat/core/CubeAndConquer.h"
 #include "monosat/pb/PbSolver.h"
 #include "monosat/routing/FlowRouter.h"
+#include "monosat/routing/FlowRouterParser.h"
+#include "monosat/fsm/FSMParser.h"
 #include "monosat/api/Circuit.h"
 #include <string>
 #include <cstdio>
@@ -54,6 +58,38 @@ typedef timer_t posix_timer;
 typedef void* posix_timer;
 #endif
 
+//An independent copy of a solver, reconstructed by replaying the constraints recorded in that solver's output file,
+//for use as one thread of a parallel portfolio (see solveParallel).
+struct PortfolioCopy {
+    Monosat::SimpSolver S;
+    Dimacs<StreamBuffer, SimpSolver> parser;
+    BVParser<char*, SimpSolver> bvParser;
+    SymbolParser<char*, SimpSolver> symbolParser;
+    GraphParser<char*, SimpSolver> graphParser;
+    FlowRouterParser<char*, SimpSolver> flowRouterParser;
+    PBParser<char*, SimpSolver> pbParser;
+    FSMParser<char*, SimpSolver> fsmParser;
+    AMOParser<char*, SimpSolver> amo;
+    long replayed = 0;//number of bytes of the output file that have already been replayed into this copy
+
+    PortfolioCopy() : graphParser(true, bvParser.theory), flowRouterParser(&graphParser), pbParser(S){
+        if(!opt_pre){
+            S.eliminate(true);//disable preprocessing.
+        }
+        S.setPBSolver(new PB::PbSolver(S));
+        parser.addParser(&bvParser);
+        parser.addParser(&symbolParser);
+        parser.addParser(&graphParser);
+        parser.addParser(&flowRouterParser);
+        parser.addParser(&pbParser);
+        parser.addParser(&fsmParser);
+        parser.addParser(&amo);
+        //as in newSolver_args, the copy must report literals in the same (external) numbering as the primary solver,
+        //as shared clauses and the transferred model and conflict are exchanged in that numbering
+        S.setVarMap(&parser);
+    }
+};
+
 struct MonosatData {
     Monosat::Circuit<Monosat::SimpSolver> circuit;
     Monosat::BVTheorySolver<int64_t>* bv_theory = nullptr;
@@ -68,13 +104,24 @@ struct MonosatData {
     vec<Objective> optimization_objectives;
     Dimacs<StreamBuffer, SimpSolver>* parser = nullptr;
     FILE* outfile = nullptr;
+    std::string outfile_name = "";
+    int replay_fd = -1;//if outfile is an (already unlinked) temporary file created for solveParallel, a descriptor to read it back
+    bool outfile_complete = false;//true if outfile has recorded every constraint since the solver was created
+    vec<PortfolioCopy*> portfolio;
+    vec<vec<Lit>> cubes;//the cubes from the last call to generateCubes
+    vec<lbool> cube_status;
+    vec<Lit> cube_assumptions;
     std::string args = "";
+    std::string profile;//the last string returned by getProfile
 
     MonosatData(SimpSolver* solver) : circuit(*solver){
 
     }
 
     ~MonosatData(){
+        for(PortfolioCopy* copy:portfolio){
+            delete (copy);
+        }
         for(auto* p:parser->getParsers()){
             delete (p);
         }
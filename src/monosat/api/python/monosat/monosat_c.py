@@ -22,6 +22,7 @@ from __future__ import print_function
 # Python interface to MonoSAT
 # Includes _optional_ support for cython, otherwise falling back on ctypes
 
+import json
 import os
 import platform
 from monosat.singleton import Singleton
@@ -244,12 +245,51 @@ class Monosat(metaclass=Singleton):
             self.monosat_c.readGNF.argtypes = [c_solver_p, c_char_p]
             self.monosat_c.loadGNF.argtypes = [c_solver_p, c_char_p]
 
+            self.monosat_c.saveSolverState.argtypes = [c_solver_p, c_char_p]
+            self.monosat_c.loadSolverState.argtypes = [c_solver_p, c_char_p]
+            self.monosat_c.loadSolverState.restype = c_bool
+            self.monosat_c.getProfile.argtypes = [c_solver_p]
+            self.monosat_c.getProfile.restype = c_char_p
+
             self.monosat_c.solve.argtypes = [c_solver_p]
             self.monosat_c.solve.restype = c_bool
 
             self.monosat_c.solveAssumptions.argtypes = [c_solver_p, c_literal_p, c_int]
             self.monosat_c.solveAssumptions.restype = c_bool
 
+            self.monosat_c.solveParallel.argtypes = [c_solver_p, c_int]
+            self.monosat_c.solveParallel.restype = c_bool
+
+            self.monosat_c.solveAssumptionsParallel.argtypes = [
+                c_solver_p,
+                c_int,
+                c_literal_p,
+                c_int,
+            ]
+            self.monosat_c.solveAssumptionsParallel.restype = c_bool
+
+            self.monosat_c.generateCubes.argtypes = [
+                c_solver_p,
+                c_int,
+                c_literal_p,
+                c_int,
+            ]
+            self.monosat_c.generateCubes.restype = c_int
+
+            self.monosat_c.nCubes.argtypes = [c_solver_p]
+            self.monosat_c.nCubes.restype = c_int
+
+            self.monosat_c.getCube.argtypes = [c_solver_p, c_int, c_int_p, c_int]
+            self.monosat_c.getCube.restype = c_int
+
+            self.monosat_c.getCubeStatus.argtypes = [c_solver_p, c_int]
+            self.monosat_c.getCubeStatus.restype = c_int
+
+            self.monosat_c.setCubeStatus.argtypes = [c_solver_p, c_int, c_int]
+
+            self.monosat_c.solveCubes.argtypes = [c_solver_p, c_int]
+            self.monosat_c.solveCubes.restype = c_int
+
             self.monosat_c.solveLimited.argtypes = [c_solver_p]
             self.monosat_c.solveLimited.restype = c_int
 
@@ -970,6 +1010,17 @@ class Monosat(metaclass=Singleton):
         else:
             self.monosat_c.loadGNF(self.solver._ptr, c_char_p(filename.encode("ascii")))
 
+    def saveSolverState(self, filename):
+        self.monosat_c.saveSolverState(self.solver._ptr, c_char_p(filename.encode("ascii")))
+
+    def loadSolverState(self, filename):
+        self.backtrack()
+        return self.monosat_c.loadSolverState(self.solver._ptr, c_char_p(filename.encode("ascii")))
+
+    # Propagation counts and sampled timings for each theory solver, as a dictionary (see getProfile in Monosat.h)
+    def getProfile(self):
+        return json.loads(self.monosat_c.getProfile(self.solver._ptr).decode("utf-8"))
+
     def getEmptyIntArray(self, length):
         if length > len(self._int_array):
             self._int_array = (c_int * length)()
@@ -1065,6 +1116,69 @@ class Monosat(metaclass=Singleton):
 
         return self.monosat_c.solveAssumptions(self.solver._ptr, lp, len(assumptions))
 
+    def solveParallel(self, n_threads, assumptions=None):
+        self.backtrack()
+        if assumptions is None:
+            assumptions = []
+
+        lp = self.getIntArray(assumptions)
+
+        return self.monosat_c.solveAssumptionsParallel(
+            self.solver._ptr, n_threads, lp, len(assumptions)
+        )
+
+    def generateCubes(self, depth, assumptions=None):
+        self.backtrack()
+        if assumptions is None:
+            assumptions = []
+
+        lp = self.getIntArray(assumptions)
+
+        return self.monosat_c.generateCubes(
+            self.solver._ptr, depth, lp, len(assumptions)
+        )
+
+    def nCubes(self):
+        return self.monosat_c.nCubes(self.solver._ptr)
+
+    def getCube(self, cube):
+        cube_size = self.monosat_c.getCube(self.solver._ptr, cube, null_ptr, 0)
+        cube_ptr = self.getEmptyIntArray(cube_size)
+        length = self.monosat_c.getCube(self.solver._ptr, cube, cube_ptr, cube_size)
+        if length != cube_size:
+            raise RuntimeError("Error reading cube")
+        return self.intArrayToList(cube_ptr, cube_size)
+
+    def getCubeStatus(self, cube):
+        r = self.monosat_c.getCubeStatus(self.solver._ptr, cube)
+        if r == 0:
+            return True
+        elif r == 1:
+            return False
+        else:
+            assert r == 2
+            return None
+
+    def setCubeStatus(self, cube, status):
+        if status is None:
+            r = 2
+        elif status:
+            r = 0
+        else:
+            r = 1
+        self.monosat_c.setCubeStatus(self.solver._ptr, cube, r)
+
+    def solveCubes(self, n_threads=0):
+        self.backtrack()
+        r = self.monosat_c.solveCubes(self.solver._ptr, n_threads)
+        if r == 0:
+            return True
+        elif r == 1:
+            return False
+        else:
+            assert r == 2
+            return None
+
     def solveLimited(self, assumptions=None):
         self.backtrack()
         if assumptions is None:
@@ -3314,9 +3314,9 @@ public:
             vec<Lit>& bv_a = theory.bitvectors[aID];
             vec<Lit>& bv_b = theory.bitvectors[bID];
 
-            static vec<Lit> tmp_a;
-            static vec<Lit> tmp_b;
-            static vec<Lit> tmp_c;
+            static thread_local vec<Lit> tmp_a;
+            static thread_local vec<Lit> tmp_b;
+            static thread_local vec<Lit> tmp_c;
             tmp_a.clear();
             tmp_b.clear();
             tmp_c.clear();
@@ -3329,7 +3329,7 @@ public:
             for(Lit l:bv){
                 tmp_c.push(toSolver(l));
             }
-            static vec<Lit> store;
+            static thread_local vec<Lit> store;
             store.clear();
             Lit carry = lit_Undef;
             c.Add(tmp_a, tmp_b, store, carry);
@@ -5377,11 +5377,44 @@ public:
     int64_t propagations = -1;
     int64_t stats_propagations_skipped = 0;
     int64_t statis_bv_updates = 0;
+    int64_t stats_enqueued = 0;//Number of literals implied by this theory
+    //Propagation and reason calls, by operation type (see getProfiles)
+    PropagationProfile operation_profiles[(int) OperationType::cause_is_lazy_bits + 1];
 
     const char* getTheoryType() override{
         return "BV";
     }
 
+    void getProfiles(std::vector<ProfilePart>& parts) override{
+        static const char* names[] = {"none", "bits", "decision", "theory", "refined", "ComparisonOp",
+                                      "BVComparisonOp", "Addition", "AdditionArg", "Conditional", "ConditionalArg",
+                                      "MinMax", "MinMaxArg", "PopCount", "Invert", "Multiplication",
+                                      "MultiplicationArg", "Unary", "LazyBits"};
+        static_assert(sizeof(names) / sizeof(names[0]) == (int) OperationType::cause_is_lazy_bits + 1, "");
+        for(int i = 0; i <= (int) OperationType::cause_is_lazy_bits; i++){
+            if(operation_profiles[i].calls > 0 || operation_profiles[i].reasons > 0){
+                parts.push_back({names[i], &operation_profiles[i]});
+            }
+        }
+    }
+
+    //Run one operation's propagation, counting it in the profile of its operation type
+    template<typename Propagate>
+    bool profileOperation(Operation& op, Propagate&& propagate){
+        PropagationProfile& profile = operation_profiles[(int) op.getType()];
+        int64_t enqueued = stats_enqueued;
+        bool r;
+        {
+            ProfileTimer timer(profile, ProfileTimer::CALL);
+            r = propagate();
+        }
+        profile.propagations += stats_enqueued - enqueued;
+        if(!r){
+            profile.conflicts++;
+        }
+        return r;
+    }
+
     BVTheorySolver(TheorySolver* S) :
             S(S){
         rnd_seed = drand(S->getRandomSeed());
@@ -5815,6 +5848,7 @@ public:
 #endif
 
         if(S->enqueue(sl, reason)){
+            stats_enqueued++;
             return true;
         }else{
             return false;
@@ -6354,10 +6388,6 @@ public:
     };
 
     void buildReason(Lit p, vec<Lit>& reason, CRef marker) override{
-        static int iter = 0;
-        if(++iter == 39){//17
-            int a = 1;
-        }
         assert(value(p) != l_False);
 
         assert(marker != CRef_Undef);
@@ -6381,7 +6411,10 @@ public:
 		}*/
         assert(hasOperation(p));
         Operation& op = getOperation(p);
-        op.buildReason(p, marker, reason);
+        {
+            ProfileTimer timer(operation_profiles[(int) op.getType()], ProfileTimer::REASON);
+            op.buildReason(p, marker, reason);
+        }
         //note: the reason has already been transformed into the solvers variable namespace at this point,
         //do _not_ call 'toSolver' again
 
@@ -6617,8 +6650,6 @@ public:
 
         double update_start_time = rtime(3);
         statis_bv_updates++;
-        static int iter = 0;
-        ++iter;
 
 
         Weight under_old = under_approx[bvID];
@@ -6819,7 +6850,7 @@ public:
 
     void writeBounds(int bvID){
         if(opt_write_learnt_clauses && opt_write_bv_bounds){
-            static int bound_num = 0;
+            static thread_local int bound_num = 0;
             if(++opt_n_learnts == 44231){
                 int a = 1;
             }
@@ -7083,7 +7114,7 @@ public:
     }
 
     bool propagateTheory(vec<Lit>& conflict, bool force_propagation, bool isSolveCheck = false){
-        static int realprops = 0;
+        static thread_local int realprops = 0;
         stats_propagations++;
 
         if(!force_propagation && !requiresPropagation){
@@ -7168,7 +7199,9 @@ public:
             //also need to iterate through the additions that this bv is an argument of...
             for(int opID:operation_ids[bvID]){
 
-                if(getOperation(opID).enabled() && !getOperation(opID).propagate(changed, conflict)){
+                if(getOperation(opID).enabled() && !profileOperation(getOperation(opID), [&](){
+                    return getOperation(opID).propagate(changed, conflict);
+                })){
                     return false;
                 }
             }
@@ -7182,7 +7215,7 @@ public:
                 assert(getOperation(cID).getType() == OperationType::cause_is_comparison);
                 ComparisonOp& c = (ComparisonOp&) getOperation(cID);
 
-                if(!c.propagate(changed, conflict, true))
+                if(!profileOperation(c, [&](){ return c.propagate(changed, conflict, true); }))
                     return false;
             }
 
@@ -7191,7 +7224,7 @@ public:
                 assert(getOperation(cID).getType() == OperationType::cause_is_comparison);
                 ComparisonOp& c = (ComparisonOp&) getOperation(cID);
 
-                if(!c.propagate(changed, conflict, false))
+                if(!profileOperation(c, [&](){ return c.propagate(changed, conflict, false); }))
                     return false;
             }
 
@@ -7368,8 +7401,6 @@ public:
             bvID = eq_bitvectors[bvID];
         writeBounds(bvID);
         stats_build_value_reason++;
-        static int iter = 0;
-        ++iter;
         //printf("reason %d: %d\n",iter,bvID);
 
         //rewind_trail_pos(trail_pos);
@@ -7414,10 +7445,6 @@ public:
             return;
         }
         if(opt_write_learnt_clauses && opt_write_bv_analysis){
-            static int n_analysis = 0;
-            if(++n_analysis == 430){
-                int a = 1;
-            }
             std::stringstream ss;
             ss << op << " " << to;
             fprintf(opt_write_learnt_clauses, "learnt analysis bv %d %s ", unmapBV(bvID), ss.str().c_str());
@@ -7691,7 +7718,6 @@ public:
     }
 
     void analyze(vec<Lit>& conflict){
-        static int64_t iter = 0;
         int prev_pos = analysis_trail_pos;
         while(n_pending_analyses > 0){
 
@@ -8940,10 +8966,6 @@ public:
             l = mkLit(newVar(outerVar, comparisonID, true, decidable));
 
         }
-        static int iter = 0;
-        if(++iter == 29){
-            int a = 1;
-        }
 
         if(opt_write_learnt_clauses){
             std::stringstream ss;
@@ -9892,7 +9914,7 @@ template<typename Weight>
 Weight BVTheorySolver<Weight>::refine_ubound_check(int bvID, Weight bound, Var ignore_bit){
 #ifdef DEBUG_BV
                                                                                                                             //test all values of mbits, find the lowest one >= i
-	static vec<Weight> vals;
+	static thread_local vec<Weight> vals;
 	vals.clear();
 
     dbg_evaluate(bvID,bitvectors[bvID].size()-1,vals,0);
@@ -9912,7 +9934,7 @@ template<typename Weight>
 Weight BVTheorySolver<Weight>::refine_lbound_check(int bvID, Weight bound, Var ignore_bit){
 #ifdef DEBUG_BV
                                                                                                                             //test all values of mbits, find the lowest one >= i
-	static vec<Weight> vals;
+	static thread_local vec<Weight> vals;
 	vals.clear();
 
     dbg_evaluate(bvID,bitvectors[bvID].size()-1,vals,0);
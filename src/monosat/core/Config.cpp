@@ -66,13 +66,59 @@ BoolOption Monosat::opt_luby_restart(_cat, "luby", "Use the Luby restart sequenc
 IntOption Monosat::opt_restart_first(_cat, "rfirst", "The base restart interval", 100, IntRange(1, INT32_MAX));
 DoubleOption Monosat::opt_restart_inc(_cat, "rinc", "Restart interval increase factor", 2,
                                       DoubleRange(1, false, HUGE_VAL, false));
+BoolOption Monosat::opt_lbd_tiers(_cat, "lbd-tiers",
+                                  "Manage learnt clauses in core/tier2/local tiers by their LBD (glue), rather than by activity alone",
+                                  false);
+IntOption Monosat::opt_lbd_core(_cat, "lbd-core", "Learnt clauses with at most this LBD are kept permanently (with -lbd-tiers)",
+                                2, IntRange(0, INT32_MAX));
+IntOption Monosat::opt_lbd_tier2(_cat, "lbd-tier2",
+                                 "Learnt clauses with at most this LBD are kept for as long as they keep participating in conflicts (with -lbd-tiers)",
+                                 6, IntRange(0, INT32_MAX));
+IntOption Monosat::opt_lbd_theory_tier2(_cat, "lbd-theory-tier2",
+                                        "As -lbd-tier2, but for clauses learnt from theory conflicts",
+                                        8, IntRange(0, INT32_MAX));
+BoolOption Monosat::opt_reuse_trail(_cat, "reuse-trail",
+                                    "On restarts, keep the decisions that would be re-decided in the same order (partial restarts), so that theories need not re-propagate them",
+                                    false);
+IntOption Monosat::opt_chrono(_cat, "chrono",
+                             "Backtrack chronologically (one level) after a conflict, instead of backjumping, if the backjump would skip more than this many levels (-1 disables chronological backtracking)",
+                             -1, IntRange(-1, INT32_MAX));
+IntOption Monosat::opt_chrono_conflicts(_cat, "chrono-conflicts",
+                                       "Number of conflicts before chronological backtracking is enabled (with -chrono)",
+                                       4000, IntRange(0, INT32_MAX));
+BoolOption Monosat::opt_inprocess(_cat, "inprocess",
+                                  "Periodically vivify, subsume and strengthen the clause database between restarts",
+                                  false);
+IntOption Monosat::opt_inprocess_interval(_cat, "inprocess-interval", "Number of conflicts between inprocessing rounds",
+                                          5000, IntRange(1, INT32_MAX));
+IntOption Monosat::opt_inprocess_budget(_cat, "inprocess-budget",
+                                        "Maximum number of propagations (for vivification), and of clause visits (for subsumption), in each inprocessing round",
+                                        20000, IntRange(0, INT32_MAX));
 DoubleOption Monosat::opt_garbage_frac(_cat, "gc-frac",
                                        "The fraction of wasted memory allowed before a garbage collection is triggered",
                                        0.20,
                                        DoubleRange(0, false, HUGE_VAL, false));
+IntOption Monosat::opt_threads("MAIN", "threads",
+                               "Number of diversified copies of the solver to run in parallel, sharing short learnt clauses (1 disables the portfolio)",
+                               1, IntRange(1, 1024));
+IntOption Monosat::opt_share_max_size(_cat, "share-size",
+                                      "Maximum size of learnt clauses shared between the threads of a portfolio (units are always shared)",
+                                      8, IntRange(1, INT32_MAX));
+IntOption Monosat::opt_cube_depth("MAIN", "cube-depth",
+                                  "Split the search into up to 2^cube-depth cubes by lookahead, and solve the cubes (in parallel, with -threads) (0 disables cube-and-conquer)",
+                                  0, IntRange(0, 30));
+IntOption Monosat::opt_cube_candidates(_cat, "cube-candidates",
+                                       "Number of unassigned variables evaluated by lookahead at each cube split",
+                                       32, IntRange(1, INT32_MAX));
+DoubleOption Monosat::opt_cube_theory_weight(_cat, "cube-theory-weight",
+                                             "Weight of theory implied literals (relative to literals implied by unit propagation) when scoring lookahead branches",
+                                             2.0, DoubleRange(0, true, HUGE_VAL, false));
 BoolOption Monosat::opt_pre("MAIN", "pre", "Completely turn on/off any preprocessing.", true);
 IntOption Monosat::opt_time(_cat, "verb-time", "Detail level of timing benchmarks (these add some overhead)", 0,
                             IntRange(0, 5));
+IntOption Monosat::opt_profile_sample(_cat, "profile-sample",
+                                      "Measure the wall-clock time of 1 in every N theory (and detector) propagation and reason calls, for the propagation profile (0 to count calls only)",
+                                      32, IntRange(0, INT32_MAX));
 
 
 BoolOption  Monosat::opt_pb_theory("PB", "pb-theory",
@@ -192,12 +238,21 @@ BoolOption Monosat::opt_graph(_cat_graph, "graph", "Use graph theory solver", tr
 BoolOption Monosat::opt_inc_graph(_cat_graph, "inc", "Use incremental graph reachability", false);
 IntOption Monosat::opt_dec_graph(_cat_graph, "dec", "Use decremental graph reachability", 0, IntRange(0, 2));
 StringOption Monosat::opt_maxflow_alg(_cat_graph, "maxflow",
-                                      "Select max s-t-flow algorithm (edmondskarp, edmondskarp-adj, edmondskarp-dynamic,dinitz,dinitz-linkcut, kohli-torr)",
+                                      "Select max s-t-flow algorithm (edmondskarp, edmondskarp-adj, edmondskarp-dynamic,dinitz,dinitz-linkcut,dinitz-dynamic,push-relabel, kohli-torr)",
                                       "kohli-torr"); //ibfs
 StringOption Monosat::opt_reach_alg(_cat_graph, "reach",
-                                    "Select reachability algorithm (bfs,dfs, dijkstra,ramal-reps,cnf)", "ramal-reps");
+                                    "Select reachability algorithm (bfs,dfs, dijkstra,ramal-reps,cnf,bfs-multi,bfs-do)", "ramal-reps");
 StringOption Monosat::opt_dist_alg(_cat_graph, "dist",
-                                   "Select reachability algorithm (bfs,dfs, dijkstra,ramal-reps,cnf)", "ramal-reps");
+                                   "Select reachability algorithm (bfs,dfs, dijkstra,ramal-reps,cnf,bidirectional)", "ramal-reps");
+BoolOption Monosat::opt_radix_heap(_cat_graph, "radix-heap",
+                                   "Use a radix heap (or, for unweighted graphs, a bucket queue) instead of a binary heap in Dijkstra's algorithm, for integer edge weights",
+                                   true);
+BoolOption Monosat::opt_reach_early_termination(_cat_graph, "reach-early-termination",
+                                                "Stop BFS reachability traversals once every node with an unassigned reach literal has been reached",
+                                                true);
+IntOption Monosat::opt_dist_landmarks(_cat_graph, "dist-landmarks",
+                                      "Number of ALT landmarks used to direct single-pair shortest path searches, with -dist=bidirectional (0 to disable)",
+                                      4, IntRange(0, INT32_MAX));
 
 StringOption Monosat::opt_con_alg(_cat_graph, "connect",
                                   "Select undirected reachability algorithm (bfs,dfs, dijkstra, thorup,cnf)", "bfs");
@@ -208,13 +263,13 @@ StringOption Monosat::opt_mst_alg(_cat_graph, "mst", "Select minimum spanning tr
                                   "spira-pan");
 
 StringOption Monosat::opt_allpairs_alg(_cat_graph, "allpairs",
-                                       "Select allpairs reachability algorithm (floyd-warshall,dijkstra)",
+                                       "Select allpairs reachability algorithm (floyd-warshall,blocked-floyd-warshall,dijkstra,transitive-closure)",
                                        "floyd-warshall");
 StringOption Monosat::opt_components_alg(_cat_graph, "components",
                                          "Select connected-components algorithm (disjoint-sets, link-cut)",
                                          "disjoint-sets");
 StringOption Monosat::opt_cycle_alg(_cat_graph, "cycles",
-                                    "Select cycle detection algorithm (dfs, pk)", "pk");
+                                    "Select cycle detection algorithm (dfs, pk, two-way)", "pk");
 
 BoolOption Monosat::opt_conflict_shortest_path(_cat_graph, "conflict-shortest-path",
                                                "Use shortest path (instead of arbitrary path) for conflict resolution (in theories that support this)",
@@ -237,7 +292,7 @@ IntOption Monosat::opt_adaptive_history_clear(_cat_graph, "adaptive-history-clea
                                               0, IntRange(0, INT32_MAX));
 BoolOption Monosat::opt_disable_history_clears(_cat_graph, "disable-history-clear", "", false);
 IntOption Monosat::opt_dynamic_history_clear(_cat_graph, "dynamic-history-clear",
-                                             "0=dont use dynamic history clears,1=use opportunistic dynamic history clears (falling back on normal history clears if that fails), 2=force dynamic history clears",
+                                             "History clears only discard changes that all dynamic algorithms have already read (falling back on full history clears if too much history is retained). 0,1=dont update lagging algorithms before a history clear, 2=bring lagging algorithms up to date before a history clear",
                                              0, IntRange(0, 2));
 
 BoolOption Monosat::opt_lazy_backtrack(_cat_theory, "lazy-backtrack", "", false);
@@ -383,6 +438,9 @@ BoolOption Monosat::opt_force_distance_solver(_cat_graph, "force-distance",
 DoubleOption Monosat::opt_allpairs_percentage(_cat_graph, "allpairs-frac",
                                               "Fraction of nodes as source reach querries at which to trigger using allpairs solver instead of separate theory solvers. 0 to force all querries to go through allpairs solver. 1 to disable.",
                                               1, DoubleRange(0, true, 1, true));
+IntOption Monosat::opt_allpairs_threads(_cat_graph, "allpairs-threads",
+                                        "Number of threads used to relax independent tiles in the blocked Floyd-Warshall allpairs solver",
+                                        1, IntRange(1, 1024));
 
 BoolOption Monosat::opt_decide_graph_neg(_cat_graph, "decide-graph-neg", "", false);
 
@@ -392,7 +450,12 @@ BoolOption Monosat::opt_ignore_theories(_cat_graph, "ignore-theories", "", false
 
 //BoolOption Minisat::opt_check_pure_theory_lits(_cat_graph,"pure-theory-lits","",false);
 
-BoolOption Monosat::opt_decide_graph_chokepoints(_cat_graph, "decide-graph-chokepoints", "", false);
+BoolOption Monosat::opt_decide_graph_chokepoints(_cat_graph, "decide-graph-chokepoints",
+                                                "When deciding a path for a reach constraint, first decide the edges that every path to the target must use (from a dominator tree of the over-approximate graph)",
+                                                false);
+BoolOption Monosat::opt_reach_forced_edge_prop(_cat_graph, "reach-forced-edge-prop",
+                                               "Force edges that every path from the source must use to reach a node that is required to be reachable (from a dominator tree of the over-approximate graph)",
+                                               false);
 IntOption Monosat::opt_sort_graph_decisions(_cat_graph, "decide-graph-sort",
                                             "0=dont sort, 1=sort by shortest, 2=sort by longest", 0, IntRange(0, 2));
 
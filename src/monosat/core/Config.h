@@ -40,7 +40,22 @@ extern BoolOption opt_rnd_init_act;
 extern BoolOption opt_luby_restart;
 extern IntOption opt_restart_first;
 extern DoubleOption opt_restart_inc;
+extern BoolOption opt_lbd_tiers;
+extern IntOption opt_lbd_core;
+extern IntOption opt_lbd_tier2;
+extern IntOption opt_lbd_theory_tier2;
+extern BoolOption opt_reuse_trail;
+extern IntOption opt_chrono;
+extern IntOption opt_chrono_conflicts;
+extern BoolOption opt_inprocess;
+extern IntOption opt_inprocess_interval;
+extern IntOption opt_inprocess_budget;
 extern DoubleOption opt_garbage_frac;
+extern IntOption opt_threads;
+extern IntOption opt_share_max_size;
+extern IntOption opt_cube_depth;
+extern IntOption opt_cube_candidates;
+extern DoubleOption opt_cube_theory_weight;
 extern BoolOption opt_restarts;
 extern BoolOption opt_rnd_restart;
 extern BoolOption opt_rnd_theory_restart;
@@ -164,6 +179,7 @@ extern DoubleOption opt_decide_graph_re_rnd;
 extern BoolOption opt_print_decision_path;
 extern BoolOption opt_force_distance_solver;
 extern DoubleOption opt_allpairs_percentage;
+extern IntOption opt_allpairs_threads;
 extern BoolOption opt_decide_graph_neg;
 extern BoolOption opt_decide_graph_pos;
 extern BoolOption opt_ignore_theories;
@@ -178,6 +194,7 @@ extern IntOption opt_temporary_theory_conflicts;
 extern IntOption opt_temporary_theory_reasons;
 extern BoolOption opt_force_directed;
 extern BoolOption opt_decide_graph_chokepoints;
+extern BoolOption opt_reach_forced_edge_prop;
 extern IntOption opt_sort_graph_decisions;
 extern IntOption opt_flow_router_heuristic;
 extern IntOption opt_flow_router_policy;
@@ -251,6 +268,9 @@ extern IntOption opt_min_edgeset;
 extern BoolOption opt_only_prop_edgeset;
 
 extern BoolOption opt_graph_cache_propagation;
+extern BoolOption opt_radix_heap;
+extern BoolOption opt_reach_early_termination;
+extern IntOption opt_dist_landmarks;
 extern IntOption opt_graph_use_cache_for_decisions;
 extern OptionSet opt_route;
 extern OptionSet opt_route2;
@@ -264,7 +284,9 @@ enum class ReachAlg {
     ALG_BFS,
     ALG_RAMAL_REPS,
     ALG_RAMAL_REPS_BATCHED,
-    ALG_RAMAL_REPS_BATCHED2
+    ALG_RAMAL_REPS_BATCHED2,
+    ALG_BFS_MULTI_SOURCE,
+    ALG_BFS_DO
 };
 
 //For undirected reachability
@@ -275,7 +297,7 @@ extern ConnectivityAlg undirectedalg;
 extern ReachAlg reachalg;
 
 enum class AllPairsAlg {
-    ALG_FLOYDWARSHALL, ALG_DIJKSTRA_ALLPAIRS
+    ALG_FLOYDWARSHALL, ALG_DIJKSTRA_ALLPAIRS, ALG_TRANSITIVE_CLOSURE, ALG_BLOCKED_FLOYDWARSHALL
 };
 extern AllPairsAlg allpairsalg;
 enum class AllPairsConnectivityAlg {
@@ -288,7 +310,9 @@ enum class MinCutAlg {
             ALG_EDKARP_DYN,
     ALG_DINITZ,
     ALG_DINITZ_LINKCUT,
-    ALG_KOHLI_TORR
+    ALG_KOHLI_TORR,
+    ALG_DINITZ_DYN,
+    ALG_PUSH_RELABEL
 };
 extern MinCutAlg mincutalg;
 enum class MinSpanAlg {
@@ -303,7 +327,8 @@ extern ComponentsAlg componentsalg;
 
 enum class CycleAlg {
     ALG_DFS_CYCLE,
-    ALG_PK_CYCLE
+    ALG_PK_CYCLE,
+    ALG_TWOWAY_CYCLE
 };
 extern CycleAlg cyclealg;
 
@@ -315,12 +340,13 @@ enum class ConvexHullAlg {
 extern ConvexHullAlg hullAlg;
 
 enum class DistAlg {
-    ALG_SAT, ALG_DIJKSTRA, ALG_DISTANCE, ALG_RAMAL_REPS, ALG_RAMAL_REPS_BATCHED, ALG_RAMAL_REPS_BATCHED2
+    ALG_SAT, ALG_DIJKSTRA, ALG_DISTANCE, ALG_RAMAL_REPS, ALG_RAMAL_REPS_BATCHED, ALG_RAMAL_REPS_BATCHED2, ALG_BIDIRECTIONAL
 };
 
 extern DistAlg distalg;
 
 extern IntOption opt_time;
+extern IntOption opt_profile_sample;
 
 static inline double rtime(int level = 1){
     if(level <= opt_time){
@@ -0,0 +1,283 @@
+/**************************************************************************************************
+ The MIT License (MIT)
+
+ Copyright (c) 2019, Sam Bayless
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+
+#ifndef MONOSAT_CUBEANDCONQUER_H
+#define MONOSAT_CUBEANDCONQUER_H
+
+#include "monosat/core/Solver.h"
+#include "monosat/core/SolverTypes.h"
+#include "monosat/core/Portfolio.h"
+#include "monosat/mtl/Vec.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <exception>
+#include <vector>
+
+namespace Monosat {
+
+/**
+ * The conquer phase of cube-and-conquer solving: solves each cube (see Solver::generateCubes) as additional
+ * assumptions, using one or more independently constructed copies of the same instance, each in its own thread.
+ * Each copy works through the remaining cubes one at a time, so that the clauses it learns on one cube
+ * are available when solving the next; short learnt clauses are also shared between the copies.
+ *
+ * The first solver added is the 'primary' solver (the solver that generated the cubes).
+ * The instance is SAT if any cube is SAT, in which case the primary solver's model reflects the answer,
+ * and UNSAT (under the assumptions) if every cube is UNSAT.
+ */
+class CubeAndConquer {
+    vec<Solver*> solvers;
+    ClauseExchange* exchange = nullptr;
+    const vec<Lit>* assumptions = nullptr;//in the primary solver's variable numbering
+    const vec<vec<Lit>>* cubes = nullptr;//in the primary solver's variable numbering
+    vec<lbool>* status = nullptr;
+    std::atomic<int> next_cube;
+    std::mutex result_mutex;
+    lbool result = l_Undef;
+    int winner = -1;
+    int winning_cube = -1;
+    bool assumptions_conflict = false;//true if some cube was refuted by the assumptions alone
+    std::exception_ptr error;
+
+public:
+    CubeAndConquer() : next_cube(0){
+    }
+
+    //The first solver added is the primary solver.
+    void addSolver(Solver* S){
+        solvers.push(S);
+    }
+
+    int nSolvers() const{
+        return solvers.size();
+    }
+
+    //The index of the cube that was found to be satisfiable in the last call to solve(), or -1.
+    int getSatisfiableCube() const{
+        return winning_cube;
+    }
+
+    /**
+     * Solve each cube whose status is l_Undef, recording the result for each cube in 'cube_status'.
+     * Returns l_True if some cube is satisfiable, l_False if every cube is unsatisfiable, and l_Undef
+     * if the primary solver's budget ran out (or it was interrupted) first.
+     */
+    lbool solve(const vec<Lit>& assumps, const vec<vec<Lit>>& cube_list, vec<lbool>& cube_status){
+        result = l_Undef;
+        winner = -1;
+        winning_cube = -1;
+        assumptions_conflict = false;
+        error = nullptr;
+        cube_status.growTo(cube_list.size(), l_Undef);
+        if(solvers.size() == 0){
+            return l_Undef;
+        }
+        Solver& primary = *solvers[0];
+        for(int i = 0; i < cube_status.size(); i++){
+            if(cube_status[i] == l_True){
+                //already known to be satisfiable, but the primary solver still has to produce the model
+                return solveCube(primary, assumps, cube_list[i]);
+            }
+        }
+        bool all_refuted = true;
+        for(lbool s:cube_status){
+            if(s != l_False){
+                all_refuted = false;
+            }
+        }
+        if(all_refuted){
+            //Every cube (if there are any) was refuted previously, so the instance is UNSAT under these assumptions;
+            //solve directly to obtain a conflict clause in terms of the assumptions (usually with little search).
+            return primary.solveLimited(assumps);
+        }
+
+        assumptions = &assumps;
+        cubes = &cube_list;
+        status = &cube_status;
+        next_cube = 0;
+        ClauseExchange shared;
+        exchange = &shared;
+        for(Solver* S:solvers){
+            S->clause_exchange = exchange;
+            S->exchange_id = exchange->addReader();
+        }
+        std::vector<std::thread> threads;
+        for(int i = 1; i < solvers.size(); i++){
+            threads.emplace_back(&CubeAndConquer::run, this, i);
+        }
+        run(0);
+        for(std::thread& t:threads){
+            t.join();
+        }
+        if(winner < 0 && !error && cube_status.contains(l_Undef)){
+            //some copies could not solve their cubes (see run()), so solve any that remain in the primary solver
+            next_cube = 0;
+            run(0);
+        }
+        for(Solver* S:solvers){
+            S->clause_exchange = nullptr;
+            S->exchange_id = -1;
+            S->clearInterrupt();
+        }
+        exchange = nullptr;
+        assumptions = nullptr;
+        cubes = nullptr;
+        status = nullptr;
+        if(error){
+            std::rethrow_exception(error);
+        }
+        if(winner < 0){
+            //Every cube is unsat. The conflicts of the refuted cubes don't account for the branches that were pruned
+            //while generating the cubes (failed literals, and refuted sub-cubes), so they can't be combined into a
+            //conflict clause; instead, solve directly under the assumptions alone to obtain one (this is usually
+            //quick, with the clauses learnt while solving the cubes).
+            result = l_False;
+            if(assumps.size() > 0){
+                result = primary.solveLimited(assumps);
+                if(result == l_Undef){
+                    //out of budget: the negation of all the assumptions is still a valid (if weak) conflict clause
+                    result = l_False;
+                    primary.conflict.clear();
+                    for(Lit l:assumps){
+                        primary.conflict.insert(~l);
+                    }
+                }
+            }else{
+                primary.conflict.clear();
+            }
+        }else if(winner > 0 && result != l_Undef){
+            result = Portfolio::transferResult(*solvers[winner], primary, assumps, result);
+        }
+        if(primary.verbosity >= 1){
+            if(winning_cube >= 0){
+                printf("Cube-and-conquer: cube %d (of %d) is satisfiable\n", winning_cube, cube_list.size());
+            }else if(result == l_False){
+                printf("Cube-and-conquer: all %d cubes are unsatisfiable\n", cube_list.size());
+            }
+        }
+        return result;
+    }
+
+private:
+    static bool mapLits(Solver& from, Solver& to, const vec<Lit>& lits, vec<Lit>& out){
+        for(Lit l:lits){
+            Lit m = (&from == &to) ? l : to.getMappedInternalLit(from.getMappedExternalLit(l));
+            if(m == lit_Undef){
+                return false;
+            }
+            out.push(m);
+        }
+        return true;
+    }
+
+    static lbool solveCube(Solver& S, const vec<Lit>& assumps, const vec<Lit>& cube){
+        vec<Lit> cube_assumps;
+        assumps.copyTo(cube_assumps);
+        for(Lit l:cube){
+            cube_assumps.push(l);
+        }
+        return S.solveLimited(cube_assumps);
+    }
+
+    void run(int i){
+        Solver& primary = *solvers[0];
+        Solver& S = *solvers[i];
+        vec<Lit> assumps;
+        if(!mapLits(primary, S, *assumptions, assumps)){
+            return;//this copy cannot represent the assumptions; the primary solver will pick up any cubes left unsolved
+        }
+        vec<Lit> cube_assumps;
+        try{
+            while(!exchange->isStopped()){
+                int c = next_cube++;
+                if(c >= cubes->size()){
+                    break;
+                }
+                if((*status)[c] != l_Undef){
+                    continue;
+                }
+                cube_assumps.clear();
+                assumps.copyTo(cube_assumps);
+                if(!mapLits(primary, S, (*cubes)[c], cube_assumps)){
+                    return;
+                }
+                lbool r = S.solveLimited(cube_assumps);
+                std::lock_guard<std::mutex> lock(result_mutex);
+                if(r == l_True){
+                    (*status)[c] = l_True;
+                    winning_cube = c;
+                    finish(i, r);
+                }else if(r == l_False){
+                    (*status)[c] = l_False;
+                    if(refutedByAssumptions(S, assumps)){
+                        assumptions_conflict = true;
+                        //the assumptions alone are unsat, so there is no need to solve the remaining cubes
+                        finish(i, r);
+                    }
+                }else if(i == 0){
+                    //Only the primary solver's budget (or an interrupt from the user) can end the search early
+                    finish(i, r);
+                }else{
+                    //This copy was interrupted (or ran out of budget); any cube it leaves unsolved is picked up by
+                    //the other solvers, or by the primary solver once they finish (see solve())
+                    break;
+                }
+            }
+        }catch(...){
+            std::lock_guard<std::mutex> lock(result_mutex);
+            if(!error){
+                error = std::current_exception();
+            }
+            finish(i, l_Undef);
+        }
+    }
+
+    //True if solver S's conflict clause (after refuting a cube) involves only the assumptions, and not the cube.
+    static bool refutedByAssumptions(Solver& S, const vec<Lit>& assumps){
+        for(Lit l:S.conflict){
+            if(!assumps.contains(~l)){
+                return false;
+            }
+        }
+        return true;
+    }
+
+    //Must be called while holding result_mutex.
+    void finish(int i, lbool r){
+        if(winner >= 0){
+            return;
+        }
+        winner = i;
+        result = r;
+        exchange->stop();
+        for(int j = 0; j < solvers.size(); j++){
+            if(j != i){
+                solvers[j]->interrupt();
+            }
+        }
+    }
+};
+
+}
+
+#endif //MONOSAT_CUBEANDCONQUER_H
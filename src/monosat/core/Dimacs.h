@@ -260,9 +260,10 @@ private:
     bool readLine(vec<char>& linebuf, B& in){
         linebuf.clear();
         for(;;){
-            if(isEof(in))
+            if(isEof(in)){
+                linebuf.push(0);
                 return false;
-            else if(*in == '\n'){
+            }else if(*in == '\n'){
                 linebuf.push(*in);
                 ++in;
                 break;
@@ -305,12 +306,15 @@ private:
                     S.addClause_(lits);
                     continue;
                 }
-                if(*in == 'c'){
-                    skipLine(in);
-                    continue;//comment
-                }
                 readLine(linebuf, in);
                 char* b = linebuf.begin();
+                if(*b == 'c'){
+                    //a comment, unless this is a connected_component_count_lt constraint
+                    char* c = b;
+                    if(!match(c, "connected_component")){
+                        continue;
+                    }
+                }
                 if(match(b, "solve")){
                     int parsed_lit, var;
                     lits.clear();
@@ -1336,7 +1336,7 @@ lbool optimize_and_solve(SimpSolver& S, const vec<Lit>& assumes, const vec<Objec
     vec<int64_t> model_vals;
     for(Lit l:assumes)
         assume.push(l);
-    static int solve_runs = 0;
+    static thread_local int solve_runs = 0;
     found_optimal = true;
     solve_runs++;
     if(opt_verb >= 1 || opt_verb_optimize >= 1){
@@ -1709,7 +1709,7 @@ lbool optimize_and_solve(SimpSolver& S, const vec<Lit>& assumes, const vec<Objec
 //Returns l_Undef if solve time constraints prevent the assumptions from being reduced to a provably locally minimal unsat core
 lbool minimizeCore(SimpSolver& S, vec<Lit>& assumptions, bool do_simp){
 
-    static int solve_runs = 0;
+    static thread_local int solve_runs = 0;
     solve_runs++;
     if(opt_verb >= 1 || opt_verb_optimize >= 1){
         if(solve_runs > 1){
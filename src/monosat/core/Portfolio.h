@@ -0,0 +1,283 @@
+/**************************************************************************************************
+ The MIT License (MIT)
+
+ Copyright (c) 2019, Sam Bayless
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef MONOSAT_PORTFOLIO_H
+#define MONOSAT_PORTFOLIO_H
+
+#include "monosat/core/Solver.h"
+#include "monosat/core/SolverTypes.h"
+#include "monosat/core/Config.h"
+#include "monosat/mtl/Vec.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <exception>
+#include <vector>
+
+namespace Monosat {
+
+/**
+ * A pool of short learnt clauses (and units), exported by the solvers of a portfolio.
+ * Clauses are stored in the external (input) variable numbering, because each solver in the portfolio is an
+ * independently constructed copy of the same instance, and their internal variable numberings may differ.
+ */
+class ClauseExchange {
+    std::mutex mutex;
+    vec<vec<Lit>> clauses;
+    vec<int> sources;//the solver that exported each clause
+    vec<int> read_pos;//for each reader, the position of the next clause it has not yet read (relative to 'offset')
+    int offset = 0;//number of clauses that have been discarded from the front of the pool
+    std::atomic<bool> stopped;
+public:
+    ClauseExchange() : stopped(false){
+    }
+
+    int addReader(){
+        std::lock_guard<std::mutex> lock(mutex);
+        read_pos.push(offset + clauses.size());
+        return read_pos.size() - 1;
+    }
+
+    void publish(int source, const vec<Lit>& clause){
+        std::lock_guard<std::mutex> lock(mutex);
+        clauses.push();
+        clause.copyTo(clauses.last());
+        sources.push(source);
+    }
+
+    //Copy all clauses that reader has not yet seen (and that were exported by other solvers) into 'out'.
+    void collect(int reader, vec<vec<Lit>>& out){
+        std::lock_guard<std::mutex> lock(mutex);
+        for(int i = read_pos[reader] - offset; i < clauses.size(); i++){
+            if(sources[i] != reader){
+                out.push();
+                clauses[i].copyTo(out.last());
+            }
+        }
+        read_pos[reader] = offset + clauses.size();
+
+        //discard clauses that every reader has already collected
+        int min_pos = read_pos[0];
+        for(int pos:read_pos){
+            min_pos = std::min(min_pos, pos);
+        }
+        int n_discard = min_pos - offset;
+        if(n_discard > 0 && n_discard >= clauses.size() / 2){
+            int j = 0;
+            for(int i = n_discard; i < clauses.size(); i++, j++){
+                clauses[i].moveTo(clauses[j]);
+                sources[j] = sources[i];
+            }
+            clauses.shrink(clauses.size() - j);
+            sources.shrink(sources.size() - j);
+            offset = min_pos;
+        }
+    }
+
+    //Signal all solvers in the portfolio that an answer has been found.
+    void stop(){
+        stopped = true;
+    }
+
+    bool isStopped() const{
+        return stopped;
+    }
+};
+
+/**
+ * Runs several independently constructed copies of the same instance in parallel, each in its own thread, and returns
+ * the first definite answer. The copies are diversified (random seeds, restart policies, theory decisions), and share
+ * short learnt clauses through a ClauseExchange.
+ *
+ * The first solver added is the 'primary' solver: when the portfolio returns, its model (or conflict clause)
+ * reflects the answer, regardless of which copy found it.
+ */
+class Portfolio {
+    vec<Solver*> solvers;
+    vec<vec<Lit>> assumptions;
+    ClauseExchange* exchange = nullptr;
+    std::mutex result_mutex;
+    lbool result = l_Undef;
+    int winner = -1;
+    std::exception_ptr error;
+
+public:
+    //Add a solver (and its own copy of the assumptions) to the portfolio. The first solver added is the primary solver.
+    void addSolver(Solver* S, const vec<Lit>& assumps){
+        solvers.push(S);
+        assumptions.push();
+        assumps.copyTo(assumptions.last());
+    }
+
+    int nSolvers() const{
+        return solvers.size();
+    }
+
+    //The index of the solver that produced the last answer, or -1 if no solver produced an answer.
+    int getWinner() const{
+        return winner;
+    }
+
+    lbool solve(){
+        result = l_Undef;
+        winner = -1;
+        error = nullptr;
+        if(solvers.size() == 0){
+            return l_Undef;
+        }
+        ClauseExchange shared;
+        exchange = &shared;
+        for(int i = 0; i < solvers.size(); i++){
+            if(i > 0){
+                diversify(*solvers[i], i);
+            }
+            solvers[i]->clause_exchange = exchange;
+            solvers[i]->exchange_id = exchange->addReader();
+        }
+        std::vector<std::thread> threads;
+        for(int i = 1; i < solvers.size(); i++){
+            threads.emplace_back(&Portfolio::run, this, i);
+        }
+        run(0);
+        for(std::thread& t:threads){
+            t.join();
+        }
+        for(Solver* S:solvers){
+            S->clause_exchange = nullptr;
+            S->exchange_id = -1;
+            S->clearInterrupt();
+        }
+        exchange = nullptr;
+        if(error){
+            std::rethrow_exception(error);
+        }
+        if(winner > 0 && result != l_Undef){
+            result = transferResult(*solvers[winner], *solvers[0], assumptions[0], result);
+        }
+        if(winner >= 0 && solvers[0]->verbosity >= 1){
+            printf("Portfolio: answer found by solver %d of %d\n", winner, solvers.size());
+        }
+        return result;
+    }
+
+    //Make the primary solver reflect the answer found by another copy of the instance.
+    static lbool transferResult(Solver& from, Solver& to, const vec<Lit>& assumps, lbool r){
+        if(r == l_False && from.conflict.size() == 0){
+            //the instance is unsat, independently of any assumptions
+            vec<Lit> empty;
+            to.cancelUntil(0);
+            to.addClause(empty);
+            to.conflict.clear();
+            return l_False;
+        }else if(r == l_False){
+            //unsat under the assumptions
+            to.conflict.clear();
+            for(int i = 0; i < from.conflict.size(); i++){
+                Lit l = to.getMappedInternalLit(from.getMappedExternalLit(from.conflict[i]));
+                if(l == lit_Undef){
+                    //fall back to solving in the primary solver directly (with all the shared clauses it has collected)
+                    return to.solveLimited(assumps);
+                }
+                to.conflict.insert(l);
+            }
+            return l_False;
+        }else{
+            //Replay the model of the winning copy as assumptions in the primary solver, so that
+            //the primary solver (and its theories) can produce a model, which requires little or no search.
+            vec<Lit> model_assumps;
+            assumps.copyTo(model_assumps);
+            for(Var v = 0; v < from.model.size(); v++){
+                if(from.model[v] == l_Undef)
+                    continue;
+                Lit l = to.getMappedInternalLit(from.getMappedExternalLit(mkLit(v, from.model[v] == l_False)));
+                if(l != lit_Undef && var(l) < to.nVars()){
+                    model_assumps.push(l);
+                }
+            }
+            r = to.solveLimited(model_assumps);
+            if(r != l_True){
+                r = to.solveLimited(assumps);
+            }
+            return r;
+        }
+    }
+
+private:
+    void run(int i){
+        Solver* S = solvers[i];
+        lbool r = l_Undef;
+        try{
+            r = S->solveLimited(assumptions[i]);
+        }catch(...){
+            std::lock_guard<std::mutex> lock(result_mutex);
+            if(!error){
+                error = std::current_exception();
+            }
+            r = l_Undef;
+            finish(i, r);
+            return;
+        }
+        //Only the primary solver's budget (or an interrupt from the user) can end the portfolio without an answer;
+        //the other solvers only return l_Undef once they have been stopped.
+        if(r != l_Undef || i == 0){
+            std::lock_guard<std::mutex> lock(result_mutex);
+            finish(i, r);
+        }
+    }
+
+    //Must be called while holding result_mutex.
+    void finish(int i, lbool r){
+        if(winner >= 0){
+            return;
+        }
+        winner = i;
+        result = r;
+        exchange->stop();
+        for(int j = 0; j < solvers.size(); j++){
+            if(j != i){
+                solvers[j]->interrupt();
+            }
+        }
+    }
+
+    //Vary the search parameters of each copy, so that they explore different parts of the search space.
+    static void diversify(Solver& S, int n){
+        S.random_seed = opt_random_seed + 7919.0 * n;
+        S.luby_restart = (n % 2 == 0) ? opt_luby_restart : !opt_luby_restart;
+        S.restart_first = std::max(1, (int) (opt_restart_first * ((n % 3 == 0) ? 1 : (n % 3 == 1) ? 0.5 : 2)));
+        S.rnd_init_act = (n % 4 >= 2);
+        S.random_var_freq = std::max((double) opt_random_var_freq, 0.005 * (n % 3));
+        if(opt_decide_theories){
+            //Theory decision heuristics are only constructed if -decide-theories is enabled,
+            //so they can be switched off for some of the copies, but not on.
+            S.decide_theories = (n % 2 == 0);
+        }
+        if(n % 3 == 2){
+            for(Var v = 0; v < S.nVars(); v++){
+                S.setPolarity(v, drand(S.random_seed) < 0.5);
+            }
+        }
+    }
+};
+
+}
+
+#endif //MONOSAT_PORTFOLIO_H
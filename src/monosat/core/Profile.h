@@ -0,0 +1,128 @@
+/**************************************************************************************************
+ The MIT License (MIT)
+
+ Copyright (c) 2019, Sam Bayless
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef MONOSAT_PROFILE_H
+#define MONOSAT_PROFILE_H
+
+#include "monosat/core/Config.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Monosat {
+
+/**
+ * Propagation counters for one theory, or for one part of a theory (such as a graph detector), reported as JSON by
+ * Solver::writeProfile(). Calls, propagations (literals implied), conflicts and reasons are always counted.
+ * Reading the clock costs more than most propagation calls, so wall-clock time is only measured for 1 in every
+ * '-profile-sample' calls; the reported times are scaled up by the number of calls.
+ */
+struct PropagationProfile {
+    uint64_t calls = 0;
+    uint64_t propagations = 0;
+    uint64_t conflicts = 0;
+    uint64_t reasons = 0;
+
+    uint64_t timed_calls = 0;
+    uint64_t timed_reasons = 0;
+    double timed_call_time = 0;//seconds
+    double timed_reason_time = 0;
+    uint64_t next_timed_call = 0;
+    uint64_t next_timed_reason = 0;
+
+    double callTime() const{
+        return timed_calls ? timed_call_time * ((double) calls / (double) timed_calls) : 0;
+    }
+
+    double reasonTime() const{
+        return timed_reasons ? timed_reason_time * ((double) reasons / (double) timed_reasons) : 0;
+    }
+
+    //Writes the counters as JSON object members (without the enclosing braces)
+    void writeJSON(std::ostream& out) const{
+        out << "\"calls\":" << calls << ",\"propagations\":" << propagations << ",\"conflicts\":" << conflicts
+            << ",\"time\":" << callTime() << ",\"reasons\":" << reasons << ",\"reason_time\":" << reasonTime();
+    }
+};
+
+/**
+ * Counts one propagation (or reason) call in a profile, and times it, if it is sampled, until it goes out of scope.
+ */
+class ProfileTimer {
+    double* total = nullptr;
+    std::chrono::steady_clock::time_point start;
+public:
+    enum Kind {
+        CALL, REASON
+    };
+
+    ProfileTimer(PropagationProfile& profile, Kind kind){
+        uint64_t& n = kind == CALL ? profile.calls : profile.reasons;
+        uint64_t& next = kind == CALL ? profile.next_timed_call : profile.next_timed_reason;
+        if(opt_profile_sample > 0 && n >= next){
+            next = n + opt_profile_sample;
+            if(kind == CALL){
+                profile.timed_calls++;
+                total = &profile.timed_call_time;
+            }else{
+                profile.timed_reasons++;
+                total = &profile.timed_reason_time;
+            }
+            start = std::chrono::steady_clock::now();
+        }
+        n++;
+    }
+
+    ~ProfileTimer(){
+        if(total){
+            *total += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+    }
+};
+
+//A named part of a theory (such as a graph detector) with its own propagation profile (see Theory::getProfiles)
+struct ProfilePart {
+    std::string name;
+    const PropagationProfile* profile;
+};
+
+static inline void writeJSONString(std::ostream& out, const std::string& s){
+    out << '"';
+    for(char c:s){
+        if(c == '"' || c == '\\'){
+            out << '\\' << c;
+        }else if((unsigned char) c < 0x20){
+            char buf[8];
+            snprintf(buf, sizeof(buf), "\\u%04x", (unsigned) c);
+            out << buf;
+        }else{
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+}
+
+#endif
@@ -26,6 +26,8 @@
 #include <algorithm>
 #include "monosat/mtl/Sort.h"
 #include "monosat/graph/GraphTheory.h"
+#include "monosat/core/Remap.h"
+#include "monosat/core/Portfolio.h"
 #include <ctype.h>
 
 using namespace Monosat;
@@ -37,7 +39,7 @@ using namespace Monosat;
 // Collected in Config.h
 //=================================================================================================
 // Constructor/Destructor:
-bool Solver::shown_warning = false;
+thread_local bool Solver::shown_warning = false;
 
 Solver::Solver() :
 
@@ -46,7 +48,8 @@ Solver::Solver() :
         verbosity(opt_verb), var_decay(opt_var_decay), clause_decay(opt_clause_decay), theory_decay(opt_var_decay),
         random_var_freq(
                 opt_random_var_freq), random_seed(opt_random_seed), luby_restart(opt_luby_restart), ccmin_mode(
-        opt_ccmin_mode), phase_saving(opt_phase_saving), rnd_pol(false), rnd_init_act(opt_rnd_init_act), garbage_frac(
+        opt_ccmin_mode), phase_saving(opt_phase_saving), rnd_pol(false), rnd_init_act(opt_rnd_init_act), decide_theories(
+        opt_decide_theories), garbage_frac(
         opt_garbage_frac), restart_first(opt_restart_first), restart_inc(opt_restart_inc)
 
         // Parameters (the rest):
@@ -63,7 +66,7 @@ Solver::Solver() :
         0), stats_pure_theory_lits(0), pure_literal_detections(0), stats_removed_clauses(0), dec_vars(0),
         clauses_literals(
                 0), learnts_literals(0), max_literals(0), tot_literals(0), stats_pure_lit_time(0), ok(
-        true), cla_inc(1), var_inc(1), theory_inc(1), watches(WatcherDeleted(ca)), qhead(0), simpDB_assigns(-1),
+        true), cla_inc(1), var_inc(1), theory_inc(1), watches(WatcherDeleted(ca)), watches_bin(WatcherDeleted(ca)), qhead(0), simpDB_assigns(-1),
         simpDB_props(
                 0), order_heap(VarOrderLt(activity, priority)), theory_order_heap(HeuristicOrderLt(), HeuristicToInt()),
         progress_estimate(0), remove_satisfied(true) //lazy_heap( LazyLevelLt(this)),
@@ -112,6 +115,8 @@ Var Solver::newVar(bool sign, bool dvar){
     }
     watches.init(mkLit(v, false));
     watches.init(mkLit(v, true));
+    watches_bin.init(mkLit(v, false));
+    watches_bin.init(mkLit(v, true));
     assigns[v] = l_Undef;
     vardata[v] = mkVarData(CRef_Undef, 0);
     int p = 0;
@@ -380,8 +385,9 @@ void Solver::attachClause(CRef cr){
             }
         }
 #endif
-    watches[~c[0]].push(Watcher(cr, c[1]));
-    watches[~c[1]].push(Watcher(cr, c[0]));
+    OccLists<Lit, vec<Watcher>, WatcherDeleted>& ws = c.size() == 2 ? watches_bin : watches;
+    ws[~c[0]].push(Watcher(cr, c[1]));
+    ws[~c[1]].push(Watcher(cr, c[0]));
     if(c.learnt())
         learnts_literals += c.size();
     else
@@ -392,13 +398,14 @@ void Solver::detachClause(CRef cr, bool strict){
     const Clause& c = ca[cr];
     assert(c.size() > 1);
 
+    OccLists<Lit, vec<Watcher>, WatcherDeleted>& ws = c.size() == 2 ? watches_bin : watches;
     if(strict){
-        remove(watches[~c[0]], Watcher(cr, c[1]));
-        remove(watches[~c[1]], Watcher(cr, c[0]));
+        remove(ws[~c[0]], Watcher(cr, c[1]));
+        remove(ws[~c[1]], Watcher(cr, c[0]));
     }else{
         // Lazy detaching: (NOTE! Must clean all watcher lists before garbage collecting this clause)
-        watches.smudge(~c[0]);
-        watches.smudge(~c[1]);
+        ws.smudge(~c[0]);
+        ws.smudge(~c[1]);
     }
 
     if(c.learnt())
@@ -412,8 +419,9 @@ void Solver::removeClause(CRef cr){
     Clause& c = ca[cr];
     detachClause(cr);
     // Don't leave pointers to free'd memory!
-    if(locked(c))
-        vardata[var(c[0])].reason = CRef_Undef;
+    Var locked_var = lockedVar(c);
+    if(locked_var != var_Undef)
+        vardata[locked_var].reason = CRef_Undef;
     c.mark(1);
     ca.free(cr);
 }
@@ -694,6 +702,8 @@ void Solver::analyzeHeuristicDecisions(CRef confl, IntSet<int>& conflicting_heur
         if(confl != CRef_Undef){
             assert(!isTheoryCause(confl));
             Clause& c = ca[confl];
+            if(p != lit_Undef && c.size() == 2 && c[0] != p)
+                std::swap(c[0], c[1]);
 
             for(int j = (p == lit_Undef) ? 0 : 1; j < c.size(); j++){
                 Lit q = c[j];
@@ -839,9 +849,13 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel){
         if(confl != CRef_Undef){
             assert(!isTheoryCause(confl));
             Clause& c = ca[confl];
+            if(p != lit_Undef && c.size() == 2 && c[0] != p)
+                std::swap(c[0], c[1]);
 
-            if(c.learnt())
+            if(c.learnt()){
                 claBumpActivity(c);
+                updateLearntTier(c);
+            }
 
             for(int j = (p == lit_Undef) ? 0 : 1; j < c.size(); j++){
                 Lit q = c[j];
@@ -938,7 +952,7 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel){
             if(reason(x) == CRef_Undef)
                 out_learnt[j++] = out_learnt[i];
             else{
-                Clause& c = ca[reason(var(out_learnt[i]))];
+                Clause& c = reasonClause(x);
                 for(int k = 1; k < c.size(); k++)
                     if(!seen[var(c[k])] && level(var(c[k])) > 0){
                         out_learnt[j++] = out_learnt[i];
@@ -1000,7 +1014,7 @@ bool Solver::litRedundant(Lit p, uint32_t abstract_levels){
             return false;
         }
 
-        Clause& c = ca[reason(var(analyze_stack.last()))];
+        Clause& c = reasonClause(var(analyze_stack.last()));
         analyze_stack.pop();
 
         for(int i = 1; i < c.size(); i++){
@@ -1056,7 +1070,7 @@ void Solver::analyzeFinal(Lit p, vec<Lit>& out_conflict){
                     //note that this is NOT an assumption; it is really a theory implication that should be at level 0
                 }else{
 
-                    Clause& c = ca[reason(x)];
+                    Clause& c = reasonClause(x);
                     assert(var(c[0]) == x);
                     for(int j = 1; j < c.size(); j++)
                         if(level(var(c[j])) > 0)
@@ -1368,6 +1382,7 @@ CRef Solver::propagate(bool propagate_theories){
     int num_props = 0;
     int initial_qhead = qhead;
     watches.cleanAll();
+    watches_bin.cleanAll();
     if(decisionLevel() == 0 && !propagate_theories){
         initialPropagate = true;//we will need to propagate this assignment to the theories at some point in the future.
     }
@@ -1375,10 +1390,25 @@ CRef Solver::propagate(bool propagate_theories){
 
         while(qhead < trail.size()){
             Lit p = trail[qhead++];     // 'p' is enqueued fact to propagate.
+            num_props++;
+
+            // Binary clauses first; the implied literal is stored in the watcher, so the clause is not inspected:
+            vec<Watcher>& wbin = watches_bin[p];
+            for(int k = 0; k < wbin.size(); k++){
+                Lit imp = wbin[k].blocker;
+                if(value(imp) == l_Undef){
+                    uncheckedEnqueue(imp, wbin[k].cref);
+                }else if(value(imp) == l_False){
+                    confl = wbin[k].cref;
+                    qhead = trail.size();
+                    break;
+                }
+            }
+            if(confl != CRef_Undef)
+                break;
 
             vec<Watcher>& ws = watches[p];
             Watcher* i, * j, * end;
-            num_props++;
             for(i = j = (Watcher*) ws, end = i + ws.size(); i != end;){
                 // Try to avoid inspecting the clause:
                 Lit blocker = i->blocker;
@@ -1439,13 +1469,6 @@ CRef Solver::propagate(bool propagate_theories){
             }
             initialPropagate = false;
         }
-        static int iter = 0;
-        if(++iter == 36){
-
-            int a = 1;
-        }
-        //printf("iter %d\n",iter);
-        //printf("iter %d\n",iter);
         //propagate theories;
 
         while(qhead == trail.size() && confl == CRef_Undef &&
@@ -1526,8 +1549,18 @@ bool Solver::propagateTheorySolver(int theoryID, CRef& confl, vec<Lit>& theory_c
     theory_conflict.clear();
     //todo: ensure that the bv theory comes first, as otherwise dependent theories may have to be propagated twice...
 
-
-    if(!theories[theoryID]->propagateTheory(theory_conflict)){
+    PropagationProfile& profile = theory_profiles[theoryID];
+    int trail_size = trail.size();
+    bool propagated;
+    {
+        ProfileTimer timer(profile, ProfileTimer::CALL);
+        propagated = theories[theoryID]->propagateTheory(theory_conflict);
+    }
+    if(trail.size() > trail_size){
+        profile.propagations += trail.size() - trail_size;
+    }
+    if(!propagated){
+        profile.conflicts++;
         bool has_conflict = true;
 #ifdef DEBUG_CORE
         for(Lit l:theory_conflict)
@@ -1548,6 +1581,32 @@ bool Solver::propagateTheorySolver(int theoryID, CRef& confl, vec<Lit>& theory_c
     return true;
 }
 
+void Solver::writeProfile(std::ostream& out){
+    std::vector<ProfilePart> parts;
+    out << "{\"sample\":" << (int) opt_profile_sample << ",\"theories\":[";
+    for(int i = 0; i < theories.size(); i++){
+        Theory* t = theories[i];
+        out << (i > 0 ? "," : "") << "{\"id\":" << i << ",\"type\":";
+        writeJSONString(out, t->getTheoryType());
+        out << ",\"name\":";
+        writeJSONString(out, t->getName());
+        out << ",";
+        theory_profiles[i].writeJSON(out);
+        out << ",\"parts\":[";
+        parts.clear();
+        t->getProfiles(parts);
+        for(int j = 0; j < parts.size(); j++){
+            out << (j > 0 ? "," : "") << "{\"name\":";
+            writeJSONString(out, parts[j].name);
+            out << ",";
+            parts[j].profile->writeJSON(out);
+            out << "}";
+        }
+        out << "]}";
+    }
+    out << "]}";
+}
+
 /*_________________________________________________________________________________________________
  |
  |  reduceDB : ()  ->  [void]
@@ -1555,6 +1614,10 @@ bool Solver::propagateTheorySolver(int theoryID, CRef& confl, vec<Lit>& theory_c
  |  Description:
  |    Remove half of the learnt clauses, minus the clauses locked by the current assignment. Locked
  |    clauses are clauses that are reason to some assignment. Binary clauses are never removed.
+ |
+ |    If -lbd-tiers is enabled, only clauses in the local tier are removed (by activity, as above).
+ |    Core clauses are kept permanently; tier2 clauses are kept for as long as they keep participating
+ |    in conflict analysis, and are otherwise demoted to the local tier.
  |________________________________________________________________________________________________@*/
 struct reduceDB_lt {
     ClauseAllocator& ca;
@@ -1568,8 +1631,95 @@ struct reduceDB_lt {
     }
 };
 
+//Orders local clauses before tier2 clauses before core clauses, and each tier as reduceDB_lt.
+struct reduceDB_tier_lt {
+    ClauseAllocator& ca;
+
+    reduceDB_tier_lt(ClauseAllocator& ca_) :
+            ca(ca_){
+    }
+
+    bool operator()(CRef x, CRef y){
+        if(ca[x].tier() != ca[y].tier())
+            return ca[x].tier() > ca[y].tier();
+        return reduceDB_lt(ca)(x, y);
+    }
+};
+
+void Solver::initLearntTier(Clause& c, int lbd){
+    assert(c.learnt());
+    c.setLBD(lbd);
+    c.setTier(TIER_LOCAL);
+    if(!opt_lbd_tiers)
+        return;
+    int tier2_lim = c.derivedClause() ? opt_lbd_theory_tier2 : opt_lbd_tier2;
+    if(lbd <= opt_lbd_core){
+        c.setTier(TIER_CORE);
+        n_protected_learnts++;
+    }else if(lbd <= tier2_lim){
+        c.setTier(TIER_2);
+        n_protected_learnts++;
+    }
+}
+
+void Solver::updateLearntTier(Clause& c){
+    if(!opt_lbd_tiers)
+        return;
+    c.setUsed(true);
+    if(c.tier() == TIER_CORE || c.lbd() <= opt_lbd_core)
+        return;
+    int lbd = computeLBD(c);
+    if(lbd < c.lbd()){
+        c.setLBD(lbd);
+        int tier2_lim = c.derivedClause() ? opt_lbd_theory_tier2 : opt_lbd_tier2;
+        LearntTier tier = lbd <= opt_lbd_core ? TIER_CORE : lbd <= tier2_lim ? TIER_2 : TIER_LOCAL;
+        if(tier < c.tier()){
+            if(c.tier() == TIER_LOCAL)
+                n_protected_learnts++;
+            c.setTier(tier);
+            stats_lbd_promotions++;
+        }
+    }
+}
+
+void Solver::countProtectedLearnts(){
+    n_protected_learnts = 0;
+    for(CRef cr:learnts){
+        if(ca[cr].tier() != TIER_LOCAL)
+            n_protected_learnts++;
+    }
+}
+
 void Solver::reduceDB(){
     int i, j;
+    if(opt_lbd_tiers){
+        int n_local = 0;
+        for(CRef cr:learnts){
+            Clause& c = ca[cr];
+            if(c.tier() == TIER_2 && !c.used()){
+                c.setTier(TIER_LOCAL);
+                stats_tier2_demotions++;
+            }
+            c.setUsed(false);
+            if(c.tier() == TIER_LOCAL)
+                n_local++;
+        }
+        sort(learnts, reduceDB_tier_lt(ca));
+        // Local clauses are at the front of learnts. Don't delete binary or locked clauses;
+        // from the rest, delete the first half of the local clauses:
+        for(i = j = 0; i < learnts.size(); i++){
+            Clause& c = ca[learnts[i]];
+            if(i < n_local / 2 && c.size() > 2 && !locked(c)){
+                stats_removed_clauses++;
+                removeClause(learnts[i]);
+            }else
+                learnts[j++] = learnts[i];
+        }
+        learnts.shrink(i - j);
+        countProtectedLearnts();
+        checkGarbage();
+        return;
+    }
     double extra_lim = cla_inc / learnts.size();    // Remove any clause below this activity
 
     sort(learnts, reduceDB_lt(ca));
@@ -1587,6 +1737,348 @@ void Solver::reduceDB(){
     checkGarbage();
 }
 
+/*_________________________________________________________________________________________________
+ |
+ |  reusedTrailLevel : ()  ->  [int]
+ |
+ |  Description:
+ |    The level to backtrack to on a restart. With -reuse-trail, this keeps the prefix of decisions
+ |    that VSIDS would re-decide in the same order (van der Tak, Ramos & Heule, 2011): every decision
+ |    that is more active than the next variable in the order heap. Because the theories are not
+ |    backtracked past the kept levels, they do not have to re-propagate them either.
+ |________________________________________________________________________________________________@*/
+int Solver::reusedTrailLevel(){
+    if(!opt_reuse_trail || S || initial_level > 0 || clause_exchange || decisionLevel() <= initial_level)
+        return initial_level;
+    //Level 0 must still be visited periodically, to simplify the clause database (and import shared clauses)
+    if(trail_lim[0] != simpDB_assigns || (opt_inprocess && conflicts >= next_inprocess))
+        return initial_level;
+    Var next = var_Undef;
+    while(!order_heap.empty()){
+        Var v = order_heap[0];
+        if(value(v) == l_Undef && decision[v]){
+            next = v;
+            break;
+        }
+        order_heap.removeMin();
+    }
+    if(next == var_Undef)
+        return initial_level;
+    int lev = 0;
+    while(lev < decisionLevel() && trail_lim[lev] < trail.size()){
+        Lit d = trail[trail_lim[lev]];
+        if(lev >= assumptions.size() && (d == theoryDecision || activity[var(d)] < activity[next]))
+            break;
+        lev++;
+    }
+    if(lev > 0){
+        stats_reused_trails++;
+        stats_reused_levels += lev;
+        int end = lev < decisionLevel() ? trail_lim[lev] : trail.size();
+        for(int i = trail_lim[0]; i < end; i++){
+            if(getNTheories(var(trail[i])) > 0)
+                stats_reused_theory_lits++;
+        }
+    }
+    return lev;
+}
+
+/*_________________________________________________________________________________________________
+ |
+ |  inprocess : ()  ->  [bool]
+ |
+ |  Description:
+ |    Simplify the clause database between restarts (at decision level 0):
+ |      - remove literals that are false at level 0 (including literals assigned by theory propagation),
+ |      - remove subsumed clauses, and strengthen clauses by self-subsuming resolution,
+ |      - vivify clauses, by propagating the negations of their literals one at a time.
+ |    The work done in each round is bounded by -inprocess-budget.
+ |
+ |    Problem clauses are only modified if 'remove_satisfied' is set (SimpSolver clears it while it
+ |    maintains occurrence lists for variable elimination). No variables are eliminated, so frozen
+ |    (and theory) variables are unaffected. Returns false if the solver is found to be unsatisfiable.
+ |________________________________________________________________________________________________@*/
+bool Solver::inprocess(){
+    assert(decisionLevel() == 0);
+    if(!ok || propagate(!disable_theories) != CRef_Undef || !ok)
+        return ok = false;
+    double start_time = rtime(1);
+    stats_inprocess_rounds++;
+    next_inprocess = conflicts + opt_inprocess_interval;
+    int64_t budget = opt_inprocess_budget;
+
+    if(nAssigns() != inprocess_assigns){
+        if(!strengthenLevel0(learnts) || (remove_satisfied && !strengthenLevel0(clauses)))
+            return ok = false;
+    }
+    if(ok)
+        subsumeClauses(budget);
+    if(ok && !asynch_interrupt)
+        vivifyClauses(learnts, vivify_learnt_pos, budget / 2);
+    if(ok && !asynch_interrupt && remove_satisfied)
+        vivifyClauses(clauses, vivify_clause_pos, budget / 2);
+
+    purgeRemovedClauses(learnts);
+    purgeRemovedClauses(clauses);
+    if(ok && (propagate(!disable_theories) != CRef_Undef || !ok))
+        ok = false;
+    inprocess_assigns = nAssigns();
+    countProtectedLearnts();
+    checkGarbage();
+    stats_inprocess_time += rtime(1) - start_time;
+    return ok;
+}
+
+//Replace the literals of clause cr, which must have been detached, with 'lits', dropping literals that are false at level 0.
+//If the result is satisfied, unit or empty, the clause is freed (and a unit is enqueued at level 0).
+bool Solver::replaceClauseLits(CRef cr, vec<Lit>& lits){
+    assert(decisionLevel() == 0);
+    int i, j;
+    bool sat = false;
+    for(i = j = 0; i < lits.size(); i++){
+        if(value(lits[i]) == l_True){
+            sat = true;
+            break;
+        }else if(value(lits[i]) == l_Undef){
+            lits[j++] = lits[i];
+        }
+    }
+    Clause& c = ca[cr];
+    if(sat || j < 2){
+        c.mark(1);
+        ca.free(cr);
+        if(sat)
+            return true;
+        else if(j == 0)
+            return ok = false;
+        uncheckedEnqueue(lits[0]);
+        return true;
+    }
+    assert(j <= c.size());
+    for(i = 0; i < j; i++)
+        c[i] = lits[i];
+    c.shrink(c.size() - j);
+    if(c.has_extra() && !c.learnt())
+        c.calcAbstraction();
+    attachClause(cr);
+    return true;
+}
+
+void Solver::purgeRemovedClauses(vec<CRef>& cs){
+    int i, j;
+    for(i = j = 0; i < cs.size(); i++){
+        if(ca[cs[i]].mark() != 1)
+            cs[j++] = cs[i];
+    }
+    cs.shrink(i - j);
+}
+
+bool Solver::strengthenLevel0(vec<CRef>& cs){
+    assert(decisionLevel() == 0);
+    for(int i = 0; i < cs.size() && ok; i++){
+        CRef cr = cs[i];
+        Clause& c = ca[cr];
+        if(c.mark() == 1 || locked(c))
+            continue;
+        int n_false = 0;
+        bool sat = false;
+        for(int j = 0; j < c.size(); j++){
+            if(value(c[j]) == l_False){
+                n_false++;
+            }else if(value(c[j]) == l_True){
+                sat = true;
+            }
+        }
+        if(n_false == 0 && !sat)
+            continue;
+        if(!sat)
+            stats_level0_removed_lits += n_false;
+        inprocess_lits.clear();
+        for(int j = 0; j < c.size(); j++)
+            inprocess_lits.push(c[j]);
+        detachClause(cr, true);
+        replaceClauseLits(cr, inprocess_lits);
+    }
+    return ok;
+}
+
+struct clause_size_lt {
+    ClauseAllocator& ca;
+
+    clause_size_lt(ClauseAllocator& ca_) :
+            ca(ca_){
+    }
+
+    bool operator()(CRef x, CRef y){
+        return ca[x].size() < ca[y].size();
+    }
+};
+
+bool Solver::subsumeClauses(int64_t budget){
+    assert(decisionLevel() == 0);
+    int64_t ticks = 0;
+    vec<CRef> cs;
+    for(CRef cr:learnts){
+        const Clause& c = ca[cr];
+        if(c.mark() != 1 && !satisfied(c))
+            cs.push(cr);
+    }
+    if(remove_satisfied){
+        for(CRef cr:clauses){
+            const Clause& c = ca[cr];
+            if(c.mark() != 1 && !satisfied(c))
+                cs.push(cr);
+        }
+    }
+    sort(cs, clause_size_lt(ca));
+    inprocess_occs.growTo(2 * nVars());
+    inprocess_marks.growTo(2 * nVars(), 0);
+    //Only the smallest clauses are indexed if the budget does not allow indexing all of them
+    int n_indexed = 0;
+    for(; n_indexed < cs.size() && ticks < budget / 2; n_indexed++){
+        const Clause& c = ca[cs[n_indexed]];
+        for(int i = 0; i < c.size(); i++)
+            inprocess_occs[toInt(c[i])].push(cs[n_indexed]);
+        ticks += c.size();
+    }
+
+    for(int n = 0; n < n_indexed && ticks < budget && ok && !asynch_interrupt; n++){
+        CRef cr = cs[n];
+        Clause& c = ca[cr];
+        if(c.mark() == 1)
+            continue;
+        //search the clauses containing the literal (in either polarity) with the fewest occurrences
+        Lit best = c[0];
+        for(int i = 1; i < c.size(); i++){
+            Lit l = c[i];
+            if(inprocess_occs[toInt(l)].size() + inprocess_occs[toInt(~l)].size() <
+               inprocess_occs[toInt(best)].size() + inprocess_occs[toInt(~best)].size())
+                best = l;
+        }
+        for(int i = 0; i < c.size(); i++)
+            inprocess_marks[toInt(c[i])] = 1;
+
+        for(Lit l:{best, ~best}){
+            for(CRef dr:inprocess_occs[toInt(l)]){
+                if(dr == cr || !ok)
+                    continue;
+                Clause& d = ca[dr];
+                if(d.mark() == 1 || d.size() < c.size())
+                    continue;
+                ticks += d.size();
+                int n_pos = 0, n_neg = 0;
+                Lit neg = lit_Undef;
+                for(int i = 0; i < d.size(); i++){
+                    if(inprocess_marks[toInt(d[i])]){
+                        n_pos++;
+                    }else if(inprocess_marks[toInt(~d[i])]){
+                        n_neg++;
+                        neg = d[i];
+                    }
+                }
+                if(n_pos == c.size()){
+                    //c subsumes d (but a learnt clause may not replace a problem clause)
+                    if(c.learnt() && !d.learnt())
+                        continue;
+                    if(c.learnt() && d.tier() < c.tier())
+                        c.setTier(d.tier());
+                    stats_subsumed_clauses++;
+                    removeClause(dr);
+                }else if(n_pos == c.size() - 1 && n_neg == 1){
+                    //self-subsuming resolution: resolving c and d on var(neg) produces d without neg
+                    stats_strengthened_clauses++;
+                    inprocess_lits.clear();
+                    for(int i = 0; i < d.size(); i++){
+                        if(d[i] != neg)
+                            inprocess_lits.push(d[i]);
+                    }
+                    detachClause(dr, true);
+                    replaceClauseLits(dr, inprocess_lits);
+                }
+            }
+        }
+        for(int i = 0; i < c.size(); i++)
+            inprocess_marks[toInt(c[i])] = 0;
+    }
+    for(int i = 0; i < inprocess_occs.size(); i++)
+        inprocess_occs[i].clear();
+    return ok;
+}
+
+bool Solver::vivifyClauses(vec<CRef>& cs, int& pos, int64_t budget){
+    //clauses learnt from conflicts during vivification are appended to learnts; they are not vivified in this round
+    int n = cs.size();
+    uint64_t limit = propagations + budget;
+    for(int k = 0; k < n && propagations < limit && ok && !asynch_interrupt; k++){
+        if(pos >= n)
+            pos = 0;
+        CRef cr = cs[pos++];
+        if(!vivifyClause(cr))
+            return false;
+    }
+    return ok;
+}
+
+//Shorten clause cr by asserting the negations of its literals, one at a time, and propagating:
+//if the negation of a prefix of the clause leads to a conflict, or implies another literal of the clause,
+//then the rest of the clause can be removed; literals that are implied false by the prefix can be dropped.
+bool Solver::vivifyClause(CRef cr){
+    assert(decisionLevel() == 0);
+    if(qhead < trail.size() && (propagate(!disable_theories) != CRef_Undef || !ok))
+        return ok = false;
+    {
+        const Clause& c = ca[cr];
+        if(c.mark() == 1 || c.size() <= 2 || locked(c) || satisfied(c))
+            return true;
+        inprocess_lits.clear();
+        for(int i = 0; i < c.size(); i++)
+            inprocess_lits.push(c[i]);
+    }
+    detachClause(cr, true);
+    //(propagation may allocate new clauses, so references into the clause allocator are not safe below)
+    vec<Lit>& lits = inprocess_lits;
+    int original_size = lits.size();
+    int i, n_kept = 0;
+    bool aborted = false;
+    for(i = 0; i < lits.size(); i++){
+        Lit l = lits[i];
+        if(value(l) == l_True){
+            lits[n_kept++] = l;
+            break;
+        }else if(value(l) == l_False){
+            continue;
+        }
+        lits[n_kept++] = l;
+        if(i == lits.size() - 1)
+            break;
+        int lev = decisionLevel();
+        newDecisionLevel();
+        uncheckedEnqueue(~l);
+        CRef confl = propagate(!disable_theories);
+        if(!ok)
+            return false;
+        if(decisionLevel() <= lev){
+            //propagation backjumped (a theory conflict produced an asserting clause), so give up on this clause,
+            //keeping only the literals dropped so far.
+            aborted = true;
+            break;
+        }
+        if(confl != CRef_Undef)
+            break;
+    }
+    cancelUntil(0);
+    if(aborted){
+        for(int j = i + 1; j < lits.size(); j++)
+            lits[n_kept++] = lits[j];
+    }
+    lits.shrink(lits.size() - n_kept);
+    if(n_kept < original_size){
+        stats_vivified_clauses++;
+        stats_vivified_lits += original_size - n_kept;
+    }
+    return replaceClauseLits(cr, lits);
+}
+
 void Solver::removeSatisfied(vec<CRef>& cs){
     int i, j;
     for(i = j = 0; i < cs.size(); i++){
@@ -1772,6 +2264,7 @@ bool Solver::simplify(){
 
     // Remove satisfied clauses:
     removeSatisfied(learnts);
+    countProtectedLearnts();
     if(remove_satisfied){        // Can be turned off.
         removeSatisfied(clauses);
 
@@ -1926,11 +2419,265 @@ void Solver::addClauseSafely(vec<Lit>& ps){
     }
 }
 
-bool Solver::addConflictClause(vec<Lit>& ps, CRef& confl_out, bool permanent){
-    static int nlearnt = 0;
-    if(++nlearnt == 111){
-        int a = 1;
+void Solver::exportLearntClause(const vec<Lit>& learnt_clause){
+    assert(clause_exchange);
+    add_tmp.clear();
+    for(Lit l:learnt_clause){
+        //Only clauses over variables that exist in every copy of the instance can be shared
+        //(for example, variables introduced internally by theory solvers cannot be shared)
+        Lit e = getMappedExternalLit(l);
+        if(e == lit_Undef){
+            return;
+        }
+        add_tmp.push(e);
+    }
+    clause_exchange->publish(exchange_id, add_tmp);
+    stats_exported_clauses++;
+}
+
+bool Solver::importSharedClauses(){
+    assert(clause_exchange);
+    assert(decisionLevel() == 0);
+    if(clause_exchange->isStopped()){
+        return false;
     }
+    static thread_local vec<vec<Lit>> shared;
+    shared.clear();
+    clause_exchange->collect(exchange_id, shared);
+    for(vec<Lit>& c:shared){
+        if(!ok){
+            break;
+        }
+        int i, j;
+        bool satisfied = false;
+        for(i = j = 0; i < c.size(); i++){
+            Lit l = getMappedInternalLit(c[i]);
+            if(l == lit_Undef || isEliminated(var(l))){
+                break;
+            }
+            if(value(l) == l_True){
+                satisfied = true;
+            }else if(value(l) == l_Undef){
+                c[j++] = l;
+            }
+        }
+        if(i < c.size() || satisfied){
+            continue;
+        }
+        c.shrink(i - j);
+        sort(c);
+        for(i = 1; i < c.size(); i++){
+            if(c[i] == ~c[i - 1]){
+                satisfied = true;//tautology
+            }
+        }
+        if(satisfied){
+            continue;
+        }
+        stats_imported_clauses++;
+        if(c.size() == 0){
+            ok = false;
+        }else if(c.size() == 1){
+            uncheckedEnqueue(c[0]);
+        }else{
+            CRef cr = ca.alloc(c, true);
+            learnts.push(cr);
+            //the levels of the exporting solver are not known here, so use the clause size as an upper bound on its LBD
+            initLearntTier(ca[cr], c.size());
+            attachClause(cr);
+            claBumpActivity(ca[cr]);
+        }
+    }
+    return true;
+}
+
+lbool Solver::generateCubes(const vec<Lit>& assumps, int depth, vec<vec<Lit>>& cubes){
+    cubes.clear();
+    cancelUntil(0);
+    if(!ok){
+        return l_False;
+    }
+    if(pbsolver){
+        pbsolver->convert();
+    }
+    //as in solve_(), ensure that any theory atoms that were created after their variable was assigned are enqueued
+    for(int i = 0; i < qhead; i++){
+        Lit p = trail[i];
+        for(int n = 0; n < getNTheories(var(p)); n++){
+            theories[getTheoryID(p, n)]->enqueueTheory(getTheoryLit(p, n));
+        }
+    }
+    if(propagate() != CRef_Undef){
+        ok = false;
+        return l_False;
+    }
+    vec<Lit> path;
+    assumps.copyTo(path);
+    if(!assignCube(path)){
+        //leave it to the conquer phase to find the (minimal) conflict
+        cancelUntil(0);
+        cubes.push();
+        return l_Undef;
+    }
+
+    //Only variables that are visible externally (and so exist in every copy of the instance) can appear in cubes.
+    //Theory atoms (such as edge literals) are preferred, then the most active variables.
+    vec<Var> candidates;
+    vec<Var> other_candidates;
+    for(Var v = 0; v < nVars(); v++){
+        if(value(v) != l_Undef || !isDecisionVar(v) || isEliminated(v) ||
+           getMappedExternalLit(mkLit(v)) == lit_Undef){
+            continue;
+        }
+        if(hasTheory(v)){
+            candidates.push(v);
+        }else{
+            other_candidates.push(v);
+        }
+    }
+    sort(candidates, VarOrderLt(activity, priority));
+    sort(other_candidates, VarOrderLt(activity, priority));
+    for(Var v:other_candidates){
+        candidates.push(v);
+    }
+    candidates.shrink(candidates.size() - std::min(candidates.size(), 2 * opt_cube_candidates));
+
+    bool refuted = !splitCube(depth, path, assumps.size(), candidates, cubes);
+    cancelUntil(0);
+    if(refuted){
+        cubes.clear();
+        if(assumps.size() == 0){
+            ok = false;
+        }
+        return l_False;
+    }
+    return l_Undef;
+}
+
+bool Solver::assignCube(const vec<Lit>& path){
+    //Note that propagation may backjump (if a theory conflict produces an asserting clause), so this
+    //loops until every literal of the path is assigned at its own level
+    while(decisionLevel() < path.size()){
+        Lit p = path[decisionLevel()];
+        if(value(p) == l_False){
+            return false;
+        }
+        newDecisionLevel();
+        if(value(p) == l_Undef){
+            uncheckedEnqueue(p);
+        }
+        if(propagate() != CRef_Undef){
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Solver::splitCube(int depth, vec<Lit>& path, int n_assumps, const vec<Var>& candidates, vec<vec<Lit>>& cubes){
+    int path_size = path.size();
+    Lit best = lit_Undef;
+    double best_score = -1;
+    bool refuted = !assignCube(path);
+    if(!refuted && depth > 0){
+        int n_evaluated = 0;
+        for(int i = 0; i < candidates.size() && n_evaluated < opt_cube_candidates && withinBudget(); i++){
+            Var v = candidates[i];
+            if(value(v) != l_Undef){
+                continue;
+            }
+            n_evaluated++;
+            double pos = lookahead(mkLit(v), path.size());
+            if(!assignCube(path)){
+                refuted = true;
+                break;
+            }else if(value(v) != l_Undef){
+                continue;
+            }
+            double neg = lookahead(~mkLit(v), path.size());
+            if(!assignCube(path)){
+                refuted = true;
+                break;
+            }else if(value(v) != l_Undef){
+                continue;
+            }
+            if(pos < 0 && neg < 0){
+                refuted = true;
+                break;
+            }else if(pos < 0 || neg < 0){
+                //failed literal: the other polarity is implied by the current path
+                stats_cube_failed_lits++;
+                Lit implied = pos < 0 ? ~mkLit(v) : mkLit(v);
+                if(path.size() == 0){
+                    //implied at level 0
+                    if(value(implied) == l_Undef){
+                        uncheckedEnqueue(implied);
+                    }
+                    refuted = value(implied) == l_False || propagate() != CRef_Undef;
+                }else{
+                    path.push(implied);
+                    refuted = !assignCube(path);
+                }
+                if(refuted){
+                    break;
+                }
+            }else{
+                double score = (pos + 1) * (neg + 1);
+                if(score > best_score){
+                    best_score = score;
+                    best = mkLit(v);
+                }
+            }
+        }
+        if(!refuted && best != lit_Undef && value(best) != l_Undef){
+            best = lit_Undef;//assigned by a later failed literal, so there is no need to branch on it
+        }
+    }
+    if(!refuted && best == lit_Undef){
+        //reached the maximum depth, or there is nothing left to branch on
+        cubes.push();
+        for(int i = n_assumps; i < path.size(); i++){
+            cubes.last().push(path[i]);
+        }
+    }else if(!refuted){
+        int n_refuted = 0;
+        int branch_size = path.size();
+        for(Lit l:{best, ~best}){
+            cancelUntil(std::min(decisionLevel(), branch_size));
+            path.push(l);
+            if(!splitCube(depth - 1, path, n_assumps, candidates, cubes)){
+                n_refuted++;
+            }
+            path.pop();
+        }
+        refuted = (n_refuted == 2);
+    }
+    cancelUntil(std::min(decisionLevel(), path_size));
+    path.shrink(path.size() - path_size);
+    return !refuted;
+}
+
+double Solver::lookahead(Lit l, int level){
+    assert(value(l) == l_Undef);
+    assert(decisionLevel() == level);
+    stats_cube_lookaheads++;
+    int start = trail.size();
+    newDecisionLevel();
+    uncheckedEnqueue(l);
+    bool failed = propagate() != CRef_Undef;
+    double score = 0;
+    if(decisionLevel() <= level){
+        //propagation backjumped past this lookahead (the caller will restore the trail),
+        //so neither the failure nor the score of l can be attributed to l alone.
+        return 0;
+    }
+    for(int i = start + 1; i < trail.size(); i++){
+        score += isTheoryCause(reason(var(trail[i]))) ? (double) opt_cube_theory_weight : 1;
+    }
+    cancelUntil(level);
+    return failed ? -1 : score;
+}
+
+bool Solver::addConflictClause(vec<Lit>& ps, CRef& confl_out, bool permanent){
     if(opt_write_learnt_clauses){
         if(++opt_n_learnts == 47){
             int a = 1;
@@ -2060,6 +2807,7 @@ bool Solver::addConflictClause(vec<Lit>& ps, CRef& confl_out, bool permanent){
                 clauses.push(cr);
             else{
                 learnts.push(cr);
+                initLearntTier(ca[cr], computeLBD(ps));
                 if(--learntsize_adjust_cnt <= 0){
                     learntsize_adjust_confl *= learntsize_adjust_inc;
                     learntsize_adjust_cnt = (int) learntsize_adjust_confl;
@@ -2132,9 +2880,8 @@ lbool Solver::search(int nof_conflicts){
     Heuristic* last_decision_heuristic = nullptr;
     bool decision_heuristic_changed = false;
     starts++;
-    static int decision_iter = 0;
-    bool using_theory_decisions = opt_decide_theories && drand(random_seed) < opt_random_theory_freq;
-    bool using_theory_order_heap = opt_decide_theories && (opt_theory_order_vsids || opt_theory_order_swapping) &&
+    bool using_theory_decisions = decide_theories && drand(random_seed) < opt_random_theory_freq;
+    bool using_theory_order_heap = decide_theories && (opt_theory_order_vsids || opt_theory_order_swapping) &&
                                    drand(random_seed) < opt_random_theory_order_freq;
 
     bool propagate_theories_during_assumptions = opt_theory_propagate_assumptions;
@@ -2146,10 +2893,6 @@ lbool Solver::search(int nof_conflicts){
     CRef confl = CRef_Undef;
     n_theory_decision_rounds += using_theory_decisions;
     for(;;){
-        static int iter = 0;
-        if(++iter == 33){//3150 //3144
-            int a = 1;
-        }
 
         propagate:
 
@@ -2227,6 +2970,7 @@ lbool Solver::search(int nof_conflicts){
                 return l_False;
             learnt_clause.clear();
             analyze(confl, learnt_clause, backtrack_level);
+            int learnt_lbd = computeLBD(learnt_clause);
 
             int lowest_conflicting_decision_level = decisionLevel();
             if(last_decision_heuristic && (!conflicting_heuristic || conflicting_heuristic->getPriority() <
@@ -2421,7 +3165,19 @@ lbool Solver::search(int nof_conflicts){
                 }
             }
 
-            cancelUntil(backtrack_level);
+            //Chronological backtracking (Nadel & Ryvchin, 2018): if the backjump would skip many levels, only backtrack
+            //one level, and assign the asserting literal at its (lower) implication level out of order.
+            //The theories then only need to undo a single level; literals from the skipped levels stay assigned.
+            bool chrono = opt_chrono >= 0 && !S && learnt_clause.size() > 1 &&
+                          conflicts > (uint64_t) opt_chrono_conflicts &&
+                          decisionLevel() - backtrack_level > opt_chrono;
+            if(chrono){
+                stats_chrono_backtracks++;
+                stats_chrono_levels_kept += decisionLevel() - 1 - backtrack_level;
+                cancelUntil(decisionLevel() - 1);
+            }else{
+                cancelUntil(backtrack_level);
+            }
 
             if(opt_theory_order_swapping && order_changed){
                 //rebuild the theory order queue
@@ -2432,16 +3188,25 @@ lbool Solver::search(int nof_conflicts){
             //this is now slightly more complicated, if there are multiple lits implied by the super solver in the current decision level:
             //The learnt clause may not be asserting.
 
+            if(clause_exchange && learnt_clause.size() <= opt_share_max_size){
+                exportLearntClause(learnt_clause);
+            }
+
             if(learnt_clause.size() == 1){
                 uncheckedEnqueue(learnt_clause[0]);
             }else{
                 CRef cr = ca.alloc(learnt_clause, true);
                 learnts.push(cr);
+                initLearntTier(ca[cr], learnt_lbd);
                 attachClause(cr);
                 claBumpActivity(ca[cr]);
 
                 if(value(learnt_clause[0]) == l_Undef){
-                    uncheckedEnqueue(learnt_clause[0], cr);
+                    if(chrono){
+                        enqueueLazy(learnt_clause[0], backtrack_level, cr);
+                    }else{
+                        uncheckedEnqueue(learnt_clause[0], cr);
+                    }
                 }else{
 
                     assert(S);
@@ -2624,7 +3389,7 @@ lbool Solver::search(int nof_conflicts){
             if((opt_restarts && (nof_conflicts >= 0 && conflictC >= nof_conflicts)) || !withinBudget()){
                 // Reached bound on number of conflicts:
                 progress_estimate = progressEstimate();
-                cancelUntil(initial_level);
+                cancelUntil(reusedTrailLevel());
                 return l_Undef;
             }
 
@@ -2632,7 +3397,11 @@ lbool Solver::search(int nof_conflicts){
             if(decisionLevel() == 0 && !simplify())
                 return l_False;
 
-            if(learnts.size() - nAssigns() >= max_learnts)
+            if(opt_inprocess && decisionLevel() == 0 && !S && !only_propagate_assumptions &&
+               conflicts >= next_inprocess && !inprocess())
+                return l_False;
+
+            if(learnts.size() - n_protected_learnts - nAssigns() >= max_learnts)
                 // Reduce the set of learnt clauses:
                 reduceDB();
             Heuristic* next_decision_heuristic = nullptr;
@@ -2675,7 +3444,7 @@ lbool Solver::search(int nof_conflicts){
             /**
              * Give the theory solvers a chance to make decisions
              */
-            if(opt_decide_theories && !disable_theories && using_theory_decisions && next == lit_Undef &&
+            if(decide_theories && !disable_theories && using_theory_decisions && next == lit_Undef &&
                (opt_theory_conflict_max == 0 || conflicts >= next_theory_decision)){
 
                 int next_var_priority = INT_MIN;
@@ -2694,7 +3463,6 @@ lbool Solver::search(int nof_conflicts){
                     while(next == lit_Undef && !theory_order_heap.empty() &&
                           theory_order_heap.peekMin()->getPriority() >= next_var_priority){
                         Heuristic* h = theory_order_heap.peekMin();
-                        ++decision_iter;
                         //int theoryID = h->getTheoryIndex();
                         if(!heuristicSatisfied(h)){
                             if(opt_vsids_both &&
@@ -2977,11 +3745,21 @@ lbool Solver::solve_(){
     while(status == l_Undef){
         double rest_base = luby_restart ? luby(restart_inc, curr_restarts) : pow(restart_inc, curr_restarts);
 
+        if(clause_exchange){
+            if(!importSharedClauses()){
+                break;//another solver in the portfolio has already found an answer
+            }
+            if(!ok){
+                status = l_False;
+                break;
+            }
+        }
+
         if(opt_rnd_phase){
             for(int i = 0; i < nVars(); i++)
                 polarity[i] = irand(random_seed, 1);
         }
-        if(opt_decide_theories){
+        if(decide_theories){
             if(opt_theory_order_conflict_restart && opt_theory_order_conflict_clear_on_restart){
                 theory_conflict_counters.clear();
                 theory_conflict_counters.growTo(all_decision_heuristics.size());
@@ -3056,6 +3834,10 @@ lbool Solver::solve_(){
             override_restart_count = -1;
         }
     }
+    if(status == l_Undef){
+        //search() may have kept part of the trail on its last restart
+        cancelUntil(0);
+    }
 
     if(status == l_True){
         model.growTo(nVars());
@@ -3231,6 +4013,327 @@ Lit Solver::mapLit(Lit l){
     }
 }
 
+Lit Solver::getMappedExternalLit(Lit l){
+    if(l == lit_Undef || var(l) >= nVars()){
+        return lit_Undef;
+    }
+    if(varRemap){
+        if(!varRemap->hasMappedVar(var(l))){
+            return lit_Undef;
+        }
+        return varRemap->unmap(l);
+    }else{
+        return l;
+    }
+}
+
+Lit Solver::getMappedInternalLit(Lit l){
+    if(l == lit_Undef){
+        return lit_Undef;
+    }
+    Var v = var(l);
+    if(varRemap){
+        v = varRemap->getVarFromExternalVar(v);
+    }
+    if(v == var_Undef || v >= nVars()){
+        return lit_Undef;
+    }
+    return mkLit(v, sign(l));
+}
+
+
+//=================================================================================================
+// Solver state files:
+//
+// Native-endian binary layout:
+//   uint32 magic, uint32 version
+//   double var_inc, cla_inc, theory_inc
+//   int32 n; then n x {int32 external var, double activity, int8 polarity}
+//   int32 n; then n x {double theory heuristic activity}, by heuristic index
+//   int32 n; then n x {uint32 external lit} (the level 0 assignment)
+//   int32 n; then n x {int32 size, int32 lbd, int32 tier, float activity, size x uint32 external lits}
+// Literals are stored as external literals, so that the file can be loaded into any solver built from the same
+// constraints (see getMappedExternalLit); variables without an external mapping are left out.
+
+static const uint32_t state_magic = 0x5453534d;// "MSST"
+static const uint32_t state_version = 1;
+
+namespace {
+struct StateFile {
+    FILE* f;
+    const char* filename;
+
+    template<class T>
+    void write(const T& t){
+        if(fwrite(&t, sizeof(T), 1, f) != 1){
+            fclose(f);
+            throw std::runtime_error(std::string("Failed to write solver state to ") + filename);
+        }
+    }
+
+    template<class T>
+    T read(){
+        T t;
+        if(fread(&t, sizeof(T), 1, f) != 1){
+            fclose(f);
+            throw std::runtime_error(std::string("Truncated or invalid solver state file ") + filename);
+        }
+        return t;
+    }
+
+    //Reads a count or size, which must not be negative.
+    int readCount(){
+        int32_t n = read<int32_t>();
+        if(n < 0){
+            invalid();
+        }
+        return n;
+    }
+
+    //Reads an (external) literal, as written by saveState().
+    Lit readLit(){
+        uint32_t l = read<uint32_t>();
+        if(l > INT32_MAX){
+            invalid();
+        }
+        return toLit(l);
+    }
+
+    void invalid(){
+        fclose(f);
+        throw std::runtime_error(std::string("Truncated or invalid solver state file ") + filename);
+    }
+};
+}
+
+void Solver::saveState(const char* filename){
+    StateFile out{fopen(filename, "wb"), filename};
+    if(!out.f){
+        throw std::runtime_error(std::string("Could not open ") + filename + " to write solver state");
+    }
+    out.write(state_magic);
+    out.write(state_version);
+    out.write(var_inc);
+    out.write(cla_inc);
+    out.write(theory_inc);
+
+    vec<Var> vars;
+    for(Var v = 0; v < nVars(); v++){
+        if(getMappedExternalLit(mkLit(v)) != lit_Undef){
+            vars.push(v);
+        }
+    }
+    out.write((int32_t) vars.size());
+    for(Var v:vars){
+        out.write((int32_t) var(getMappedExternalLit(mkLit(v))));
+        out.write(activity[v]);
+        out.write((int8_t) polarity[v]);
+    }
+
+    out.write((int32_t) all_decision_heuristics.size());
+    for(Heuristic* h:all_decision_heuristics){
+        out.write(h ? h->getActivity() : 0.0);
+    }
+
+    vec<Lit> units;
+    for(Lit l:trail){
+        Lit e = getMappedExternalLit(l);
+        if(level(var(l)) == 0 && e != lit_Undef){
+            units.push(e);
+        }
+    }
+    out.write((int32_t) units.size());
+    for(Lit l:units){
+        out.write((uint32_t) toInt(l));
+    }
+
+    vec<CRef> saved;
+    for(CRef cr:learnts){
+        const Clause& c = ca[cr];
+        if(c.mark() != 0){
+            continue;
+        }
+        bool mapped = true;
+        for(Lit l:c){
+            if(getMappedExternalLit(l) == lit_Undef){
+                mapped = false;
+                break;
+            }
+        }
+        if(mapped){
+            saved.push(cr);
+        }
+    }
+    out.write((int32_t) saved.size());
+    for(CRef cr:saved){
+        Clause& c = ca[cr];
+        out.write((int32_t) c.size());
+        out.write((int32_t) c.lbd());
+        out.write((int32_t) c.tier());
+        out.write(c.activity());
+        for(Lit l:c){
+            out.write((uint32_t) toInt(getMappedExternalLit(l)));
+        }
+    }
+    if(fclose(out.f) != 0){
+        throw std::runtime_error(std::string("Failed to write solver state to ") + filename);
+    }
+}
+
+/*_________________________________________________________________________________________________
+ |
+ |  loadState : (filename) ->  [bool]
+ |
+ |  Description:
+ |    Warm-starts the solver from a state file written by saveState(). Learnt clauses are allocated and
+ |    attached directly, rather than through addClause(); they are only filtered against the current
+ |    level 0 assignment, which the watch scheme requires.
+ |________________________________________________________________________________________________@*/
+bool Solver::loadState(const char* filename){
+    StateFile in{fopen(filename, "rb"), filename};
+    if(!in.f){
+        throw std::runtime_error(std::string("Could not open solver state file ") + filename);
+    }
+    if(in.read<uint32_t>() != state_magic || in.read<uint32_t>() != state_version){
+        fclose(in.f);
+        throw std::runtime_error(std::string("Not a solver state file (or written by an incompatible version): ") + filename);
+    }
+    //Read and validate the whole file before changing anything, so that a truncated or invalid file
+    //leaves the solver exactly as it was.
+    struct SavedVar {
+        int32_t v;
+        double act;
+        int8_t pol;
+    };
+    struct SavedLearnt {
+        int lbd;
+        int tier;
+        float act;
+        int start;//index of the first literal in learnt_lits
+        int size;
+    };
+    double saved_var_inc = in.read<double>();
+    double saved_cla_inc = in.read<double>();
+    double saved_theory_inc = in.read<double>();
+
+    vec<SavedVar> saved_vars;
+    int n = in.readCount();
+    for(int i = 0; i < n; i++){
+        SavedVar sv;
+        sv.v = in.read<int32_t>();
+        sv.act = in.read<double>();
+        sv.pol = in.read<int8_t>();
+        if(sv.v < 0){
+            in.invalid();
+        }
+        saved_vars.push(sv);
+    }
+
+    vec<double> heuristic_activities;
+    n = in.readCount();
+    for(int i = 0; i < n; i++){
+        heuristic_activities.push(in.read<double>());
+    }
+
+    vec<Lit> units;
+    n = in.readCount();
+    for(int i = 0; i < n; i++){
+        units.push(in.readLit());
+    }
+
+    vec<SavedLearnt> saved_learnts;
+    vec<Lit> learnt_lits;
+    n = in.readCount();
+    for(int i = 0; i < n; i++){
+        SavedLearnt sl;
+        sl.size = in.readCount();
+        sl.lbd = in.read<int32_t>();
+        sl.tier = in.read<int32_t>();
+        sl.act = in.read<float>();
+        sl.start = learnt_lits.size();
+        for(int j = 0; j < sl.size; j++){
+            learnt_lits.push(in.readLit());
+        }
+        saved_learnts.push(sl);
+    }
+    if(fgetc(in.f) != EOF){
+        in.invalid();
+    }
+    fclose(in.f);
+
+    cancelUntil(0);
+    var_inc = saved_var_inc;
+    cla_inc = saved_cla_inc;
+    theory_inc = saved_theory_inc;
+
+    for(const SavedVar& sv:saved_vars){
+        Lit l = getMappedInternalLit(mkLit(sv.v));
+        if(l != lit_Undef){
+            activity[var(l)] = sv.act;
+            polarity[var(l)] = sv.pol;
+            if(order_heap.inHeap(var(l)))
+                order_heap.update(var(l));
+        }
+    }
+
+    for(int i = 0; i < heuristic_activities.size() && i < all_decision_heuristics.size(); i++){
+        if(all_decision_heuristics[i]){
+            Heuristic* h = all_decision_heuristics[i];
+            h->setActivity(heuristic_activities[i]);
+            if(theory_order_heap.inHeap(h))
+                theory_order_heap.update(h);
+        }
+    }
+
+    for(Lit u:units){
+        Lit l = getMappedInternalLit(u);
+        if(!ok || l == lit_Undef || isEliminated(var(l))){
+            continue;
+        }
+        if(value(l) == l_False){
+            ok = false;
+        }else if(value(l) == l_Undef){
+            if(hasTheory(l)){
+                resetInitialPropagation();
+            }
+            uncheckedEnqueue(l);
+        }
+    }
+
+    vec<Lit> c;
+    for(const SavedLearnt& sl:saved_learnts){
+        c.clear();
+        bool skip = !ok;
+        for(int j = 0; j < sl.size; j++){
+            Lit l = getMappedInternalLit(learnt_lits[sl.start + j]);
+            if(l == lit_Undef || isEliminated(var(l)) || value(l) == l_True){
+                skip = true;
+            }else if(value(l) == l_Undef){
+                c.push(l);
+            }
+        }
+        if(skip){
+            continue;
+        }else if(c.size() == 0){
+            ok = false;
+        }else if(c.size() == 1){
+            uncheckedEnqueue(c[0]);
+        }else{
+            CRef cr = ca.alloc(c, true);
+            learnts.push(cr);
+            Clause& lc = ca[cr];
+            lc.setLBD(sl.lbd);
+            lc.setTier(opt_lbd_tiers && sl.tier >= TIER_CORE && sl.tier <= TIER_LOCAL ? (LearntTier) sl.tier : TIER_LOCAL);
+            lc.activity() = sl.act;
+            attachClause(cr);
+        }
+    }
+    countProtectedLearnts();
+    if(ok){
+        ok = propagate(false) == CRef_Undef;
+    }
+    return ok;
+}
 
 //=================================================================================================
 // Garbage Collection methods:
@@ -3265,6 +4368,7 @@ void Solver::relocAll(ClauseAllocator& to){
     //
     // for (int i = 0; i < watches.size(); i++)
     watches.cleanAll();
+    watches_bin.cleanAll();
     for(int v = 0; v < nVars(); v++){
 
         for(int s = 0; s < 2; s++){
@@ -3273,6 +4377,9 @@ void Solver::relocAll(ClauseAllocator& to){
             vec<Watcher>& ws = watches[p];
             for(int j = 0; j < ws.size(); j++)
                 ca.reloc(ws[j].cref, to);
+            vec<Watcher>& wbin = watches_bin[p];
+            for(int j = 0; j < wbin.size(); j++)
+                ca.reloc(wbin[j].cref, to);
         }
     }
     // All reasons:
@@ -3296,13 +4403,26 @@ void Solver::relocAll(ClauseAllocator& to){
 }
 
 void Solver::garbageCollect(){
+    if(ClauseAllocator::Stable_Memory){
+        // The clause arena never moves, so compact it in place rather than copying it into a new region
+        uint64_t old_size = ca.size();
+        ca.beginCompaction();
+        relocAll(ca);
+        ca.forwardCompaction();
+        relocAll(ca);
+        ca.endCompaction();
+        if(verbosity >= 2)
+            printf("|  Garbage collection:   %12" PRIu64 " bytes => %12" PRIu64 " bytes             |\n",
+                   old_size * ClauseAllocator::Unit_Size, (uint64_t) ca.size() * ClauseAllocator::Unit_Size);
+        return;
+    }
     // Initialize the next region to a size corresponding to the estimated utilization degree. This
     // is not precise but should avoid some unnecessary reallocations for the new region:
     ClauseAllocator to(ca.size() - ca.wasted());
     relocAll(to);
     if(verbosity >= 2)
-        printf("|  Garbage collection:   %12d bytes => %12d bytes             |\n",
-               ca.size() * ClauseAllocator::Unit_Size, to.size() * ClauseAllocator::Unit_Size);
+        printf("|  Garbage collection:   %12" PRIu64 " bytes => %12" PRIu64 " bytes             |\n",
+               (uint64_t) ca.size() * ClauseAllocator::Unit_Size, (uint64_t) to.size() * ClauseAllocator::Unit_Size);
     to.moveTo(ca);
 }
 
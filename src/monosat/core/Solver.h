@@ -39,6 +39,7 @@
 #include <sstream>
 #include <iostream>
 #include <vector>
+#include <atomic>
 
 namespace Monosat {
 template<typename Weight>
@@ -48,13 +49,15 @@ class FSMTheorySolver;
 
 class DimacsMap;
 
+class ClauseExchange;
+
 //=================================================================================================
 // Solver -- the main class:
 // The MiniSAT Boolean SAT solver, extended to provided basic SMT support.
 class Solver : public Theory, public TheorySolver {
 public:
     void* _external_data = nullptr;//convenience pointer for external API.
-    static bool shown_warning;
+    static thread_local bool shown_warning;
 
     //fix this...
     friend class Theory;
@@ -158,6 +161,7 @@ public:
         theories.push(t);
         theory_reprop_trail_pos.push(-1);
         theory_init_prop_trail_pos.push(-1);
+        theory_profiles.push();
         t->setTheoryIndex(theories.size() - 1);
         if(t->supportsDecisions()){
             addHeuristic(t);
@@ -280,6 +284,10 @@ public:
         return markers.last();
     }
 
+    //Write the propagation profile of each theory, and of the parts of each theory (such as graph detectors), as JSON.
+    //See PropagationProfile.
+    void writeProfile(std::ostream& out);
+
     void printStats(int detail_level = 0) override{
 
         double cpu_time = cpuTime();
@@ -297,9 +305,23 @@ public:
         printf("conflicts             : %-12" PRIu64 "   (%.0f /sec, %d learnts (%" PRId64 " theory learnts), %" PRId64 " removed)\n",
                conflicts,
                conflicts / cpu_time, learnts.size(), stats_theory_conflicts, stats_removed_clauses);
+        if(opt_lbd_tiers){
+            int tiers[3] = {0, 0, 0};
+            int theory_tiers[3] = {0, 0, 0};
+            for(CRef cr:learnts){
+                const Clause& c = ca[cr];
+                tiers[c.tier()]++;
+                if(c.derivedClause()){
+                    theory_tiers[c.tier()]++;
+                }
+            }
+            printf("learnt clause tiers   : %d core, %d tier2, %d local (theory learnts: %d core, %d tier2, %d local; %" PRIu64 " promoted, %" PRIu64 " demoted)\n",
+                   tiers[TIER_CORE], tiers[TIER_2], tiers[TIER_LOCAL], theory_tiers[TIER_CORE], theory_tiers[TIER_2],
+                   theory_tiers[TIER_LOCAL], stats_lbd_promotions, stats_tier2_demotions);
+        }
         printf("decisions             : %-12" PRIu64 "   (%4.2f %% random) (%.0f /sec)\n", decisions,
                (float) rnd_decisions * 100 / (float) decisions, decisions / cpu_time);
-        if(opt_decide_theories){
+        if(decide_theories){
             printf("Theory decisions: %" PRId64 "\n", stats_theory_decisions);
             printf("Theory decision rounds: %" PRId64 "/%" PRId64 "\n", n_theory_decision_rounds, starts);
         }
@@ -309,6 +331,27 @@ public:
         printf("propagations          : %-12" PRIu64 "   (%.0f /sec)\n", propagations, propagations / cpu_time);
         printf("conflict literals     : %-12" PRIu64 "   (%4.2f %% deleted)\n", tot_literals,
                (max_literals - tot_literals) * 100 / (double) max_literals);
+        if(stats_exported_clauses > 0 || stats_imported_clauses > 0){
+            printf("shared clauses        : %" PRIu64 " exported, %" PRIu64 " imported\n", stats_exported_clauses,
+                   stats_imported_clauses);
+        }
+        if(stats_chrono_backtracks > 0){
+            printf("chrono backtracks     : %" PRIu64 " (%" PRIu64 " decision levels kept)\n", stats_chrono_backtracks,
+                   stats_chrono_levels_kept);
+        }
+        if(stats_reused_trails > 0){
+            printf("reused trails         : %" PRIu64 " restarts (%" PRIu64 " decision levels kept, %" PRIu64 " theory literals not re-propagated)\n",
+                   stats_reused_trails, stats_reused_levels, stats_reused_theory_lits);
+        }
+        if(stats_inprocess_rounds > 0){
+            printf("inprocessing          : %" PRIu64 " rounds (%f time), %" PRIu64 " clauses vivified (%" PRIu64 " lits removed), %" PRIu64 " subsumed, %" PRIu64 " strengthened, %" PRIu64 " lits removed at level 0\n",
+                   stats_inprocess_rounds, stats_inprocess_time, stats_vivified_clauses, stats_vivified_lits,
+                   stats_subsumed_clauses, stats_strengthened_clauses, stats_level0_removed_lits);
+        }
+        if(stats_cube_lookaheads > 0){
+            printf("cube lookaheads       : %" PRIu64 " (%" PRIu64 " failed literals)\n", stats_cube_lookaheads,
+                   stats_cube_failed_lits);
+        }
         if(stats_skipped_theory_prop_rounds > 0){
             printf("theory propagations skipped: %" PRId64 "\n", stats_skipped_theory_prop_rounds);
         }
@@ -505,10 +548,6 @@ public:
 
     //Lazily construct a reason for a literal propagated from a theory
     CRef constructReason(Lit p){
-        static int iterp = 0;
-        if(++iterp == 45){
-            int a = 1;
-        }
         assert(value(p) == l_True);
         CRef cr = reason(var(p));
         assert(isTheoryCause(cr));
@@ -522,8 +561,10 @@ public:
         theory_reason.clear();
 
         double start_t = rtime(1);
-
-        t->buildReason(getTheoryLit(p, t), theory_reason, cr);
+        {
+            ProfileTimer timer(theory_profiles[t->getTheoryIndex()], ProfileTimer::REASON);
+            t->buildReason(getTheoryLit(p, t), theory_reason, cr);
+        }
 
         stats_theory_conflict_time += (rtime(1) - start_t);
         assert(theory_reason[0] == p);
@@ -535,7 +576,7 @@ public:
 #endif
 #ifdef DEBUG_SOLVER
         //assert all the other reasons in this cause are earlier on the trail than p...
-        static vec<bool> marks;
+        static thread_local vec<bool> marks;
         marks.clear();
         marks.growTo(nVars());
         for(int i = 0;i<trail.size() && var(trail[i])!=var(p);i++) {
@@ -595,6 +636,20 @@ public:
             const vec<Lit>& assumps); //apply unit propagation to the supplied assumptions, and quit without solving
     virtual lbool
     solveUntilRestart(const vec<Lit>& assumps);//attempt to solve the instance, but quit as soon as the solver restarts
+    //Split the search space under the given assumptions into up to 2^depth cubes (conjunctions of literals), for
+    //cube-and-conquer solving. Each split branches on the variable whose two polarities, tested by lookahead
+    //(unit and theory propagation), imply the most literals. Returns l_False (and no cubes) if lookahead refutes
+    //every branch, and l_Undef otherwise. If the assumptions already conflict, a single empty cube is returned.
+    lbool generateCubes(const vec<Lit>& assumps, int depth, vec<vec<Lit>>& cubes);
+    //Write the state that the solver has learnt (learnt clauses with their scores, variable and theory activities,
+    //saved phases, and the level 0 assignment, including the facts derived by theories) to a binary file.
+    //Throws std::runtime_error if the file cannot be written.
+    void saveState(const char* filename);
+    //Warm-start the solver from a file written by saveState(). The solver must already contain the same constraints
+    //(with the same variables) as the solver that saved it; learnt clauses over variables that no longer exist, or
+    //that have been eliminated, are skipped. Returns false if the solver is now known to be UNSAT.
+    //Throws std::runtime_error if the file cannot be read.
+    bool loadState(const char* filename);
     bool okay() const;                  // FALSE means solver is in a conflicting state
     void contradiction(){ //put the solver into a contradictory state
         ok = false;
@@ -633,6 +688,18 @@ public:
      */
     int nMappedVars();
 
+    //Returns the external literal corresponding to internal literal l, or lit_Undef if l has no external mapping.
+    //Unlike unmap(), this never creates a new mapping.
+    Lit getMappedExternalLit(Lit l);
+
+    //Returns the internal literal corresponding to external literal l, or lit_Undef if l is not mapped in this solver.
+    Lit getMappedInternalLit(Lit l);
+
+    //True if v has been removed from the solver by preprocessing (see SimpSolver)
+    virtual bool isEliminated(Var v) const{
+        return false;
+    }
+
     void setVarMap(DimacsMap* map){
         varRemap = map;
     }
@@ -806,6 +873,7 @@ public:
     IntSet<int> unskippable_theory_q;
     vec<int> theory_reprop_trail_pos;
     vec<int> theory_init_prop_trail_pos;
+    vec<PropagationProfile> theory_profiles;//indexed by theory
     bool disable_theories = false;
     int min_decision_var = 0;
     int max_decision_var = -1;
@@ -842,6 +910,7 @@ public:
     int phase_saving;       // Controls the level of phase saving (0=none, 1=limited, 2=full).
     bool rnd_pol;            // Use random polarities for branching heuristics.
     bool rnd_init_act;       // Initialize variable activities with a small random value.
+    bool decide_theories;    // Allow theory solvers to make decisions (requires opt_decide_theories).
     double garbage_frac;       // The fraction of wasted memory allowed before a garbage collection is triggered.
 
     int restart_first; // The initial restart limit.                                                                (default 100)
@@ -882,6 +951,29 @@ public:
     int consecutive_theory_conflicts = 0;
     uint64_t next_theory_decision = 0;
     uint64_t n_theory_decision_rounds = 0;
+    uint64_t stats_exported_clauses = 0;
+    uint64_t stats_imported_clauses = 0;
+    uint64_t stats_lbd_promotions = 0;
+    uint64_t stats_chrono_backtracks = 0;
+    uint64_t stats_reused_trails = 0;
+    uint64_t stats_reused_levels = 0;
+    uint64_t stats_reused_theory_lits = 0;
+    uint64_t stats_chrono_levels_kept = 0;
+    uint64_t stats_inprocess_rounds = 0;
+    uint64_t stats_vivified_clauses = 0;
+    uint64_t stats_vivified_lits = 0;
+    uint64_t stats_subsumed_clauses = 0;
+    uint64_t stats_strengthened_clauses = 0;
+    uint64_t stats_level0_removed_lits = 0;
+    double stats_inprocess_time = 0;
+    uint64_t stats_tier2_demotions = 0;
+    uint64_t stats_cube_lookaheads = 0;
+    uint64_t stats_cube_failed_lits = 0;
+
+    // Portfolio solving (see Portfolio.h):
+    //
+    ClauseExchange* clause_exchange = nullptr; // If set, short learnt clauses are shared with the other solvers of a portfolio.
+    int exchange_id = -1;
 
     //Var last_dec=var_Undef;
 protected:
@@ -1027,10 +1119,21 @@ protected:
     bool ok;            // If FALSE, the constraints are already unsatisfiable. No part of the solver state may be used!
     vec<CRef> clauses;          // List of problem clauses.
     vec<CRef> learnts;          // List of learnt clauses.
+    int n_protected_learnts = 0; // Number of learnt clauses in the core and tier2 tiers (as of the last count).
+    vec<uint64_t> lbd_stamp;    // Scratch space for computeLBD(), indexed by decision level.
+    uint64_t lbd_stamp_counter = 0;
+    uint64_t next_inprocess = opt_inprocess_interval; // Number of conflicts at which the next inprocessing round is due.
+    int inprocess_assigns = -1;   // Number of level 0 assignments at the last inprocessing round.
+    int vivify_clause_pos = 0;    // Position in 'clauses' at which the next round of vivification starts.
+    int vivify_learnt_pos = 0;    // Position in 'learnts' at which the next round of vivification starts.
+    vec<Lit> inprocess_lits;
+    vec<char> inprocess_marks;    // Indexed by literal.
+    vec<vec<CRef>> inprocess_occs; // Indexed by literal.
     double cla_inc;          // Amount to bump next clause with.
     vec<double> activity;         // A heuristic measurement of the activity of a variable.
     double var_inc;          // Amount to bump next variable with.
     OccLists<Lit, vec<Watcher>, WatcherDeleted> watches; // 'watches[lit]' is a list of constraints watching 'lit' (will go there if literal becomes true).
+    OccLists<Lit, vec<Watcher>, WatcherDeleted> watches_bin; // As 'watches', but for binary clauses; the blocker of each watcher is the other literal of the clause.
     Heuristic* conflicting_heuristic = nullptr;
 
     vec<lbool> assigns;          // The current assignments.
@@ -1089,7 +1192,7 @@ protected:
     //
     int64_t conflict_budget;    // -1 means no budget.
     int64_t propagation_budget; // -1 means no budget.
-    bool asynch_interrupt = false;
+    std::atomic<bool> asynch_interrupt{false};
 
     // Main internal methods:
     //
@@ -1205,8 +1308,43 @@ protected:
     lbool search(int nof_conflicts);                                     // Search for a given number of conflicts.
     lbool solve_();                                           // Main solve method (assumptions given in 'assumptions').
     void reduceDB();                                                      // Reduce the set of learnt clauses.
+    void initLearntTier(Clause& c, int lbd);  // Record the LBD of a new learnt clause, and place it in its tier.
+    void updateLearntTier(Clause& c);         // Update the LBD (and tier) of a learnt clause used in conflict analysis.
+    void countProtectedLearnts();
+    int reusedTrailLevel();                   // The level to backtrack to on a restart (see -reuse-trail).
+    bool inprocess();                         // Vivify, subsume and strengthen the clause database (at level 0).
+    bool strengthenLevel0(vec<CRef>& cs);     // Remove literals that are false at level 0 from the clauses in cs.
+    bool subsumeClauses(int64_t budget);      // Backward subsumption and self-subsuming resolution.
+    bool vivifyClauses(vec<CRef>& cs, int& pos, int64_t budget);
+    bool vivifyClause(CRef cr);
+    bool replaceClauseLits(CRef cr, vec<Lit>& lits); // Replace the literals of a detached clause (at level 0).
+    void purgeRemovedClauses(vec<CRef>& cs);
+
+    //The number of distinct decision levels among the literals (each unassigned literal counts as a level of its own)
+    template<class Lits>
+    int computeLBD(const Lits& lits){
+        lbd_stamp.growTo(decisionLevel() + 1, 0);
+        lbd_stamp_counter++;
+        int lbd = 0;
+        for(int i = 0; i < lits.size(); i++){
+            Var v = var(lits[i]);
+            if(value(v) == l_Undef){
+                lbd++;
+            }else if(lbd_stamp[level(v)] != lbd_stamp_counter){
+                lbd_stamp[level(v)] = lbd_stamp_counter;
+                lbd++;
+            }
+        }
+        return lbd;
+    }
     void removeSatisfied(vec<CRef>& cs);                           // Shrink 'cs' to contain only non-satisfied clauses.
     void rebuildOrderHeap();
+    void exportLearntClause(const vec<Lit>& learnt_clause);      // Share a learnt clause with the rest of the portfolio.
+    bool importSharedClauses();  // Add clauses learnt by the rest of the portfolio. Returns false if the portfolio is finished.
+    bool assignCube(const vec<Lit>& path); // Assign each literal of path at its own decision level. Returns false on conflict.
+    double lookahead(Lit l, int level);  // Score of the literals implied by propagating l above 'level' (-1 if l fails).
+    bool splitCube(int depth, vec<Lit>& path, int n_assumps, const vec<Var>& candidates,
+                   vec<vec<Lit>>& cubes); // Returns false if the cube on the path was refuted.
 
     void rebuildTheoryOrderHeap();
 
@@ -1267,6 +1405,16 @@ protected:
     void removeClause(CRef cr);               // Detach and free a clause.
     bool
     locked(const Clause& c) const; // Returns TRUE if a clause is a reason for some implication in the current state.
+    Var lockedVar(const Clause& c) const; // The variable that c is the reason for, or var_Undef if c is not locked.
+
+    //Binary clauses are propagated without inspecting the clause (see 'watches_bin'), so the implied literal of a binary
+    //reason may be in either position. This moves it to position 0, where conflict analysis expects it.
+    Clause& reasonClause(Var x){
+        Clause& c = ca[reason(x)];
+        if(c.size() == 2 && var(c[0]) != x)
+            std::swap(c[0], c[1]);
+        return c;
+    }
     bool satisfied(const Clause& c) const; // Returns TRUE if a clause is satisfied in the current state.
 
     void relocAll(ClauseAllocator& to);
@@ -1579,7 +1727,18 @@ inline bool Solver::addClause(Lit p, Lit q, Lit r){
     return addClause_(add_tmp);
 }
 
+inline Var Solver::lockedVar(const Clause& c) const{
+    for(int i = 0; i < (c.size() == 2 ? 2 : 1); i++){
+        Var v = var(c[i]);
+        if(value(c[i]) == l_True && ca.isClause(reason(v)) && ca.lea(reason(v)) == &c)
+            return v;
+    }
+    return var_Undef;
+}
+
 inline bool Solver::locked(const Clause& c) const{
+    if(c.size() == 2)
+        return lockedVar(c) != var_Undef;
     CRef r = reason(var(c[0]));
     bool isClause = ca.isClause(r);
     if(!isClause)
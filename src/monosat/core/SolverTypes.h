@@ -32,6 +32,9 @@
 #include "monosat/mtl/IntMap.h"
 #include "monosat/mtl/Map.h"
 #include "monosat/mtl/Alloc.h"
+#include "monosat/mtl/Sort.h"
+#include <algorithm>
+#include <cstring>
 
 namespace Monosat {
 
@@ -203,6 +206,13 @@ class Clause;
 
 typedef RegionAllocator<uint32_t>::Ref CRef;
 
+//Tiers of the learnt clause database (see Solver::reduceDB)
+enum LearntTier {
+    TIER_CORE = 0, //kept permanently
+    TIER_2 = 1,    //kept for as long as the clause keeps participating in conflicts
+    TIER_LOCAL = 2 //reduced by activity
+};
+
 class Clause {
     struct {
         unsigned mark :2;
@@ -212,11 +222,18 @@ class Clause {
         unsigned derived :1;
         unsigned size :26;
     } header;
+    //Learnt clauses store this after their activity, so that problem clauses don't pay for it
+    struct LearntHeader {
+        unsigned lbd :29;
+        unsigned tier :2;
+        unsigned used :1;
+    };
     union {
         Lit lit;
         float act;
         uint32_t abs;
-        CRef rel;
+        uint32_t rel;
+        LearntHeader learnt;
     } data[0];
 
     friend class ClauseAllocator;
@@ -235,13 +252,28 @@ class Clause {
             data[i].lit = ps[i];
 
         if(header.has_extra){
-            if(header.learnt)
+            if(header.learnt){
                 data[header.size].act = 0;
-            else
+                data[header.size + 1].learnt.lbd = 0;
+                data[header.size + 1].learnt.tier = TIER_LOCAL;
+                data[header.size + 1].learnt.used = 0;
+            }else
                 calcAbstraction();
         }
     }
 
+    LearntHeader& learntHeader(){
+        assert(header.learnt);
+        assert(header.has_extra);
+        return data[header.size + 1].learnt;
+    }
+
+    const LearntHeader& learntHeader() const{
+        assert(header.learnt);
+        assert(header.has_extra);
+        return data[header.size + 1].learnt;
+    }
+
 public:
     void calcAbstraction(){
         assert(header.has_extra);
@@ -258,15 +290,21 @@ public:
     //This is NOT safe. Only use this if it is guaranteed that the clause has enough extra allocated space
     void grow(int i){
         assert(i >= 0);
-        if(header.has_extra)
+        if(header.has_extra){
+            if(header.learnt)
+                data[header.size + 1 + i] = data[header.size + 1];
             data[header.size + i] = data[header.size];
+        }
         header.size += i;
     }
 
     void shrink(int i){
         assert(i <= size());
-        if(header.has_extra)
+        if(header.has_extra){
             data[header.size - i] = data[header.size];
+            if(header.learnt)
+                data[header.size + 1 - i] = data[header.size + 1];
+        }
         header.size -= i;
     }
 
@@ -302,17 +340,52 @@ public:
         header.derived = t;
     }
 
+    //Literal block distance ('glue'): the number of distinct decision levels among the clause's literals,
+    //when it was learnt (or when it last participated in conflict analysis, if that was lower).
+    int lbd() const{
+        return learntHeader().lbd;
+    }
+
+    void setLBD(int lbd){
+        learntHeader().lbd = std::min(lbd, (1 << 29) - 1);
+    }
+
+    LearntTier tier() const{
+        return (LearntTier) learntHeader().tier;
+    }
+
+    void setTier(LearntTier t){
+        learntHeader().tier = t;
+    }
+
+    //True if the clause participated in conflict analysis since the last reduction of the learnt clause database
+    bool used() const{
+        return learntHeader().used;
+    }
+
+    void setUsed(bool u){
+        learntHeader().used = u;
+    }
+
     bool reloced() const{
         return header.reloced;
     }
 
     CRef relocation() const{
+#ifdef MONOSAT_CREF64
+        return (((CRef) data[1].rel) << 32) | data[0].rel;
+#else
         return data[0].rel;
+#endif
     }
 
+    //Note: this overwrites the first literal (and, with 64-bit references, the second data word)
     void relocate(CRef c){
         header.reloced = 1;
-        data[0].rel = c;
+        data[0].rel = (uint32_t) c;
+#ifdef MONOSAT_CREF64
+        data[1].rel = (uint32_t) (c >> 32);
+#endif
     }
 
     // NOTE: somewhat unsafe to change the clause in-place! Must manually call 'calcAbstraction' afterwards for
@@ -359,8 +432,14 @@ public:
 const CRef CRef_Undef = RegionAllocator<uint32_t>::Ref_Undef;
 
 class ClauseAllocator : public RegionAllocator<uint32_t> {
-    static int clauseWord32Size(int size, bool has_extra){
-        return (sizeof(Clause) + (sizeof(Lit) * (size + (int) has_extra))) / sizeof(uint32_t);
+    //Learnt clauses (which always have the extra field) use one more word, for their LBD and tier.
+    static int clauseWord32Size(int size, bool has_extra, bool learnt){
+        int data_words = size + (int) has_extra + (int) (has_extra && learnt);
+#ifdef MONOSAT_CREF64
+        //a relocated clause stores its 64-bit relocation in its first two data words
+        data_words = std::max(data_words, 2);
+#endif
+        return (sizeof(Clause) + (sizeof(Lit) * data_words)) / sizeof(uint32_t);
     }
 
 public:
@@ -375,7 +454,7 @@ public:
         return cr < marker_refs;
     }
 
-    ClauseAllocator(uint32_t start_cap) :
+    ClauseAllocator(Ref start_cap) :
             RegionAllocator<uint32_t>(start_cap), extra_clause_field(false), marker_refs(CRef_Undef){
     }
 
@@ -394,7 +473,7 @@ public:
         static_assert(sizeof(float) == sizeof(uint32_t), "");
         bool use_extra = learnt | extra_clause_field;
 
-        CRef cid = RegionAllocator<uint32_t>::alloc(clauseWord32Size(ps.size(), use_extra));
+        CRef cid = RegionAllocator<uint32_t>::alloc(clauseWord32Size(ps.size(), use_extra, learnt));
         new(lea(cid)) Clause(ps, use_extra, learnt);
         return cid;
     }
@@ -426,13 +505,17 @@ public:
             return;
         }
         Clause& c = operator[](cid);
-        RegionAllocator<uint32_t>::free(clauseWord32Size(c.size(), c.has_extra()));
+        RegionAllocator<uint32_t>::free(clauseWord32Size(c.size(), c.has_extra(), c.learnt()));
     }
 
     void reloc(CRef& cr, ClauseAllocator& to){
         if(cr >= marker_refs){
             return;
         }
+        if(&to == this){
+            relocInPlace(cr);
+            return;
+        }
         Clause& c = operator[](cr);
 
         if(c.reloced()){
@@ -441,15 +524,93 @@ public:
         }
 
         cr = to.alloc(c, c.learnt());
-        c.relocate(cr);
         to[cr].setDerived(c.derivedClause());
         // Copy extra data-fields:
         // (This could be cleaned-up. Generalize Clause-constructor to be applicable here instead?)
         to[cr].mark(c.mark());
-        if(to[cr].learnt())
+        if(to[cr].learnt()){
             to[cr].activity() = c.activity();
-        else if(to[cr].has_extra())
+            to[cr].setLBD(c.lbd());
+            to[cr].setTier(c.tier());
+            to[cr].setUsed(c.used());
+        }else if(to[cr].has_extra())
             to[cr].calcAbstraction();
+        c.relocate(cr);
+    }
+
+    // In-place compaction. Requires every reference to the region to be passed to reloc(cr, *this) twice:
+    // once after beginCompaction() (to find the live clauses), and once more after forwardCompaction()
+    // (to update the references). endCompaction() then slides the live clauses down over the garbage.
+    void beginCompaction(){
+        assert(compact_phase == 0);
+        compact_phase = 1;
+        compact_from.clear();
+    }
+
+    void forwardCompaction(){
+        assert(compact_phase == 1);
+        compact_phase = 2;
+        sort(compact_from);
+        compact_to.clear();
+        Ref pos = 0;
+        for(CRef cr : compact_from){
+            const Clause& c = operator[](cr);
+            compact_to.push(pos);
+            pos += clauseWord32Size(c.size(), compactedExtra(c), c.learnt());
+        }
+    }
+
+    void endCompaction(){
+        assert(compact_phase == 2);
+        compact_phase = 0;
+        Ref end = 0;
+        for(int i = 0; i < compact_from.size(); i++){
+            Clause& c = operator[](compact_from[i]);
+            bool use_extra = compactedExtra(c);
+            int words = clauseWord32Size(c.size(), use_extra, c.learnt());
+            assert(compact_to[i] <= compact_from[i]);
+            if(compact_to[i] != compact_from[i])
+                memmove(lea(compact_to[i]), &c, words * sizeof(uint32_t));
+            Clause& d = operator[](compact_to[i]);
+            d.header.reloced = 0;
+            d.header.has_extra = use_extra;
+            if(use_extra && !d.learnt())
+                d.calcAbstraction();
+            end = compact_to[i] + words;
+        }
+        truncate(end);
+        compact_from.clear(true);
+        compact_to.clear(true);
+    }
+
+private:
+    int compact_phase = 0;
+    vec<CRef> compact_from;//live clauses, in address order
+    vec<CRef> compact_to;//the address each live clause will be moved to
+
+    //Matches the layout a copying collection would produce (see alloc()), except that clauses never grow.
+    bool compactedExtra(const Clause& c) const{
+        return c.has_extra() && (c.learnt() || extra_clause_field);
+    }
+
+    void relocInPlace(CRef& cr){
+        Clause& c = operator[](cr);
+        if(compact_phase == 1){
+            if(!c.reloced()){
+                c.header.reloced = 1;
+                compact_from.push(cr);
+            }
+        }else{
+            assert(compact_phase == 2);
+            //Like a copying collection, leave references to dead clauses dangling
+            if(!c.reloced())
+                return;
+            const CRef* begin = compact_from;
+            const CRef* end = begin + compact_from.size();
+            const CRef* it = std::lower_bound(begin, end, cr);
+            assert(it != end && *it == cr);
+            cr = compact_to[(int) (it - begin)];
+        }
     }
 };
 
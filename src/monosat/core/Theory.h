@@ -28,6 +28,7 @@
 #include "monosat/utils/Options.h"
 #include "monosat/core/SolverTypes.h"
 #include "monosat/core/Heuristic.h"
+#include "monosat/core/Profile.h"
 #include <ostream>
 #include <string>
 
@@ -123,6 +124,12 @@ public:
 
     }
 
+    //Append the propagation profiles of the parts of this theory (such as detectors), for Solver::writeProfile().
+    //The theory as a whole is profiled by the SAT solver.
+    virtual void getProfiles(std::vector<ProfilePart>& parts){
+
+    }
+
     virtual bool check_propagated(){
         return true;
     }
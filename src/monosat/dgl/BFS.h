@@ -52,9 +52,26 @@ public:
     bool opt_skip_additions = false;
     bool opt_inc_graph = false;
     int opt_dec_graph = 0;
+    //If true, full updates switch between top-down and bottom-up steps, depending on the size of the frontier (Beamer et al., 2012).
+    bool opt_direction_optimizing = false;
+    //Switch to bottom-up steps once the frontier has more than 1/alpha of the edges of the unvisited nodes,
+    //and back to top-down steps once the frontier has fewer than 1/beta of the nodes.
+    int opt_do_alpha = 14;
+    int opt_do_beta = 24;
+    //If true, full (top-down) updates stop as soon as every active target (see setTargetActive()) has been reached;
+    //the rest of the traversal is only resumed if connected() is asked about a node that has not been reached yet.
+    bool opt_early_termination = false;
 
     std::vector<int> q;
     std::vector<int> check;
+    std::vector<int> next_q;
+    std::vector<char> in_frontier;
+    std::vector<char> active_target;
+    int n_active_targets = 0;
+    //number of active targets not yet reached by the current traversal
+    int n_unreached_targets = 0;
+    //if the last traversal stopped early, the position in q at which to resume it (else -1)
+    int q_resume = -1;
     const int reportPolarity;
 
     //std::vector<char> old_seen;
@@ -71,6 +88,10 @@ public:
     int stats_skip_deletes;
     int stats_skipped_updates;
     int stats_num_skipable_deletions;
+    int64_t stats_bottom_up_steps = 0;
+    int64_t stats_top_down_steps = 0;
+    int64_t stats_early_terminations = 0;
+    int64_t stats_resumed_traversals = 0;
     double mod_percentage;
 
     double stats_full_update_time;
@@ -104,6 +125,17 @@ public:
         return source;
     }
 
+    void setTargetActive(int node, bool active) override{
+        if(node >= active_target.size())
+            active_target.resize(node + 1, false);
+        if(active_target[node] == active)
+            return;
+        active_target[node] = active;
+        n_active_targets += active ? 1 : -1;
+        if(node >= seen.size() || !seen[node])
+            n_unreached_targets += active ? 1 : -1;
+    }
+
     /*void updateFast(){
      stats_fast_updates++;
 
@@ -216,11 +248,11 @@ public:
             //if(!old_seen[u]){
             //	changed.push_back(u);
             //}
-            for(int i = 0; i < g.nIncident(u, undirected); i++){
-                if(!g.edgeEnabled(g.incident(u, i, undirected).id))
+            for(auto& edge:g.incidentEdges(u, undirected)){
+                if(!g.edgeEnabled(edge.id))
                     continue;
-                int v = g.incident(u, i, undirected).node;
-                int edgeID = g.incident(u, i, undirected).id;
+                int v = edge.node;
+                int edgeID = edge.id;
                 if(!seen[v]){
                     seen[v] = 1;
                     prev[v] = edgeID;
@@ -244,10 +276,10 @@ public:
             int u = q[i];
             assert(!seen[u]);
 
-            for(int i = 0; i < g.nIncident(u, undirected); i++){
-                /*				if(!g.edgeEnabled( g.incident(u,i).id))
+            for(auto& edge:g.incidentEdges(u, undirected)){
+                /*				if(!g.edgeEnabled( edge.id))
                  continue;*/
-                int v = g.incident(u, i, undirected).node;
+                int v = edge.node;
                 if(seen[v] && previous(v) == u){
                     seen[v] = 0;
                     prev[v] = -1;
@@ -263,11 +295,11 @@ public:
             int u = check[i];
             if(!seen[u]){
                 if(!undirected){
-                    for(int i = 0; i < g.nIncoming(u); i++){
+                    for(auto& edge:g.incomingEdges(u)){
 
-                        if(g.edgeEnabled(g.incoming(u, i).id)){
-                            int from = g.incoming(u, i).node;
-                            int edgeID = g.incoming(u, i).id;
+                        if(g.edgeEnabled(edge.id)){
+                            int from = edge.node;
+                            int edgeID = edge.id;
                             int to = u;
                             if(seen[from]){
 
@@ -280,11 +312,11 @@ public:
                         }
                     }
                 }else{
-                    for(int i = 0; i < g.nIncident(u, undirected); i++){
+                    for(auto& edge:g.incidentEdges(u, undirected)){
 
-                        if(g.edgeEnabled(g.incident(u, i, undirected).id)){
-                            int from = g.incident(u, i, undirected).node;
-                            int edgeID = g.incident(u, i, undirected).id;
+                        if(g.edgeEnabled(edge.id)){
+                            int from = edge.node;
+                            int edgeID = edge.id;
                             assert(from != u);
                             int to = u;
                             if(seen[from]){
@@ -303,9 +335,9 @@ public:
 
     bool update_additions(){
 
-        if(g.nHistoryClears() != last_history_clear){
+        if(g.nHistoryClears() != last_history_clear || history_qhead < g.historyStart()){
             last_history_clear = g.nHistoryClears();
-            history_qhead = 0;
+            history_qhead = g.historyStart();
         }
 
         assert(INF > g.nodes());
@@ -367,9 +399,9 @@ public:
 
     bool incrementalUpdate(){
 
-        if(g.nHistoryClears() != last_history_clear){
+        if(g.nHistoryClears() != last_history_clear || history_qhead < g.historyStart()){
             last_history_clear = g.nHistoryClears();
-            history_qhead = 0;
+            history_qhead = g.historyStart();
         }
 
         assert(INF > g.nodes());
@@ -440,10 +472,14 @@ public:
     }
 
     void update() override{
-        static int iteration = 0;
+        static thread_local int iteration = 0;
         int local_it = ++iteration;
 
         if(last_modification > 0 && g.getCurrentHistory() == last_modification){
+            if(q_resume >= 0 && n_unreached_targets > 0){
+                //a target that the early-terminated traversal did not reach has since become active
+                resume(-1);
+            }
             stats_skipped_updates++;
             assert(dbg_uptodate());
             return;
@@ -465,10 +501,10 @@ public:
 
         setNodes(g.nodes());
 
-        if(g.nHistoryClears() != last_history_clear){
+        if(g.nHistoryClears() != last_history_clear || history_qhead < g.historyStart()){
             last_history_clear = g.nHistoryClears();
-            history_qhead = 0;
-        }else if(opt_inc_graph && last_modification > 0 && (g.nHistoryClears() <= (last_history_clear +
+            history_qhead = g.historyStart();
+        }else if(opt_inc_graph && q_resume < 0 && last_modification > 0 && (g.nHistoryClears() <= (last_history_clear +
                                                                                    1))){// && (g.historySize()-history_qhead < g.edges()*mod_percentage)){
             if(opt_dec_graph == 2){
                 if(incrementalUpdate())
@@ -513,33 +549,40 @@ public:
         stats_full_updates++;
 
         q.clear();
+        q_resume = -1;
         for(int i = 0; i < g.nodes(); i++){
             seen[i] = 0;
             prev[i] = -1;
         }
 
-        seen[source] = 1;
-        q.push_back(source);
-        for(int i = 0; i < q.size(); i++){
-            int u = q[i];
-            assert(seen[u]);
-            if(reportPolarity == 1)
-                status.setReachable(u, true);
-
-            for(int i = 0; i < g.nIncident(u, undirected); i++){
-                if(!g.edgeEnabled(g.incident(u, i, undirected).id))
-                    continue;
-                int v = g.incident(u, i, undirected).node;
-                int edgeID = g.incident(u, i, undirected).id;
-                if(!seen[v]){
-                    seen[v] = 1;
-                    prev[v] = edgeID;
-                    q.push_back(v);
+        if(opt_direction_optimizing){
+            direction_optimizing_bfs();
+            if(reportPolarity == 1){
+                for(int u = 0; u < g.nodes(); u++){
+                    if(seen[u])
+                        status.setReachable(u, true);
                 }
             }
+        }else{
+            seen[source] = 1;
+            q.push_back(source);
+            if(reportPolarity == 1)
+                status.setReachable(source, true);
+            n_unreached_targets = n_active_targets;
+            if(source < active_target.size() && active_target[source])
+                n_unreached_targets--;
+            traverse(0, -1);
         }
 
-        if(reportPolarity < 1){
+        if(q_resume >= 0){
+            //the traversal stopped early; the unreached nodes may yet be reachable
+            if(reportPolarity == 0){
+                for(int u = 0; u < g.nodes(); u++){
+                    if(seen[u])
+                        status.setReachable(u, true);
+                }
+            }
+        }else if(reportPolarity < 1){
             for(int u = 0; u < g.nodes(); u++){
                 if(!seen[u]){
                     status.setReachable(u, false);
@@ -560,6 +603,131 @@ public:
         ;
     }
 
+    /**
+     * Continues the top-down traversal from q[start]. If early termination is enabled, stops once every active target
+     * (and 'until', if it is a node) has been reached, recording in q_resume where to continue from.
+     * Nodes are reported reachable as they are first seen (for reportPolarity 1), so that an early stop reports
+     * every node that was reached.
+     */
+    void traverse(int start, int until){
+        for(int i = start; i < q.size(); i++){
+            if(opt_early_termination && n_unreached_targets <= 0 && (until < 0 || seen[until])){
+                q_resume = i;
+                stats_early_terminations++;
+                return;
+            }
+            int u = q[i];
+            assert(seen[u]);
+            for(auto& edge:g.incidentEdges(u, undirected)){
+                if(!g.edgeEnabled(edge.id))
+                    continue;
+                int v = edge.node;
+                int edgeID = edge.id;
+                if(!seen[v]){
+                    seen[v] = 1;
+                    prev[v] = edgeID;
+                    q.push_back(v);
+                    if(v < active_target.size() && active_target[v])
+                        n_unreached_targets--;
+                    if(reportPolarity == 1)
+                        status.setReachable(v, true);
+                }
+            }
+        }
+        q_resume = -1;
+    }
+
+    //Resumes an early-terminated traversal, reporting the unreachable nodes if it runs to completion.
+    void resume(int until){
+        assert(q_resume >= 0);
+        stats_resumed_traversals++;
+        traverse(q_resume, until);
+        if(q_resume < 0){
+            q.clear();
+            for(int u = 0; u < g.nodes(); u++){
+                if(!seen[u]){
+                    if(reportPolarity < 1)
+                        status.setReachable(u, false);
+                }else if(reportPolarity == 0){
+                    status.setReachable(u, true);
+                }
+            }
+        }
+    }
+
+    /**
+     * Level-synchronous BFS from the source (into seen and prev), which switches to bottom-up steps when the
+     * frontier is large: each unvisited node then scans its incoming edges for a parent in the frontier, and stops at
+     * the first one found, instead of the frontier scanning all of its outgoing edges.
+     * Every node is still assigned an incoming edge from the previous level, so paths remain shortest paths.
+     */
+    void direction_optimizing_bfs(){
+        int n = g.nodes();
+        in_frontier.clear();
+        in_frontier.resize(n, false);
+        next_q.clear();
+
+        //edges (enabled or not) out of the frontier, and out of the unvisited nodes
+        int64_t frontier_edges = g.incidentEdges(source, undirected).size();
+        int64_t unvisited_edges = 0;
+        for(int u = 0; u < n; u++){
+            unvisited_edges += g.incidentEdges(u, undirected).size();
+        }
+        unvisited_edges -= frontier_edges;
+
+        seen[source] = 1;
+        q.push_back(source);
+        bool bottom_up = false;
+        while(q.size()){
+            if(!bottom_up && frontier_edges * opt_do_alpha > unvisited_edges){
+                bottom_up = true;
+            }else if(bottom_up && q.size() * opt_do_beta < n){
+                bottom_up = false;
+            }
+            next_q.clear();
+            int64_t next_frontier_edges = 0;
+            if(bottom_up){
+                stats_bottom_up_steps++;
+                for(int u:q)
+                    in_frontier[u] = true;
+                for(int v = 0; v < n; v++){
+                    if(seen[v])
+                        continue;
+                    for(auto& edge:g.incomingEdges(v, undirected)){
+                        if(in_frontier[edge.node] && g.edgeEnabled(edge.id)){
+                            seen[v] = 1;
+                            prev[v] = edge.id;
+                            next_q.push_back(v);
+                            next_frontier_edges += g.incidentEdges(v, undirected).size();
+                            break;
+                        }
+                    }
+                }
+                for(int u:q)
+                    in_frontier[u] = false;
+            }else{
+                stats_top_down_steps++;
+                for(int u:q){
+                    for(auto& edge:g.incidentEdges(u, undirected)){
+                        if(!g.edgeEnabled(edge.id))
+                            continue;
+                        int v = edge.node;
+                        if(!seen[v]){
+                            seen[v] = 1;
+                            prev[v] = edge.id;
+                            next_q.push_back(v);
+                            next_frontier_edges += g.incidentEdges(v, undirected).size();
+                        }
+                    }
+                }
+            }
+            unvisited_edges -= next_frontier_edges;
+            frontier_edges = next_frontier_edges;
+            std::swap(q, next_q);
+        }
+        q.clear();
+    }
+
     bool dbg_path(int to){
 #ifdef DEBUG_DIJKSTRA
         assert(connected(to));
@@ -594,9 +762,9 @@ public:
         }
 
         for(int i = 0; i < g.nodes(); i++){
-            for(int j = 0; j < g.nIncident(i, undirected); j++){
-                int id = g.incident(i, j, undirected).id;
-                int u = g.incident(i, j, undirected).node;
+            for(auto& edge:g.incidentEdges(i, undirected)){
+                int id = edge.id;
+                int u = edge.node;
                 const char* s = "black";
                 if(g.edgeEnabled(id))
                     s = "blue";
@@ -653,7 +821,8 @@ public:
             update();
 
         assert(dbg_uptodate());
-
+        if(q_resume >= 0 && !seen[t])
+            resume(t);
         return seen[t];
     }
 
@@ -801,7 +970,7 @@ public:
     }
 
     void update() override{
-        static int iteration = 0;
+        static thread_local int iteration = 0;
         int local_it = ++iteration;
 
         if(last_modification > 0 && g.getCurrentHistory() == last_modification){
@@ -816,9 +985,9 @@ public:
 
         setNodes(g.nodes());
 
-        if(g.nHistoryClears() != last_history_clear){
+        if(g.nHistoryClears() != last_history_clear || history_qhead < g.historyStart()){
             last_history_clear = g.nHistoryClears();
-            history_qhead = 0;
+            history_qhead = g.historyStart();
         }
 
         q.clear();
@@ -835,11 +1004,11 @@ public:
             if(reportPolarity >= 0)
                 status.setMininumDistance(u, true, dist[u]);
             int d = dist[u];
-            for(int i = 0; i < g.nIncident(u, undirected); i++){
-                if(!g.edgeEnabled(g.incident(u, i, undirected).id))
+            for(auto& edge:g.incidentEdges(u, undirected)){
+                if(!g.edgeEnabled(edge.id))
                     continue;
-                int edgeID = g.incident(u, i, undirected).id;
-                int v = g.incident(u, i, undirected).node;
+                int edgeID = edge.id;
+                int v = edge.node;
                 int dv = dist[v];
                 int alt = d + 1;
                 if(alt > maxDistance)
@@ -905,9 +1074,9 @@ public:
         }
 
         for(int i = 0; i < g.nodes(); i++){
-            for(int j = 0; j < g.nIncident(i, undirected); j++){
-                int id = g.incident(i, j).id;
-                int u = g.incident(i, j).node;
+            for(auto& edge:g.incidentEdges(i, undirected)){
+                int id = edge.id;
+                int u = edge.node;
                 const char* s = "black";
                 if(g.edgeEnabled(id))
                     s = "blue";
@@ -0,0 +1,676 @@
+/**************************************************************************************************
+ The MIT License (MIT)
+
+ Copyright (c) 2014, Sam Bayless
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef BIDIRECTIONAL_DIJKSTRA_H_
+#define BIDIRECTIONAL_DIJKSTRA_H_
+
+#include <vector>
+#include <cinttypes>
+#include <type_traits>
+#include "monosat/dgl/alg/Heap.h"
+#include "Graph.h"
+#include "DynamicGraph.h"
+#include "Reach.h"
+#include "Distance.h"
+
+namespace dgl {
+
+/**
+ * Landmark distances for the ALT (A*, landmarks, triangle inequality) lower bounds of Goldberg and Harrelson (2005).
+ * The distances from and to each landmark are computed on a graph G0; for any graph whose enabled edges are a subset
+ * of the edges enabled in G0 (with the same weights), dist(u,v) >= dist0(L,v) - dist0(L,u), and
+ * dist(u,v) >= dist0(u,L) - dist0(v,L), for every landmark L.
+ * These bounds are consistent, so they can be used as potentials in A* search.
+ *
+ * In the graph theory, the landmarks are computed on the over-approximate graph at decision level 0, and remain valid
+ * for both the under and over approximate graphs for as long as edges are only disabled.
+ */
+template<typename Weight, typename Graph = DynamicGraph<Weight>, bool unit_weights = false>
+class ALTLandmarks {
+public:
+    typedef typename std::conditional<unit_weights, int, Weight>::type Dist;
+
+    Graph& g;
+    const int n_landmarks;
+
+private:
+    struct DistCmp {
+        std::vector<Dist>& _dist;
+
+        bool operator()(int a, int b) const{
+            return _dist[a] < _dist[b];
+        }
+
+        DistCmp(std::vector<Dist>& d) :
+                _dist(d){
+        };
+    };
+
+    std::vector<int> landmarks;
+    //from_landmark[i*n_nodes + v] is the distance from landmark i to v, and to_landmark[i*n_nodes + v] the distance from v to landmark i
+    std::vector<Dist> from_landmark;
+    std::vector<Dist> to_landmark;
+    //the edges that were enabled when the landmark distances were computed
+    std::vector<char> covered;
+    int n_nodes = 0;
+    bool valid = false;
+
+    std::vector<Dist> tmp_dist;
+    alg::Heap<DistCmp> q;
+
+public:
+    int64_t stats_computes = 0;
+
+    ALTLandmarks(Graph& graph, int n_landmarks) :
+            g(graph), n_landmarks(n_landmarks), q(DistCmp(tmp_dist)){
+
+    }
+
+    static Dist& inf(){
+        return Distance<Dist>::INF;
+    }
+
+    bool isValid() const{
+        return valid && n_nodes == g.nodes();
+    }
+
+    void invalidate(){
+        valid = false;
+    }
+
+    //True if the edge was enabled when the landmark distances were computed
+    bool covers(int edgeID) const{
+        return edgeID < covered.size() && covered[edgeID];
+    }
+
+    //Recompute the landmark distances, if the graph has changed shape or an edge is enabled that was not when they were computed.
+    void update(){
+        if(valid && n_nodes == g.nodes() && covered.size() == g.edges()){
+            bool stale = false;
+            for(int edgeID = 0; edgeID < g.edges(); edgeID++){
+                if(!covered[edgeID] && g.hasEdge(edgeID) && g.edgeEnabled(edgeID)){
+                    stale = true;
+                    break;
+                }
+            }
+            if(!stale)
+                return;
+        }
+        compute();
+    }
+
+    /**
+     * Computes a lower bound on the distance from u to v.
+     * Returns false if v is certainly not reachable from u.
+     */
+    bool lowerBound(int u, int v, Dist& bound) const{
+        bound = 0;
+        for(int i = 0; i < landmarks.size(); i++){
+            const Dist& from_u = from_landmark[i * n_nodes + u];
+            const Dist& from_v = from_landmark[i * n_nodes + v];
+            if(from_u < inf()){
+                if(from_v >= inf())
+                    return false;//the landmark reaches u, but not v
+                if(from_v - from_u > bound)
+                    bound = from_v - from_u;
+            }
+            const Dist& to_u = to_landmark[i * n_nodes + u];
+            const Dist& to_v = to_landmark[i * n_nodes + v];
+            if(to_v < inf()){
+                if(to_u >= inf())
+                    return false;//v reaches the landmark, but u does not
+                if(to_u - to_v > bound)
+                    bound = to_u - to_v;
+            }
+        }
+        return true;
+    }
+
+private:
+
+    inline Dist weight(int edgeID, std::true_type){
+        return 1;
+    }
+
+    inline Dist weight(int edgeID, std::false_type){
+        return g.getWeight(edgeID);
+    }
+
+    //Single source (or, if backward, single destination) distances over the enabled edges, into tmp_dist
+    void dijkstra(int s, bool backward){
+        tmp_dist.clear();
+        tmp_dist.resize(n_nodes, inf());
+        q.clear();
+        tmp_dist[s] = 0;
+        q.insert(s);
+        while(q.size()){
+            int u = q.removeMin();
+            for(auto& edge:(backward ? g.incomingEdges(u) : g.incidentEdges(u))){
+                if(!g.edgeEnabled(edge.id))
+                    continue;
+                int v = edge.node;
+                Dist alt = tmp_dist[u] + weight(edge.id, std::integral_constant<bool, unit_weights>());
+                if(alt < tmp_dist[v]){
+                    tmp_dist[v] = alt;
+                    if(!q.inHeap(v))
+                        q.insert(v);
+                    else
+                        q.decrease(v);
+                }
+            }
+        }
+    }
+
+    //Select landmarks greedily, each one as far as possible from those already selected (preferring nodes they do not reach).
+    void compute(){
+        stats_computes++;
+        valid = true;
+        n_nodes = g.nodes();
+        covered.clear();
+        covered.resize(g.edges(), false);
+        for(int edgeID = 0; edgeID < g.edges(); edgeID++){
+            covered[edgeID] = g.hasEdge(edgeID) && g.edgeEnabled(edgeID);
+        }
+        landmarks.clear();
+        from_landmark.clear();
+        to_landmark.clear();
+        if(n_nodes == 0)
+            return;
+
+        //the distance from the nearest selected landmark to each node
+        std::vector<Dist> nearest;
+        dijkstra(0, false);
+        nearest = tmp_dist;
+        while(landmarks.size() < n_landmarks && landmarks.size() < n_nodes){
+            int next = -1;
+            for(int v = 0; v < n_nodes; v++){
+                if(next < 0 || nearest[v] > nearest[next])
+                    next = v;
+            }
+            if(nearest[next] <= 0)
+                break;//every node is already a landmark
+            landmarks.push_back(next);
+            dijkstra(next, false);
+            from_landmark.insert(from_landmark.end(), tmp_dist.begin(), tmp_dist.end());
+            for(int v = 0; v < n_nodes; v++){
+                if(tmp_dist[v] < nearest[v] || landmarks.size() == 1)
+                    nearest[v] = tmp_dist[v];
+            }
+            dijkstra(next, true);
+            to_landmark.insert(to_landmark.end(), tmp_dist.begin(), tmp_dist.end());
+        }
+    }
+};
+
+/**
+ * Single-pair shortest paths from a fixed source, by bidirectional Dijkstra search, optionally directed by
+ * ALT landmark lower bounds (using the 'symmetric' stopping rule, with each direction using its own potential).
+ *
+ * Distances are computed lazily, one destination at a time, and cached until the graph changes.
+ * This is much cheaper than a full single source search when there are only a few destinations in a large graph.
+ * Queries for nodes that are not destinations (see addDestination()), or updates with many destinations to compute,
+ * fall back on a single full Dijkstra search from the source.
+ *
+ * If unit_weights is true, every edge has length 1 (as in UnweightedDijkstra).
+ */
+template<typename Weight, typename Graph = DynamicGraph<Weight>, class Status = typename Distance<Weight>::NullStatus, bool unit_weights = false>
+class BidirectionalDijkstra : public Distance<typename std::conditional<unit_weights, int, Weight>::type> {
+public:
+    typedef typename std::conditional<unit_weights, int, Weight>::type Dist;
+    typedef ALTLandmarks<Weight, Graph, unit_weights> Landmarks;
+    using Distance<Dist>::inf;
+    using Distance<Dist>::unreachable;
+
+    Graph& g;
+    Status& status;
+    int reportPolarity;
+    Landmarks* landmarks;
+
+    int last_modification = -1;
+    int source;
+
+    //If more than this many destinations need to be computed in an update, run a single full search instead.
+    int max_bidirectional_searches = 8;
+
+private:
+    struct DistCmp {
+        std::vector<Dist>& _dist;
+
+        bool operator()(int a, int b) const{
+            return _dist[a] < _dist[b];
+        }
+
+        DistCmp(std::vector<Dist>& d) :
+                _dist(d){
+        };
+    };
+
+    //incremented each time the graph changes; dist[t] is current if dist_version[t]==version
+    int64_t version = 0;
+    int64_t reported_version = -1;
+    std::vector<Dist> dist;
+    std::vector<int64_t> dist_version;
+    std::vector<int> prev;
+
+    std::vector<char> is_destination;
+    std::vector<int> destinations;
+
+    //search state, in the forward (from the source) and reverse (to the destination) directions
+    std::vector<Dist> dist_f;
+    std::vector<Dist> dist_r;
+    std::vector<Dist> key_f;
+    std::vector<Dist> key_r;
+    std::vector<int> prev_f;
+    std::vector<int> prev_r;
+    std::vector<int> touched;
+    alg::Heap<DistCmp> q_f;
+    alg::Heap<DistCmp> q_r;
+
+    //The number of edges enabled in g that the landmarks do not cover, as of history position uncovered_history_pos.
+    //Kept up to date from the graph's history, and recounted whenever the landmarks are recomputed or the history
+    //is cleared.
+    int n_uncovered = 0;
+    int uncovered_history_pos = 0;
+    int uncovered_history_clears = -1;
+    int64_t uncovered_landmark_computes = -1;
+
+public:
+    int64_t stats_searches = 0;
+    int64_t stats_alt_searches = 0;
+    int64_t stats_full_updates = 0;
+    int64_t stats_nodes_scanned = 0;
+    int64_t num_updates = 0;
+
+    BidirectionalDijkstra(int s, Graph& graph, Status& status, int reportPolarity = 0, Landmarks* landmarks = nullptr) :
+            g(graph), status(status), reportPolarity(reportPolarity), landmarks(landmarks), source(s),
+            q_f(DistCmp(key_f)), q_r(DistCmp(key_r)){
+
+    }
+
+    void setSource(int s) override{
+        source = s;
+        last_modification = -1;
+    }
+
+    int getSource() override{
+        return source;
+    }
+
+    int numUpdates() const override{
+        return num_updates;
+    }
+
+    void addDestination(int node) override{
+        if(node >= is_destination.size())
+            is_destination.resize(node + 1, false);
+        if(!is_destination[node]){
+            is_destination[node] = true;
+            destinations.push_back(node);
+            reported_version = -1;
+        }
+    }
+
+    void update() override{
+        sync();
+        if(reported_version == version)
+            return;
+        reported_version = version;
+        num_updates++;
+
+        int n_searches = 0;
+        for(int t:destinations){
+            if(t < g.nodes() && dist_version[t] != version)
+                n_searches++;
+        }
+        if(n_searches > max_bidirectional_searches)
+            computeAll();
+
+        for(int t:destinations){
+            if(t >= g.nodes())
+                continue;
+            Dist& d = distance(t);
+            bool reachable = d < inf();
+            if(reportPolarity <= 0 && !reachable){
+                status.setReachable(t, false);
+                status.setMininumDistance(t, false, inf());
+            }else if(reportPolarity >= 0 && reachable){
+                status.setReachable(t, true);
+                status.setMininumDistance(t, true, d);
+            }
+        }
+    }
+
+    bool connected_unsafe(int t) override{
+        return distance_unsafe(t) != unreachable();
+    }
+
+    bool connected_unchecked(int t) override{
+        return connected_unsafe(t);
+    }
+
+    bool connected(int t) override{
+        return distance(t) != unreachable();
+    }
+
+    Dist& distance(int t) override{
+        sync();
+        if(dist_version[t] != version){
+            if(t < is_destination.size() && is_destination[t])
+                search(t);
+            else
+                computeAll();
+        }
+        assert(dist_version[t] == version);
+        if(dist[t] < inf())
+            return dist[t];
+        return unreachable();
+    }
+
+    Dist& distance_unsafe(int t) override{
+        //distances are only computed on demand, so there is nothing to gain by skipping the history check
+        return distance(t);
+    }
+
+    int incomingEdge(int t) override{
+        assert(t >= 0 && t < prev.size());
+        return prev[t];
+    }
+
+    int previous(int t) override{
+        if(t == source || prev[t] < 0)
+            return -1;
+        assert(g.getEdge(incomingEdge(t)).to == t);
+        return g.getEdge(incomingEdge(t)).from;
+    }
+
+    void printStats() override{
+        printf("Bidirectional Dijkstra: %" PRId64 " searches (%" PRId64 " with landmarks), %" PRId64
+               " full searches, %" PRId64 " nodes scanned\n", stats_searches, stats_alt_searches, stats_full_updates,
+               stats_nodes_scanned);
+    }
+
+private:
+
+    inline Dist weight(int edgeID, std::true_type){
+        return 1;
+    }
+
+    inline Dist weight(int edgeID, std::false_type){
+        return g.getWeight(edgeID);
+    }
+
+    inline Dist weight(int edgeID){
+        return weight(edgeID, std::integral_constant<bool, unit_weights>());
+    }
+
+    void sync(){
+        if(dist.size() != g.nodes()){
+            int n = g.nodes();
+            dist.resize(n, inf());
+            dist_version.resize(n, -1);
+            prev.resize(n, -1);
+            dist_f.resize(n, inf());
+            dist_r.resize(n, inf());
+            key_f.resize(n, inf());
+            key_r.resize(n, inf());
+            prev_f.resize(n, -1);
+            prev_r.resize(n, -1);
+            last_modification = -1;
+        }
+        if(last_modification <= 0 || last_modification != g.getCurrentHistory()){
+            version++;
+            last_modification = g.getCurrentHistory();
+        }
+    }
+
+    //Plain Dijkstra from the source, computing the distance to every node.
+    void computeAll(){
+        stats_full_updates++;
+        int n = g.nodes();
+        for(int v = 0; v < n; v++){
+            dist[v] = inf();
+            prev[v] = -1;
+            dist_version[v] = version;
+        }
+        q_f.clear();
+        dist[source] = 0;
+        key_f[source] = 0;
+        q_f.insert(source);
+        while(q_f.size()){
+            int u = q_f.removeMin();
+            stats_nodes_scanned++;
+            for(auto& edge:g.incidentEdges(u)){
+                if(!g.edgeEnabled(edge.id))
+                    continue;
+                int v = edge.node;
+                Dist alt = dist[u] + weight(edge.id);
+                if(alt < dist[v]){
+                    dist[v] = alt;
+                    key_f[v] = alt;
+                    prev[v] = edge.id;
+                    if(!q_f.inHeap(v))
+                        q_f.insert(v);
+                    else
+                        q_f.decrease(v);
+                }
+            }
+        }
+        for(int v = 0; v < n; v++){
+            key_f[v] = inf();
+        }
+    }
+
+    void search(int t){
+        if(t == source){
+            dist[t] = 0;
+            prev[t] = -1;
+            dist_version[t] = version;
+            return;
+        }
+        stats_searches++;
+        if(landmarks && landmarks->isValid() && landmarksCover()){
+            stats_alt_searches++;
+            if(bidirectional(t, true))
+                return;
+            //an edge was enabled that the landmarks do not cover
+            landmarks->invalidate();
+        }
+        bool ok = bidirectional(t, false);
+        assert(ok);
+    }
+
+    /**
+     * True if every edge enabled in g is covered by the landmarks. The landmark bounds also prune nodes that have not
+     * been reached yet (and the search itself, if t appears unreachable), so they can only be used if no uncovered
+     * edge is enabled anywhere in the graph, not just on the edges the search happens to relax.
+     */
+    bool landmarksCover(){
+        if(uncovered_landmark_computes != landmarks->stats_computes || uncovered_history_clears != g.nHistoryClears()
+           || uncovered_history_pos < g.historyStart()){
+            uncovered_landmark_computes = landmarks->stats_computes;
+            uncovered_history_clears = g.nHistoryClears();
+            uncovered_history_pos = g.historySize();
+            n_uncovered = 0;
+            for(int edgeID = 0; edgeID < g.edges(); edgeID++){
+                if(g.hasEdge(edgeID) && g.edgeEnabled(edgeID) && !landmarks->covers(edgeID))
+                    n_uncovered++;
+            }
+        }else{
+            //the history only records edges whose status actually changed
+            for(int i = uncovered_history_pos; i < g.historySize(); i++){
+                auto& change = g.getChange(i);
+                if(!landmarks->covers(change.id)){
+                    if(change.addition)
+                        n_uncovered++;
+                    else if(change.deletion)
+                        n_uncovered--;
+                }
+            }
+            uncovered_history_pos = g.historySize();
+        }
+        assert(n_uncovered >= 0);
+        return n_uncovered == 0;
+    }
+
+    inline void touch(int v){
+        if(dist_f[v] >= inf() && dist_r[v] >= inf())
+            touched.push_back(v);
+    }
+
+    /**
+     * Bidirectional search for the shortest path from the source to t. Returns false (without computing the distance)
+     * if landmarks are in use and an enabled edge was found that they do not cover.
+     */
+    bool bidirectional(int t, bool use_landmarks){
+        int s = source;
+        Dist best = inf();
+        int meet = -1;
+        bool ok = true;
+        Dist bound = 0;
+
+        touch(s);
+        dist_f[s] = 0;
+        key_f[s] = 0;
+        touch(t);
+        dist_r[t] = 0;
+        key_r[t] = 0;
+        if(use_landmarks){
+            if(landmarks->lowerBound(s, t, bound)){
+                key_f[s] = bound;
+                key_r[t] = bound;
+                q_f.insert(s);
+                q_r.insert(t);
+            }//else, t is not reachable from s, and there is nothing to search
+        }else{
+            q_f.insert(s);
+            q_r.insert(t);
+        }
+
+        while(q_f.size() && q_r.size()){
+            int top_f = q_f.peekMin();
+            int top_r = q_r.peekMin();
+            if(use_landmarks){
+                if(key_f[top_f] >= best || key_r[top_r] >= best)
+                    break;
+            }else if(dist_f[top_f] + dist_r[top_r] >= best){
+                break;
+            }
+            stats_nodes_scanned++;
+            if(q_f.size() <= q_r.size()){
+                int u = q_f.removeMin();
+                for(auto& edge:g.incidentEdges(u)){
+                    if(!g.edgeEnabled(edge.id))
+                        continue;
+                    if(use_landmarks && !landmarks->covers(edge.id)){
+                        ok = false;
+                        break;
+                    }
+                    int v = edge.node;
+                    Dist alt = dist_f[u] + weight(edge.id);
+                    if(alt < dist_f[v]){
+                        if(use_landmarks && !landmarks->lowerBound(v, t, bound))
+                            continue;//v cannot reach t
+                        touch(v);
+                        dist_f[v] = alt;
+                        prev_f[v] = edge.id;
+                        key_f[v] = use_landmarks ? alt + bound : alt;
+                        q_f.update(v);
+                        if(dist_r[v] < inf() && alt + dist_r[v] < best){
+                            best = alt + dist_r[v];
+                            meet = v;
+                        }
+                    }
+                }
+            }else{
+                int u = q_r.removeMin();
+                for(auto& edge:g.incomingEdges(u)){
+                    if(!g.edgeEnabled(edge.id))
+                        continue;
+                    if(use_landmarks && !landmarks->covers(edge.id)){
+                        ok = false;
+                        break;
+                    }
+                    int v = edge.node;
+                    Dist alt = dist_r[u] + weight(edge.id);
+                    if(alt < dist_r[v]){
+                        if(use_landmarks && !landmarks->lowerBound(s, v, bound))
+                            continue;//s cannot reach v
+                        touch(v);
+                        dist_r[v] = alt;
+                        prev_r[v] = edge.id;
+                        key_r[v] = use_landmarks ? alt + bound : alt;
+                        q_r.update(v);
+                        if(dist_f[v] < inf() && alt + dist_f[v] < best){
+                            best = alt + dist_f[v];
+                            meet = v;
+                        }
+                    }
+                }
+            }
+            if(!ok)
+                break;
+        }
+        if(ok){
+            finish(t, best, meet);
+        }
+        for(int v:touched){
+            dist_f[v] = inf();
+            dist_r[v] = inf();
+            key_f[v] = inf();
+            key_r[v] = inf();
+            prev_f[v] = -1;
+            prev_r[v] = -1;
+        }
+        touched.clear();
+        q_f.clear();
+        q_r.clear();
+        return ok;
+    }
+
+    //Record the distance to t, and the path through 'meet' in prev (overwriting the previous edges of the nodes on the path).
+    void finish(int t, const Dist& best, int meet){
+        dist[t] = best;
+        dist_version[t] = version;
+        if(meet < 0){
+            prev[t] = -1;
+            return;
+        }
+        int x = meet;
+        while(x != source){
+            int edgeID = prev_f[x];
+            assert(edgeID >= 0);
+            prev[x] = edgeID;
+            x = g.getEdge(edgeID).from;
+        }
+        x = meet;
+        while(x != t){
+            int edgeID = prev_r[x];
+            assert(edgeID >= 0);
+            int y = g.getEdge(edgeID).to;
+            prev[y] = edgeID;
+            x = y;
+        }
+        prev[source] = -1;
+    }
+};
+
+};
+#endif /* BIDIRECTIONAL_DIJKSTRA_H_ */
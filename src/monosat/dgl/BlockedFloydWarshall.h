@@ -0,0 +1,477 @@
+/**************************************************************************************************
+ The MIT License (MIT)
+
+ Copyright (c) 2014, Sam Bayless
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef BLOCKED_FLOYD_WARSHALL_H_
+#define BLOCKED_FLOYD_WARSHALL_H_
+
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include "Graph.h"
+#include "DynamicGraph.h"
+#include "AllPairs.h"
+
+namespace dgl {
+/**
+ * Min-plus kernels for the blocked Floyd-Warshall algorithm, over tiles of a flat, row-major distance matrix
+ * with a parallel matrix of predecessors (pred[i][j] is the node before j on a shortest path from i to j).
+ * The inner loops are branch-free, so that the compiler can vectorize them.
+ */
+template<typename D, int BlockSize = 64>
+struct MinPlusKernel {
+    //Relax tile (bi,bj) through the intermediate nodes of block bk, where tile (bi,bj) may overlap tile (bi,bk) or (bk,bj).
+    static void relax(D* dist, int* pred, size_t stride, size_t bi, size_t bj, size_t bk){
+        for(size_t k = bk; k < bk + BlockSize; k++){
+            const D* dk = dist + k * stride;
+            const int* pk = pred + k * stride;
+            for(size_t i = bi; i < bi + BlockSize; i++){
+                D* di = dist + i * stride;
+                int* pi = pred + i * stride;
+                D dik = di[k];
+                for(size_t j = bj; j < bj + BlockSize; j++){
+                    D d = dik + dk[j];
+                    D dij = di[j];
+                    int pkj = pk[j];
+                    int pij = pi[j];
+                    bool better = d < dij;
+                    di[j] = better ? d : dij;
+                    pi[j] = better ? pkj : pij;
+                }
+            }
+        }
+    }
+
+    //Relax tile (bi,bj) through block bk, where the tile is disjoint from both (bi,bk) and (bk,bj),
+    //so that the order of the intermediate nodes doesn't matter, and the k loop can be innermost but one.
+    static void relaxDisjoint(D* __restrict dist, int* __restrict pred, size_t stride, size_t bi, size_t bj, size_t bk){
+        for(size_t i = bi; i < bi + BlockSize; i++){
+            D* __restrict di = dist + i * stride;
+            int* __restrict pi = pred + i * stride;
+            for(size_t k = bk; k < bk + BlockSize; k++){
+                D dik = di[k];
+                const D* __restrict dk = dist + k * stride;
+                const int* __restrict pk = pred + k * stride;
+                for(size_t j = bj; j < bj + BlockSize; j++){
+                    D d = dik + dk[j];
+                    D dij = di[j];
+                    int pkj = pk[j];
+                    int pij = pi[j];
+                    bool better = d < dij;
+                    di[j] = better ? d : dij;
+                    pi[j] = better ? pkj : pij;
+                }
+            }
+        }
+    }
+};
+
+/**
+ * A reusable barrier for a fixed number of threads (C++11 has no std::barrier).
+ */
+class ThreadBarrier {
+    std::mutex mutex;
+    std::condition_variable cv;
+    const int n_threads;
+    int waiting = 0;
+    int64_t generation = 0;
+public:
+    explicit ThreadBarrier(int n_threads) :
+            n_threads(n_threads){
+    }
+
+    //Blocks until all n_threads threads have called wait() (for this generation).
+    void wait(){
+        std::unique_lock<std::mutex> lock(mutex);
+        int64_t gen = generation;
+        if(++waiting == n_threads){
+            waiting = 0;
+            generation++;
+            cv.notify_all();
+        }else{
+            cv.wait(lock, [this, gen](){
+                return generation != gen;
+            });
+        }
+    }
+};
+
+/**
+ * Cache-blocked Floyd-Warshall all pairs shortest paths (Venkataraman, Sahni, Mukhopadhyaya, 2003), over
+ * unweighted (hop count) distances, as used by the all-pairs reachability detector.
+ *
+ * The matrix is padded to a multiple of the tile size, and for each diagonal tile the algorithm first closes that
+ * tile, then the tiles in its row and column, and then all the remaining tiles, which are independent of each
+ * other and are optionally split across threads.
+ *
+ * Edge additions are applied incrementally, in O(n^2) each, if there are only a few of them, and edge deletions
+ * only recompute the rows whose shortest path trees used a deleted edge; otherwise the matrix is recomputed
+ * from scratch.
+ */
+template<typename Weight, typename Graph = DynamicGraph<Weight>, class Status = AllPairs::NullStatus>
+class BlockedFloydWarshall : public AllPairs {
+public:
+    static const int BlockSize = 64;
+    typedef MinPlusKernel<int, BlockSize> Kernel;
+
+    Graph& g;
+    Status& status;
+    int last_modification = -1;
+    int last_addition = -1;
+    int last_deletion = -1;
+    int history_qhead = 0;
+
+    int last_history_clear = 0;
+
+    std::vector<int> sources;
+    int INF = 0;
+
+    //number of threads to relax independent tiles with
+    int n_threads = 1;
+
+    int n = 0;
+    size_t stride = 0;
+    std::vector<int> dist;
+    std::vector<int> pred;
+    std::vector<bool> edge_enabled;
+    std::vector<int> additions;
+    std::vector<int> deletions;
+    std::vector<bool> affected;
+    std::vector<int> q;
+
+public:
+    int stats_full_updates = 0;
+    int stats_fast_updates = 0;
+    int stats_fast_failed_updates = 0;
+    int stats_skip_deletes = 0;
+    int stats_skipped_updates = 0;
+    int stats_num_skipable_deletions = 0;
+
+    double stats_full_update_time = 0;
+    double stats_fast_update_time = 0;
+
+    //As in FloydWarshall, both reachability polarities are always reported, as bounded distance constraints need the
+    //distances of reachable nodes in the over-approximation, too.
+    BlockedFloydWarshall(Graph& graph, Status& _status = AllPairs::nullStatus, int threads = 1) :
+            g(graph), status(_status), n_threads(std::max(1, threads)){
+    }
+
+    void addSource(int s) override{
+        assert(!std::count(sources.begin(), sources.end(), s));
+        sources.push_back(s);
+
+        last_modification = -1;
+        last_addition = -1;
+        last_deletion = -1;
+    }
+
+    int64_t num_updates = 0;
+
+    int numUpdates() const override{
+        return num_updates;
+    }
+
+private:
+
+    int& d(int i, int j){
+        return dist[i * stride + j];
+    }
+
+    int& p(int i, int j){
+        return pred[i * stride + j];
+    }
+
+    void setNodes(int nodes){
+        n = nodes;
+        stride = ((n + BlockSize - 1) / BlockSize) * BlockSize;
+        INF = n + 1;
+        dist.clear();
+        dist.resize(stride * stride, INF);
+        pred.clear();
+        pred.resize(stride * stride, -1);
+    }
+
+    void recompute(){
+        stats_full_updates++;
+        setNodes(g.nodes());
+        edge_enabled.clear();
+        edge_enabled.resize(g.edges());
+        for(int i = 0; i < n; i++){
+            d(i, i) = 0;
+        }
+        for(int edgeID = 0; edgeID < g.edges(); edgeID++){
+            if(g.hasEdge(edgeID) && g.edgeEnabled(edgeID)){
+                edge_enabled[edgeID] = true;
+                int u = g.getEdge(edgeID).from;
+                int v = g.getEdge(edgeID).to;
+                if(u != v){
+                    d(u, v) = 1;
+                    p(u, v) = u;
+                }
+            }
+        }
+        if(n == 0)
+            return;
+        size_t blocks = stride / BlockSize;
+        int threads = std::min((size_t) n_threads, blocks);
+        if(threads <= 1 || blocks <= 2){
+            for(size_t kb = 0; kb < blocks; kb++){
+                relaxCross(kb, blocks);
+                relaxRows(kb, 0, blocks, blocks);
+            }
+        }else{
+            //A single parallel region for the whole recompute, with each thread taking a contiguous range of tile rows.
+            //The first thread also closes each diagonal tile and its row and column, which the other tiles depend on.
+            size_t per_thread = (blocks + threads - 1) / threads;
+            threads = (blocks + per_thread - 1) / per_thread;
+            ThreadBarrier barrier(threads);
+            auto worker = [this, blocks, per_thread, &barrier](size_t start){
+                size_t end = std::min(blocks, start + per_thread);
+                for(size_t kb = 0; kb < blocks; kb++){
+                    if(start == 0)
+                        relaxCross(kb, blocks);
+                    barrier.wait();
+                    relaxRows(kb, start, end, blocks);
+                    barrier.wait();
+                }
+            };
+            std::vector<std::thread> workers;
+            for(size_t start = per_thread; start < blocks; start += per_thread){
+                workers.push_back(std::thread(worker, start));
+            }
+            assert(workers.size() + 1 == (size_t) threads);
+            worker(0);
+            for(std::thread& t:workers){
+                t.join();
+            }
+        }
+    }
+
+    //Close diagonal tile kb, and then the tiles in its row and column.
+    void relaxCross(size_t kb, size_t blocks){
+        int* D = dist.data();
+        int* P = pred.data();
+        size_t bk = kb * BlockSize;
+        Kernel::relax(D, P, stride, bk, bk, bk);
+        for(size_t b = 0; b < blocks; b++){
+            if(b != kb){
+                Kernel::relax(D, P, stride, bk, b * BlockSize, bk);
+                Kernel::relax(D, P, stride, b * BlockSize, bk, bk);
+            }
+        }
+    }
+
+    //Relax the tiles in tile rows [start,end) that are outside of the row and column of diagonal tile kb.
+    void relaxRows(size_t kb, size_t start, size_t end, size_t blocks){
+        size_t bk = kb * BlockSize;
+        for(size_t ib = start; ib < end; ib++){
+            if(ib == kb)
+                continue;
+            for(size_t jb = 0; jb < blocks; jb++){
+                if(jb == kb)
+                    continue;
+                Kernel::relaxDisjoint(dist.data(), pred.data(), stride, ib * BlockSize, jb * BlockSize, bk);
+            }
+        }
+    }
+
+    //Recompute the distances from s with a breadth first search.
+    void recomputeRow(int s){
+        int* ds = &dist[s * stride];
+        int* ps = &pred[s * stride];
+        std::fill(ds, ds + n, INF);
+        std::fill(ps, ps + n, -1);
+        ds[s] = 0;
+        q.clear();
+        q.push_back(s);
+        for(int i = 0; i < q.size(); i++){
+            int u = q[i];
+            for(int j = 0; j < g.nIncident(u); j++){
+                int v = g.incident(u, j).node;
+                if(ds[v] == INF && g.edgeEnabled(g.incident(u, j).id)){
+                    ds[v] = ds[u] + 1;
+                    ps[v] = u;
+                    q.push_back(v);
+                }
+            }
+        }
+    }
+
+    //Relax all pairs through a newly enabled edge from u to v.
+    void insertEdge(int u, int v){
+        if(u == v)
+            return;
+        const int* dv = &dist[v * stride];
+        const int* pv = &pred[v * stride];
+        for(int i = 0; i < n; i++){
+            int diu = d(i, u);
+            if(diu >= INF)
+                continue;
+            int* di = &dist[i * stride];
+            int* pi = &pred[i * stride];
+            //row v is unchanged by this loop, as a path through (u,v) can't shorten a path starting at v
+            for(int j = 0; j < n; j++){
+                int nd = diu + 1 + dv[j];
+                if(nd < di[j]){
+                    di[j] = nd;
+                    pi[j] = j == v ? u : pv[j];
+                }
+            }
+        }
+    }
+
+public:
+
+    void update() override{
+        if(last_modification > 0 && g.getCurrentHistory() == last_modification){
+            stats_skipped_updates++;
+            return;
+        }
+
+        if(last_deletion == g.nDeletions()){
+            stats_num_skipable_deletions++;
+        }
+
+        bool full = last_modification <= 0 || g.changed() || n != g.nodes()
+                    || g.nHistoryClears() != last_history_clear || history_qhead < g.historyStart();
+        additions.clear();
+        deletions.clear();
+        if(!full){
+            for(int i = history_qhead; i < g.historySize(); i++){
+                int edgeID = g.getChange(i).id;
+                if(g.edgeEnabled(edgeID) != edge_enabled[edgeID]){
+                    if(edge_enabled[edgeID]){
+                        deletions.push_back(edgeID);
+                    }else{
+                        additions.push_back(edgeID);
+                    }
+                    edge_enabled[edgeID] = g.edgeEnabled(edgeID);
+                }
+            }
+            //each insertion costs O(n^2), against O(n^3) for a full recomputation
+            if(additions.size() > n / 16){
+                full = true;
+            }
+        }
+        if(!full && deletions.size()){
+            //a deleted edge (u,v) can only lengthen the paths from row i if it is in row i's shortest path tree,
+            //that is, if u is the predecessor of v in that row. Those rows are recomputed with a breadth first search,
+            //unless that would cost more than re-running the (vectorized) blocked algorithm.
+            affected.clear();
+            affected.resize(n, false);
+            int n_affected = 0;
+            for(int edgeID:deletions){
+                int u = g.getEdge(edgeID).from;
+                int v = g.getEdge(edgeID).to;
+                if(u == v)
+                    continue;
+                for(int i = 0; i < n; i++){
+                    if(!affected[i] && p(i, v) == u){
+                        affected[i] = true;
+                        n_affected++;
+                    }
+                }
+            }
+            if((int64_t) n_affected * (n + g.edges()) * BlockSize > (int64_t) n * n * n){
+                full = true;
+            }else{
+                for(int i = 0; i < n; i++){
+                    if(affected[i])
+                        recomputeRow(i);
+                }
+            }
+        }
+        if(full){
+            recompute();
+        }else{
+            stats_fast_updates++;
+            for(int edgeID:additions){
+                insertEdge(g.getEdge(edgeID).from, g.getEdge(edgeID).to);
+            }
+        }
+
+        for(int s:sources){
+            for(int u = 0; u < n; u++){
+                int du = d(s, u);
+                if(du >= INF){
+                    status.setReachable(s, u, false);
+                    status.setMininumDistance(s, u, false, INF);
+                }else{
+                    status.setReachable(s, u, true);
+                    status.setMininumDistance(s, u, true, du);
+                }
+            }
+        }
+        num_updates++;
+        last_modification = g.getCurrentHistory();
+        last_deletion = g.nDeletions();
+        last_addition = g.nAdditions();
+
+        history_qhead = g.historySize();
+        last_history_clear = g.nHistoryClears();
+    }
+
+    //Return the nodes of a shortest path from 'from' to 'to'
+    void getPath(int from, int to, std::vector<int>& path) override{
+        update();
+        assert(d(from, to) < INF);
+        path.clear();
+        for(int u = to; u != from; u = p(from, u)){
+            assert(u >= 0);
+            path.push_back(u);
+        }
+        path.push_back(from);
+        std::reverse(path.begin(), path.end());
+    }
+
+    bool connected_unsafe(int from, int t) override{
+        return from < n && t < n && d(from, t) < INF;
+    }
+
+    bool connected_unchecked(int from, int t) override{
+        assert(last_modification == g.getCurrentHistory());
+        return connected_unsafe(from, t);
+    }
+
+    bool connected(int from, int t) override{
+        if(last_modification != g.getCurrentHistory())
+            update();
+        return d(from, t) < INF;
+    }
+
+    int distance(int from, int t) override{
+        if(connected(from, t))
+            return d(from, t);
+        else
+            return INF;
+    }
+
+    int distance_unsafe(int from, int t) override{
+        if(connected_unsafe(from, t))
+            return d(from, t);
+        else
+            return INF;
+    }
+};
+};
+#endif
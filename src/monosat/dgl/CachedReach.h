@@ -114,6 +114,10 @@ public:
     std::vector<int> previous_edge;
     bool has_non_reach_destinations = false;
     bool needs_recompute = true;
+    std::vector<char> inactive_target;
+    //destinations that were inactive and not (yet) reached by the inner reach at the last recompute;
+    //whether they are connected is only settled if they are asked about
+    std::vector<char> unsettled;
 
 
     void clearCache() override{
@@ -131,6 +135,16 @@ public:
 
     }
 
+    void setTargetActive(int node, bool active) override{
+        if(node >= inactive_target.size())
+            inactive_target.resize(node + 1, false);
+        inactive_target[node] = !active;
+        reach->setTargetActive(node, active);
+        if(active && node < unsettled.size() && unsettled[node]){
+            needs_recompute = true;
+        }
+    }
+
     void printStats() override{
         reach->printStats();
         printf("Cached Reach Recomputes: %" PRId64 "\n", stats_n_recomputes);
@@ -153,7 +167,7 @@ public:
         edge_in_path.clear();//clear and rebuild the path tree
         int source = getSource();
         assert(previous_edge[source] == -1);
-        static int iter = 0;
+        static thread_local int iter = 0;
         if(++iter == 25){
             int a = 1;
         };
@@ -164,44 +178,26 @@ public:
             stats_random_shortest_paths++;
         }
 
+        unsettled.clear();
+        unsettled.resize(g.nodes(), false);
         for(int d:destinations){
 
             if(d == getSource()){
                 has_path_to[d] = true;
                 continue;
             }
-
-            if(reach->connected(d)){
+            bool inactive = d < inactive_target.size() && inactive_target[d];
+            if(inactive ? reach->connected_unchecked(d) : reach->connected(d)){
                 has_path_to[d] = true;
                 if(reportPolarity >= 0){
                     status.setReachable(d, true);
                 }
-                //extract path
-                bool randomShortestEdge = randomShortestPath || (alg::drand(random_seed) < randomShortestEdgeFrequency);
-                if(randomShortestEdge && !randomShortestPath){
-                    stats_random_shortest_edges++;
-                }
-                int edgeID = randomShortestEdge ? reach->randomIncomingEdge(d, random_seed) : reach->incomingEdge(d);
-                assert(edgeID >= 0);
-                int p = d;
-                while(!edge_in_path.has(edgeID)){
-                    assert(edgeID >= 0);
-                    previous_edge[p] = edgeID;//do not need to reset previous_edge vector here; instead we allow it to contain incorrect values on the assumption they will be corrected before being accessed
-
-                    edge_in_path.insert(edgeID);
-                    p = g.getEdge(edgeID).from;
-                    if(p == source){
-                        edgeID = -1;
-                        break;
-                    }
-                    randomShortestEdge = randomShortestPath || (alg::drand(random_seed) < randomShortestEdgeFrequency);
-                    if(randomShortestEdge && !randomShortestPath){
-                        stats_random_shortest_edges++;
-                    }
-                    edgeID = randomShortestEdge ? reach->randomIncomingEdge(p, random_seed) : reach->incomingEdge(p);
-                    assert(edgeID >= 0);
-                }
-                assert(randomShortestPath || previous_edge[p] == edgeID);
+                cachePath(d, randomShortestPath);
+            }else if(inactive){
+                has_path_to[d] = false;
+                previous_edge[d] = -1;
+                has_non_reach_destinations = true;
+                unsettled[d] = true;
             }else{
                 has_path_to[d] = false;
                 previous_edge[d] = -1;
@@ -222,8 +218,39 @@ public:
         last_history_clear = g.nHistoryClears();
     }
 
+    //Record the path to d (which must be reachable) found by the inner reach, in previous_edge and edge_in_path.
+    void cachePath(int d, bool randomShortestPath){
+        int source = getSource();
+        //extract path
+        bool randomShortestEdge = randomShortestPath || (alg::drand(random_seed) < randomShortestEdgeFrequency);
+        if(randomShortestEdge && !randomShortestPath){
+            stats_random_shortest_edges++;
+        }
+        int edgeID = randomShortestEdge ? reach->randomIncomingEdge(d, random_seed) : reach->incomingEdge(d);
+        assert(edgeID >= 0);
+        int p = d;
+        while(!edge_in_path.has(edgeID)){
+            assert(edgeID >= 0);
+            previous_edge[p] = edgeID;//do not need to reset previous_edge vector here; instead we allow it to contain incorrect values on the assumption they will be corrected before being accessed
+
+            edge_in_path.insert(edgeID);
+            p = g.getEdge(edgeID).from;
+            if(p == source){
+                edgeID = -1;
+                break;
+            }
+            randomShortestEdge = randomShortestPath || (alg::drand(random_seed) < randomShortestEdgeFrequency);
+            if(randomShortestEdge && !randomShortestPath){
+                stats_random_shortest_edges++;
+            }
+            edgeID = randomShortestEdge ? reach->randomIncomingEdge(p, random_seed) : reach->incomingEdge(p);
+            assert(edgeID >= 0);
+        }
+        assert(randomShortestPath || previous_edge[p] == edgeID);
+    }
+
     void update() override{
-        static int iteration = 0;
+        static thread_local int iteration = 0;
         int local_it = ++iteration;
 
         if(!needs_recompute && last_modification > 0 && g.getCurrentHistory() == last_modification){
@@ -245,9 +272,9 @@ public:
 
         }
 
-        if(!needs_recompute && last_history_clear != g.nHistoryClears()){
+        if(!needs_recompute && (last_history_clear != g.nHistoryClears() || history_qhead < g.historyStart())){
             if(!g.changed() && last_history_clear >= 0 && last_history_clear == g.nHistoryClears() - 1 &&
-               history_qhead == g.getPreviousHistorySize()){
+               history_qhead == g.getPreviousHistorySize() && g.historyStart() == 0){
                 //no information was lost in the history clear
                 history_qhead = 0;
                 last_history_clear = g.nHistoryClears();
@@ -323,6 +350,13 @@ public:
     bool connected(int t) override{
         //if (last_modification != g.getCurrentHistory())
         update();
+        if(t < unsettled.size() && unsettled[t]){
+            unsettled[t] = false;
+            if(reach->connected(t)){
+                has_path_to[t] = true;
+                cachePath(t, false);
+            }
+        }
         return has_path_to[t];
     }
 
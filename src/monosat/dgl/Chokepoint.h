@@ -27,8 +27,10 @@
  OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  **************************************************************************************************/
 
+#include <vector>
 #include "Graph.h"
 #include "DynamicGraph.h"
+#include "DominatorTree.h"
 #include "Reach.h"
 
 namespace dgl {
@@ -38,156 +40,65 @@ struct ForceReason {
     int node;
 };
 
+/**
+ * Finds the edges that must be enabled for the source to reach each node that must be reached:
+ * these are exactly the edges that dominate that node in the dominator tree of the edge-split graph,
+ * so a single dominator tree computation covers every such node.
+ *
+ * EdgeStatus must provide mustReach(node), and operator()(edgeID), which is true for edges that are candidates
+ * to be forced (for example, edges that are not yet assigned).
+ */
 template<typename Weight, typename Graph = DynamicGraph <Weight>, class EdgeStatus= typename Reach::NullStatus>
 class Chokepoint {
 
     Graph& g;
     EdgeStatus& status;
     int source;
-    std::vector<int> current;
-    std::vector<int> prev;
-    std::vector<int> queue;
-    std::vector<int> dist;
-    std::vector<bool> in_queue;
-
-    static const int SOURCE = -3;
-    static const int UNDEF = -2;
-    static const int EMPTY = -1;
+    //the last node that each vertex of the edge-split graph was visited from, in collectForcedEdges
+    std::vector<int> visited;
+    int visit_stamp = 0;
 public:
+    DominatorTree<Weight, Graph> dominators;
+
     Chokepoint(EdgeStatus& _status, Graph& _graph, int _source) :
-            g(_graph), status(_status), source(_source){
+            g(_graph), status(_status), source(_source), dominators(_source, _graph){
 
     }
 
     void update(){
-
-        in_queue.clear();
-        queue.clear();
-
-        current.resize(g.nodes());
-        prev.resize(g.nodes());
-        dist.resize(g.nodes());
-        in_queue.resize(g.nodes());
-
-        for(int i = 0; i < g.nodes(); i++){
-            prev[i] = UNDEF;
-            current[i] = UNDEF;
-            dist[i] = UNDEF;
-        }
-
-        prev[source] = SOURCE;
-        current[source] = SOURCE;
-        dist[source] = 0;
-
-        in_queue[source] = 1;
-        queue.push_back(source);
-
-        for(int i = 0; i < queue.size(); i++){
-            int u = queue[i];
-
-            int old_dist = dist[u];
-
-            assert(in_queue[u]);
-
-            if(u == source){
-                //a better way to model this would be to give the source node an extra incoming edge
-            }else{
-                in_queue[u] = false;
-                current[u] = UNDEF;
-                prev[u] = UNDEF;
-
-                for(int j = 0; j < g.nIncoming(u); j++){
-                    int from = g.incoming(u, j).node;
-                    int id = g.incoming(u, j).id;
-                    if(!g.edgeEnabled(id))
-                        continue;
-
-                    //From does not (yet) have a path from source (if it later gets one, then u will be re-added to the queue and re-processed
-                    if(prev[from] == UNDEF)
-                        continue;
-
-                    if(prev[u] == UNDEF){
-                        prev[u] = from;
-                        if(status(id)){
-                            //then this edge is a candidate edge
-                            current[u] = id;
-                        }else{
-                            current[u] = UNDEF;
-                        }
-                        dist[u] = dist[from] + 1;
-
-                        continue;
-                    }
-
-                    //compare the incoming list to the previous list.
-                    //First, make the distances equal
-                    while(dist[u] > dist[from] + 1){
-                        prev[u] = prev[prev[u]];
-                        dist[u]--;
-                        assert(dist[i] == dist[prev[u]] + 1);
-                    }
-
-                    while(dist[u] >= 0 && dist[from] > dist[u]){
-                        from = prev[from];
-                    }
-
-                    //now, backtrack in both linked lists until they have the same current element
-                    while(current[u] != current[from]){
-                        prev[u] = prev[prev[u]];
-                        dist[u]--;
-                        assert(dist[u] >= 0);
-                        from = prev[from];
-                        assert(dist[i] == dist[prev[u]] + 1);
-                    }
-
-                    assert(dist[u] >= 0);
-
-                }
-            }
-            //ok, if we changed anything, update all outgoing.edges()
-
-            if(dist[u] != old_dist || u == source){
-                assert(dist[u] >= 0);
-
-                for(int j = 0; j < g.nIncident(u); j++){
-                    int to = g.incident(u, j).node;
-                    int id = g.incident(u, j).id;
-                    if(!g.edgeEnabled(id))
-                        continue;
-
-                    if(!in_queue[to]){
-                        queue.push_back(to);
-                        in_queue[to] = true;
-                    }
-
-                }
-
-            }
-
-        }
-
+        dominators.update();
     }
 
     void collectForcedEdges(std::vector<ForceReason>& forced_ids){
         update();
+        int nv = g.nodes() + g.edges();
+        if(visited.size() != nv){
+            visited.clear();
+            visited.resize(nv, 0);
+            visit_stamp = 0;
+        }
+        visit_stamp++;
         for(int i = 0; i < g.nodes(); i++){
-            if(status.mustReach(i)){
-                int u = i;
-                while(prev[u] >= 0){
-                    if(current[u] != UNDEF){
-                        forced_ids.push_back({current[u], i});
-                        current[u] = UNDEF;
+            if(status.mustReach(i) && dominators.reachable(i)){
+                //walk up the dominator tree, stopping at vertices that have already been walked from another node
+                for(int v = dominators.idom[i]; v >= 0 && visited[v] != visit_stamp; v = dominators.idom[v]){
+                    visited[v] = visit_stamp;
+                    if(dominators.isEdgeVertex(v) && status(dominators.getEdge(v))){
+                        forced_ids.push_back({dominators.getEdge(v), i});
                     }
-                    int v = prev[u];
-                    prev[u] = UNDEF;
-                    u = v;
                 }
             }
         }
     }
 
+    //Collect the edges that every path from the source to 'to' must use, nearest to 'to' first.
+    void collectChokepointEdges(int to, std::vector<int>& store){
+        update();
+        if(dominators.reachable(to))
+            dominators.getDominatingEdges(to, store);
+    }
+
 };
 
 };
 #endif
-
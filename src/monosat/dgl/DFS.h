@@ -218,11 +218,11 @@ public:
             //if(!old_seen[u]){
             //	changed.push_back(u);
             //}
-            for(int i = 0; i < g.nIncident(u, undirected); i++){
-                if(!g.edgeEnabled(g.incident(u, i, undirected).id))
+            for(auto& edge:g.incidentEdges(u, undirected)){
+                if(!g.edgeEnabled(edge.id))
                     continue;
-                int v = g.incident(u, i, undirected).node;
-                int edgeID = g.incident(u, i, undirected).id;
+                int v = edge.node;
+                int edgeID = edge.id;
                 if(!seen[v]){
                     seen[v] = 1;
                     prev[v] = edgeID;
@@ -246,11 +246,11 @@ public:
             q.pop_back();
             assert(!seen[u]);
 
-            for(int i = 0; i < g.nIncident(u, undirected); i++){
-                /*				if(!g.edgeEnabled( g.incident(u,i).id))
+            for(auto& edge:g.incidentEdges(u, undirected)){
+                /*				if(!g.edgeEnabled( edge.id))
                  continue;*/
-                int v = g.incident(u, i, undirected).node;
-                int edgeID = g.incident(u, i, undirected).id;
+                int v = edge.node;
+                int edgeID = edge.id;
                 if(seen[v] && previous(v) == u){
                     seen[v] = 0;
                     prev[v] = -1;
@@ -265,11 +265,11 @@ public:
         for(int i = 0; i < check.size(); i++){
             int u = check[i];
             if(!seen[u]){
-                for(int i = 0; i < g.nIncoming(u, undirected); i++){
-                    if(g.edgeEnabled(g.incoming(u, i, undirected).id)){
-                        int from = g.incoming(u, i, undirected).node;
+                for(auto& edge:g.incomingEdges(u, undirected)){
+                    if(g.edgeEnabled(edge.id)){
+                        int from = edge.node;
                         int to = u;
-                        int edgeID = g.incoming(u, i, undirected).id;
+                        int edgeID = edge.id;
                         if(seen[from]){
                             seen[to] = 1;
                             prev[to] = edgeID;
@@ -285,9 +285,9 @@ public:
 
     bool update_additions(){
 
-        if(g.nHistoryClears() != last_history_clear){
+        if(g.nHistoryClears() != last_history_clear || history_qhead < g.historyStart()){
             last_history_clear = g.nHistoryClears();
-            history_qhead = 0;
+            history_qhead = g.historyStart();
         }
 
         assert(INF > g.nodes());
@@ -346,9 +346,9 @@ public:
 
     bool incrementalUpdate(){
 
-        if(g.nHistoryClears() != last_history_clear){
+        if(g.nHistoryClears() != last_history_clear || history_qhead < g.historyStart()){
             last_history_clear = g.nHistoryClears();
-            history_qhead = 0;
+            history_qhead = g.historyStart();
         }
 
         assert(INF > g.nodes());
@@ -414,7 +414,7 @@ public:
     }
 
     void update() override{
-        static int iteration = 0;
+        static thread_local int iteration = 0;
         int local_it = ++iteration;
 
         if(last_modification > 0 && g.getCurrentHistory() == last_modification){
@@ -436,9 +436,9 @@ public:
 
         setNodes(g.nodes());
 
-        if(g.nHistoryClears() != last_history_clear){
+        if(g.nHistoryClears() != last_history_clear || history_qhead < g.historyStart()){
             last_history_clear = g.nHistoryClears();
-            history_qhead = 0;
+            history_qhead = g.historyStart();
         }else if(opt_inc_graph && last_modification > 0 && (g.nHistoryClears() <= (last_history_clear +
                                                                                    1))){// && (g.history.size()-history_qhead < g.edges()*mod_percentage)){
             if(opt_dec_graph == 2){
@@ -506,11 +506,11 @@ public:
             if(reportPolarity == 1)
                 status.setReachable(u, true);
 
-            for(int i = 0; i < g.nIncident(u, undirected); i++){
-                if(!g.edgeEnabled(g.incident(u, i, undirected).id))
+            for(auto& edge:g.incidentEdges(u, undirected)){
+                if(!g.edgeEnabled(edge.id))
                     continue;
-                int v = g.incident(u, i, undirected).node;
-                int edgeid = g.incident(u, i, undirected).id;
+                int v = edge.node;
+                int edgeid = edge.id;
                 if(!seen[v]){
                     seen[v] = 1;
                     prev[v] = edgeid;
@@ -574,9 +574,9 @@ public:
         }
 
         for(int i = 0; i < g.nodes(); i++){
-            for(int j = 0; j < g.nIncident(i); j++){
-                int id = g.incident(i, j).id;
-                int u = g.incident(i, j).node;
+            for(auto& edge:g.incidentEdges(i)){
+                int id = edge.id;
+                int u = edge.node;
                 const char* s = "black";
                 if(g.edgeEnabled(id))
                     s = "blue";
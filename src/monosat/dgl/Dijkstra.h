@@ -24,6 +24,7 @@
 
 #include <vector>
 #include "monosat/dgl/alg/Heap.h"
+#include "monosat/dgl/alg/RadixHeap.h"
 #include "Graph.h"
 #include "DynamicGraph.h"
 #include "Reach.h"
@@ -31,6 +32,7 @@
 #include "Distance.h"
 #include "monosat/core/Config.h"
 #include <limits>
+#include <type_traits>
 
 namespace dgl {
 
@@ -71,8 +73,12 @@ public:
     };
 
     alg::Heap<DistCmp> q;
+    alg::RadixHeap radix_q;
 
 public:
+    //If true, and Weight is an integral type, full updates use a radix heap instead of a binary heap
+    //(falling back on the binary heap if a negative edge weight is found).
+    bool opt_radix_heap = false;
 
     int stats_full_updates = 0;
     int stats_fast_updates = 0;
@@ -123,7 +129,7 @@ public:
     }
 
     void update() override{
-        static int iteration = 0;
+        static thread_local int iteration = 0;
         int local_it = ++iteration;
 
         if(last_modification > 0 && g.getCurrentHistory() == last_modification)
@@ -132,11 +138,13 @@ public:
         if(last_addition == g.nAdditions() && last_edge_inc == g.lastEdgeIncrease() &&
            last_edge_dec == g.lastEdgeDecrease() && last_modification > 0){
             //if none of the deletions were to edges that were the previous edge of some shortest path, then we don't need to do anything
-            if(last_history_clear != g.nHistoryClears()){
-                history_qhead = 0;
+            bool need_recompute = false;
+            if(last_history_clear != g.nHistoryClears() || history_qhead < g.historyStart()){
+                //the deletions can't be checked if they were cleared from the history
+                need_recompute = true;
+                history_qhead = g.historySize();
                 last_history_clear = g.nHistoryClears();
             }
-            bool need_recompute = false;
             //ok, now check if any of the added edges allow for a decrease in distance.
             for(int i = history_qhead; i < g.historySize(); i++){
                 assert(!g.getChange(i).addition);
@@ -194,28 +202,30 @@ public:
         }
 
         dist[source] = 0;
-        q.insert(source);
-        while(q.size()){
-            int u = q.peekMin();
-            if(dist[u] == inf())
-                break;
-            /*if(old_dist[u]>=inf()){
-             changed.push_back(u);
-             }*/
-            q.removeMin();
-            for(int i = 0; i < g.nIncident(u, undirected); i++){
-                if(!g.edgeEnabled(g.incident(u, i, undirected).id))
-                    continue;
-                int edgeID = g.incident(u, i, undirected).id;
-                int v = g.incident(u, i, undirected).node;
-                Weight alt = dist[u] + g.getWeight(edgeID);
-                if(alt < dist[v]){
-                    dist[v] = alt;
-                    prev[v] = edgeID;
-                    if(!q.inHeap(v))
-                        q.insert(v);
-                    else
-                        q.decrease(v);
+        if(!opt_radix_heap || !radix_update(std::is_integral<Weight>())){
+            q.insert(source);
+            while(q.size()){
+                int u = q.peekMin();
+                if(dist[u] == inf())
+                    break;
+                /*if(old_dist[u]>=inf()){
+                 changed.push_back(u);
+                 }*/
+                q.removeMin();
+                for(auto& edge:g.incidentEdges(u, undirected)){
+                    if(!g.edgeEnabled(edge.id))
+                        continue;
+                    int edgeID = edge.id;
+                    int v = edge.node;
+                    Weight alt = dist[u] + g.getWeight(edgeID);
+                    if(alt < dist[v]){
+                        dist[v] = alt;
+                        prev[v] = edgeID;
+                        if(!q.inHeap(v))
+                            q.insert(v);
+                        else
+                            q.decrease(v);
+                    }
                 }
             }
         }
@@ -241,6 +251,44 @@ public:
 
     }
 
+    bool radix_update(std::false_type){
+        return false;
+    }
+
+    //Computes dist and prev using a radix heap, returning false (with dist and prev reset) if a negative weight is found.
+    bool radix_update(std::true_type){
+        radix_q.clear();
+        radix_q.insert(0, source);
+        while(!radix_q.empty()){
+            uint64_t d = radix_q.peekMinKey();
+            int u = radix_q.removeMin();
+            if(d != (uint64_t) dist[u])
+                continue;//a stale entry for a node whose distance has since decreased
+            for(auto& edge:g.incidentEdges(u, undirected)){
+                if(!g.edgeEnabled(edge.id))
+                    continue;
+                int edgeID = edge.id;
+                int v = edge.node;
+                Weight w = g.getWeight(edgeID);
+                if(w < 0){
+                    for(int i = 0; i < g.nodes(); i++){
+                        dist[i] = inf();
+                        prev[i] = -1;
+                    }
+                    dist[source] = 0;
+                    return false;
+                }
+                Weight alt = dist[u] + w;
+                if(alt < dist[v]){
+                    dist[v] = alt;
+                    prev[v] = edgeID;
+                    radix_q.insert(alt, v);
+                }
+            }
+        }
+        return true;
+    }
+
     bool dbg_path(int to){
 #ifdef DEBUG_DIJKSTRA
         assert(connected(to));
@@ -446,8 +494,12 @@ public:
     };
 
     alg::Heap<DistCmp> q;
+    std::vector<int> bucket_q;
 
 public:
+    //If true, full updates use a FIFO queue instead of a binary heap.
+    //With every edge weight equal to one, this is a bucket queue (Dial's algorithm) with a single bucket.
+    bool opt_radix_heap = false;
 
     int stats_full_updates = 0;
     int stats_fast_updates = 0;
@@ -496,7 +548,7 @@ public:
     }
 
     void update() override{
-        static int iteration = 0;
+        static thread_local int iteration = 0;
         int local_it = ++iteration;
 
         if(last_modification > 0 && g.getCurrentHistory() == last_modification)
@@ -504,11 +556,13 @@ public:
 
         if(last_addition == g.nAdditions() && last_modification > 0){
             //if none of the deletions were to edges that were the previous edge of some shortest path, then we don't need to do anything
-            if(last_history_clear != g.nHistoryClears()){
-                history_qhead = 0;
+            bool need_recompute = false;
+            if(last_history_clear != g.nHistoryClears() || history_qhead < g.historyStart()){
+                //the deletions can't be checked if they were cleared from the history
+                need_recompute = true;
+                history_qhead = g.historySize();
                 last_history_clear = g.nHistoryClears();
             }
-            bool need_recompute = false;
             //ok, now check if any of the added edges allow for a decrease in distance.
             for(int i = history_qhead; i < g.historySize(); i++){
                 assert(!g.getChange(i).addition);
@@ -571,28 +625,47 @@ public:
         }
 
         dist[source] = 0;
-        q.insert(source);
-        while(q.size()){
-            int u = q.peekMin();
-            if(dist[u] == inf())
-                break;
-            /*if(old_dist[u]>=inf()){
-             changed.push_back(u);
-             }*/
-            q.removeMin();
-            for(int i = 0; i < g.nIncident(u, undirected); i++){
-                if(!g.edgeEnabled(g.incident(u, i, undirected).id))
-                    continue;
-                int edgeID = g.incident(u, i, undirected).id;
-                int v = g.incident(u, i, undirected).node;
-                int alt = dist[u] + 1;
-                if(alt < dist[v]){
-                    dist[v] = alt;
-                    prev[v] = edgeID;
-                    if(!q.inHeap(v))
-                        q.insert(v);
-                    else
-                        q.decrease(v);
+        if(opt_radix_heap){
+            bucket_q.clear();
+            bucket_q.push_back(source);
+            for(int i = 0; i < bucket_q.size(); i++){
+                int u = bucket_q[i];
+                for(auto& edge:g.incidentEdges(u, undirected)){
+                    if(!g.edgeEnabled(edge.id))
+                        continue;
+                    int v = edge.node;
+                    int alt = dist[u] + 1;
+                    if(alt < dist[v]){
+                        dist[v] = alt;
+                        prev[v] = edge.id;
+                        bucket_q.push_back(v);
+                    }
+                }
+            }
+        }else{
+            q.insert(source);
+            while(q.size()){
+                int u = q.peekMin();
+                if(dist[u] == inf())
+                    break;
+                /*if(old_dist[u]>=inf()){
+                 changed.push_back(u);
+                 }*/
+                q.removeMin();
+                for(auto& edge:g.incidentEdges(u, undirected)){
+                    if(!g.edgeEnabled(edge.id))
+                        continue;
+                    int edgeID = edge.id;
+                    int v = edge.node;
+                    int alt = dist[u] + 1;
+                    if(alt < dist[v]){
+                        dist[v] = alt;
+                        prev[v] = edgeID;
+                        if(!q.inHeap(v))
+                            q.insert(v);
+                        else
+                            q.decrease(v);
+                    }
                 }
             }
         }
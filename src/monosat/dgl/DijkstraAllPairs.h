@@ -129,7 +129,7 @@ public:
     }
 
     void update() override{
-        static int iteration = 0;
+        static thread_local int iteration = 0;
         int local_it = ++iteration;
         stats_full_updates++;
 
@@ -121,7 +121,7 @@ public:
     void dbg_print_graph(int from, int to){
 #ifdef DEBUG_DGL
         return;
-        static int it = 0;
+        static thread_local int it = 0;
         if (++it == 6) {
             int a = 1;
         }
@@ -164,21 +164,21 @@ public:
         //Build the level graph using a simple BFS
         for(int i = 0; i < Q.size(); i++){
             int u = Q[i];
-            for(int j = 0; j < g.nIncident(u); j++){
-                int edgeID = g.incident(u, j).id;
+            for(auto& edge:g.incidentEdges(u)){
+                int edgeID = edge.id;
                 if(!g.edgeEnabled(edgeID))
                     continue;
-                int v = g.incident(u, j).node;
+                int v = edge.node;
                 if(dist[v] < 0 && F[edgeID] < g.getWeight(edgeID)){
                     dist[v] = dist[u] + 1;
                     Q.push_back(v);
                 }
             }
-            for(int j = 0; j < g.nIncoming(u); j++){
-                int edgeID = g.incoming(u, j).id;
+            for(auto& edge:g.incomingEdges(u)){
+                int edgeID = edge.id;
                 if(!g.edgeEnabled(edgeID))
                     continue;
-                int v = g.incoming(u, j).node;
+                int v = edge.node;
                 //this is a backward edge, so it has capacity exactly if the forward edge has flow
                 if(dist[v] < 0 && F[edgeID] > 0){
                     dist[v] = dist[u] + 1;
@@ -496,11 +496,11 @@ public:
         for(int j = 0; j < Q.size(); j++){
             int u = Q[j];
 
-            for(int i = 0; i < g.nIncident(u); i++){
-                if(!g.edgeEnabled(g.incident(u, i).id))
+            for(auto& edge:g.incidentEdges(u)){
+                if(!g.edgeEnabled(edge.id))
                     continue;
-                int v = g.incident(u, i).node;
-                int id = g.incident(u, i).id;
+                int v = edge.node;
+                int id = edge.id;
                 if(g.getWeight(id) - F[id] == 0){
                     cut.push_back(MaxFlowEdge{u, v, id});        //potential element of the cut
                 }else if(!seen[v]){
@@ -508,11 +508,11 @@ public:
                     seen[v] = true;
                 }
             }
-            for(int i = 0; i < g.nIncoming(u); i++){
-                if(!g.edgeEnabled(g.incoming(u, i).id))
+            for(auto& edge:g.incomingEdges(u)){
+                if(!g.edgeEnabled(edge.id))
                     continue;
-                int v = g.incoming(u, i).node;
-                int id = g.incoming(u, i).id;
+                int v = edge.node;
+                int id = edge.id;
                 if(F[id] == 0){
 
                 }else if(!seen[v]){
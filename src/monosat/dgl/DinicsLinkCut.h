@@ -368,8 +368,6 @@ public:
                     }
                     assert(forest.findRoot(src) == forest.findRoot(v));
                 }
-                static int iter = 0;
-                ++iter;
                 toLink.clear();
                 dbg_print_graph(src, dst);
                 assert(forest.findRoot(src) == dst);
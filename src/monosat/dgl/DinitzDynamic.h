@@ -0,0 +1,616 @@
+/**************************************************************************************************
+ The MIT License (MIT)
+
+ Copyright (c) 2014, Sam Bayless
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef DINITZ_DYNAMIC_H
+#define DINITZ_DYNAMIC_H
+
+#include "Graph.h"
+#include "DynamicGraph.h"
+#include "MaxFlow.h"
+#include <vector>
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+
+namespace dgl {
+
+/**
+ * An incremental maximum flow algorithm, which keeps its flow between updates.
+ *
+ * When edges are disabled (or their capacities are lowered), only the flow through those edges is removed.
+ * This leaves some nodes with excess inflow, and others with excess outflow; each excess is then routed
+ * through the residual graph to a node with the opposite imbalance (or back to the source or sink),
+ * which repairs the flow while leaving the rest of it untouched.
+ * The repaired flow is then extended to a maximum flow with Dinitz's blocking flow algorithm, which,
+ * when only a few edges have changed, typically needs only a handful of short augmenting phases.
+ *
+ * Unlike KohliTorr, this is implemented from scratch, and does not depend on any GPL sources.
+ */
+template<typename Weight = int>
+class DinitzDynamic : public MaxFlow<Weight>, public DynamicGraphAlgorithm {
+    struct LocalEdge {
+        int from;
+        int id;
+        bool backward = false;
+
+        LocalEdge(int from = -1, int id = -1, bool backward = false) :
+                from(from), id(id), backward(backward){
+
+        }
+    };
+
+    Graph <Weight>& g;
+    int source = -1;
+    int sink = -1;
+
+    Weight curflow = 0;
+    int last_modification = -1;
+    int history_qhead = 0;
+    int alg_id = -1;
+    int last_history_clear = 0;
+    int64_t num_updates = 0;
+
+    std::vector<Weight> F;
+    //The capacity of each edge as of the last update (or 0, if the edge was disabled).
+    std::vector<Weight> cap;
+    //Inflow minus outflow of each node, for the nodes left unbalanced by removing flow from an edge.
+    std::vector<Weight> excess;
+    std::vector<int> unbalanced;
+    std::vector<bool> in_unbalanced;
+
+    std::vector<int> changed_edges;
+    std::vector<bool> changed;
+
+    std::vector<LocalEdge> prev;
+    std::vector<int> dist;
+    std::vector<int> pos;
+    std::vector<int> Q;
+    std::vector<LocalEdge> path;
+
+    //The source side of the minimum cut, computed on demand.
+    std::vector<bool> in_source_partition;
+    std::vector<int> changed_partition;
+    std::vector<bool> partition_changed;
+    int64_t partition_update = -1;
+
+public:
+    int64_t stats_full_updates = 0;
+    int64_t stats_fast_updates = 0;
+    int64_t stats_skipped_updates = 0;
+    int64_t stats_repaired_edges = 0;
+    int64_t stats_phases = 0;
+    int64_t stats_augmenting_paths = 0;
+
+    DinitzDynamic(Graph <Weight>& g, int source, int sink) :
+            g(g), source(source), sink(sink){
+        alg_id = g.addDynamicAlgorithm(this);
+    }
+
+    std::string getName() override{
+        return "DinitzDynamic(" + std::to_string(getSource()) + ", " + std::to_string(getSink()) + ")";
+    }
+
+    int getSource() const override{
+        return source;
+    }
+
+    int getSink() const override{
+        return sink;
+    }
+
+    int numUpdates() const override{
+        return num_updates;
+    }
+
+    void setSource(int s) override{
+        if(source == s){
+            return;
+        }
+        source = s;
+        last_modification = -1;
+    }
+
+    void setSink(int t) override{
+        if(sink == t){
+            return;
+        }
+        sink = t;
+        last_modification = -1;
+    }
+
+    void printStats() override{
+        printf("Dynamic Dinitz: %" PRId64 " full updates, %" PRId64 " incremental updates (%" PRId64
+               " repaired edges), %" PRId64 " skipped, %" PRId64 " phases, %" PRId64 " augmenting paths\n",
+               stats_full_updates, stats_fast_updates, stats_repaired_edges, stats_skipped_updates, stats_phases,
+               stats_augmenting_paths);
+    }
+
+    const Weight update() override{
+        if(last_modification > 0 && g.getCurrentHistory() == last_modification){
+            stats_skipped_updates++;
+            return curflow;
+        }
+        if(g.outfile()){
+            fprintf(g.outfile(), "f %d %d\n", source, sink);
+            fflush(g.outfile());
+        }
+
+        if(last_modification <= 0 || g.nHistoryClears() != last_history_clear || history_qhead < g.historyStart()
+           || g.changed()
+           || F.size() != g.edges() || excess.size() != g.nodes() || !repair()){
+            recompute();
+        }
+        if(source != sink){
+            augment();
+        }
+        curflow = 0;
+        if(source != sink){
+            for(int i = 0; i < g.nIncident(source); i++){
+                curflow += F[g.incident(source, i).id];
+            }
+            for(int i = 0; i < g.nIncoming(source); i++){
+                curflow -= F[g.incoming(source, i).id];
+            }
+        }
+        dbg_check_flow();
+
+        num_updates++;
+        last_modification = g.getCurrentHistory();
+        history_qhead = g.historySize();
+        g.updateAlgorithmHistory(this, alg_id, history_qhead);
+        last_history_clear = g.nHistoryClears();
+        return curflow;
+    }
+
+    void updateHistory() override{
+        update();
+    }
+
+    std::vector<int>& getChangedEdges() override{
+        return changed_edges;
+    }
+
+    void clearChangedEdges() override{
+        for(int edgeID : changed_edges){
+            assert(changed[edgeID]);
+            changed[edgeID] = false;
+        }
+        changed_edges.clear();
+    }
+
+    std::vector<int>& getChangedPartition() override{
+        update();
+        updatePartition();
+        return changed_partition;
+    }
+
+    void clearChangedPartition() override{
+        for(int node : changed_partition){
+            partition_changed[node] = false;
+        }
+        changed_partition.clear();
+    }
+
+    const Weight minCut(std::vector<MaxFlowEdge>& cut) override{
+        Weight f = this->maxFlow();
+        cut.clear();
+        updatePartition();
+        for(int u = 0; u < g.nodes(); u++){
+            if(!in_source_partition[u])
+                continue;
+            for(int i = 0; i < g.nIncident(u); i++){
+                int id = g.incident(u, i).id;
+                int v = g.incident(u, i).node;
+                if(g.edgeEnabled(id) && !in_source_partition[v]){
+                    assert(F[id] == cap[id]);
+                    cut.push_back(MaxFlowEdge{u, v, id});
+                }
+            }
+        }
+        return f;
+    }
+
+    const bool inSourcePartition(int node) override{
+        update();
+        updatePartition();
+        return in_source_partition[node];
+    }
+
+    const bool isOnCut(int edgeID) override{
+        if(source == sink)
+            return false;
+        int u = g.getEdge(edgeID).from;
+        int v = g.getEdge(edgeID).to;
+        if(u == v)
+            return false;//self edges are never on the cut
+        update();
+        updatePartition();
+        return in_source_partition[u] && !in_source_partition[v];
+    }
+
+    const Weight getEdgeCapacity(int id) override{
+        return g.getWeight(id);
+    }
+
+    const Weight getEdgeFlow(int id) override{
+        return F[id];
+    }
+
+    const Weight getEdgeResidualCapacity(int id) override{
+        return g.getWeight(id) - F[id];
+    }
+
+private:
+
+    void markChanged(int edgeID){
+        if(!changed[edgeID]){
+            changed[edgeID] = true;
+            changed_edges.push_back(edgeID);
+        }
+    }
+
+    void addExcess(int u, Weight delta){
+        if(u == source || u == sink)
+            return;//the source and sink are allowed to be unbalanced
+        excess[u] += delta;
+        if(!in_unbalanced[u]){
+            in_unbalanced[u] = true;
+            unbalanced.push_back(u);
+        }
+    }
+
+    Weight residual(const LocalEdge& e) const{
+        return e.backward ? F[e.id] : cap[e.id] - F[e.id];
+    }
+
+    //Adds 'flow' units along the residual arc 'e'.
+    void push(const LocalEdge& e, Weight flow){
+        if(e.backward){
+            F[e.id] -= flow;
+        }else{
+            F[e.id] += flow;
+        }
+        markChanged(e.id);
+    }
+
+    //The arc in position 'i' of the combined forward and backward adjacency list of 'u', and the node it leads to.
+    LocalEdge arc(int u, int i, int& v){
+        int n_incident = g.nIncident(u);
+        if(i < n_incident){
+            v = g.incident(u, i).node;
+            return LocalEdge(u, g.incident(u, i).id, false);
+        }else{
+            v = g.incoming(u, i - n_incident).node;
+            return LocalEdge(u, g.incoming(u, i - n_incident).id, true);
+        }
+    }
+
+    void recompute(){
+        stats_full_updates++;
+        changed.resize(g.edges());
+        for(int i = 0; i < F.size(); i++){
+            if(F[i] != 0)
+                markChanged(i);
+        }
+        F.clear();
+        F.resize(g.edges(), 0);
+        cap.resize(g.edges());
+        for(int i = 0; i < g.edges(); i++){
+            cap[i] = (g.isEdge(i) && g.edgeEnabled(i)) ? g.getWeight(i) : 0;
+        }
+        excess.clear();
+        excess.resize(g.nodes(), 0);
+        in_unbalanced.clear();
+        in_unbalanced.resize(g.nodes(), false);
+        unbalanced.clear();
+        prev.resize(g.nodes());
+        dist.resize(g.nodes());
+        pos.resize(g.nodes());
+    }
+
+    /**
+     * Brings the capacities up to date with the changes in the graph since the last update, removing flow from
+     * any edge whose capacity has dropped below its flow, and then reroutes the flow around those edges.
+     * Returns false if the flow could not be repaired (which shouldn't happen), in which case the
+     * caller falls back on a full recomputation.
+     */
+    bool repair(){
+        stats_fast_updates++;
+        for(int i = history_qhead; i < g.historySize(); i++){
+            int id = g.getChange(i).id;
+            Weight c = g.edgeEnabled(id) ? g.getWeight(id) : 0;
+            if(c == cap[id])
+                continue;
+            cap[id] = c;
+            if(F[id] > c){
+                stats_repaired_edges++;
+                Weight diff = F[id] - c;
+                F[id] = c;
+                markChanged(id);
+                addExcess(g.getEdge(id).from, diff);
+                addExcess(g.getEdge(id).to, -diff);
+            }
+        }
+        bool ok = true;
+        //First send each excess inflow onwards, to a node with excess outflow, or to the sink, or back to the source.
+        for(int i = 0; ok && i < unbalanced.size(); i++){
+            int u = unbalanced[i];
+            while(excess[u] > 0){
+                if(!routeExcess(u)){
+                    ok = false;
+                    break;
+                }
+            }
+        }
+        //Then feed each remaining excess outflow from the source (or, if it can't be, cancel it back from the sink).
+        for(int i = 0; ok && i < unbalanced.size(); i++){
+            int u = unbalanced[i];
+            while(excess[u] < 0){
+                if(!routeDeficit(u)){
+                    ok = false;
+                    break;
+                }
+            }
+        }
+        for(int u : unbalanced){
+            excess[u] = 0;
+            in_unbalanced[u] = false;
+        }
+        unbalanced.clear();
+        return ok;
+    }
+
+    //Search the residual graph from u for the source, the sink, or a node with excess outflow, and push as much of u's excess to it as possible.
+    bool routeExcess(int u){
+        for(int n = 0; n < g.nodes(); n++)
+            prev[n].from = -1;
+        prev[u].from = -2;
+        Q.clear();
+        Q.push_back(u);
+        int found = -1;
+        for(int j = 0; j < Q.size() && found < 0; j++){
+            int w = Q[j];
+            int n_arcs = g.nIncident(w) + g.nIncoming(w);
+            for(int i = 0; i < n_arcs; i++){
+                int v;
+                LocalEdge e = arc(w, i, v);
+                if(prev[v].from != -1 || !(residual(e) > 0))
+                    continue;
+                prev[v] = e;
+                if(v == source || v == sink || excess[v] < 0){
+                    found = v;
+                    break;
+                }
+                Q.push_back(v);
+            }
+        }
+        if(found < 0)
+            return false;
+        Weight m = excess[u];
+        if(excess[found] < 0){
+            Weight deficit = -excess[found];
+            m = std::min(m, deficit);
+        }
+        for(int v = found; v != u; v = prev[v].from){
+            m = std::min(m, residual(prev[v]));
+        }
+        for(int v = found; v != u; v = prev[v].from){
+            push(prev[v], m);
+        }
+        excess[u] -= m;
+        if(excess[found] < 0)
+            excess[found] += m;
+        return true;
+    }
+
+    //Search the residual graph backwards from u for the source or the sink, and push as much flow from it into u as u is missing.
+    bool routeDeficit(int u){
+        //prev[v] here holds the arc leaving v on its path to u
+        for(int n = 0; n < g.nodes(); n++)
+            prev[n].from = -1;
+        prev[u].from = -2;
+        Q.clear();
+        Q.push_back(u);
+        int found = -1;
+        for(int j = 0; j < Q.size() && found < 0; j++){
+            int w = Q[j];
+            //an edge v->w is a residual arc into w if it has spare capacity, and an edge w->v is if it has flow.
+            for(int i = 0; i < g.nIncoming(w) + g.nIncident(w); i++){
+                int v;
+                LocalEdge e;
+                if(i < g.nIncoming(w)){
+                    v = g.incoming(w, i).node;
+                    e = LocalEdge(w, g.incoming(w, i).id, false);
+                }else{
+                    v = g.incident(w, i - g.nIncoming(w)).node;
+                    e = LocalEdge(w, g.incident(w, i - g.nIncoming(w)).id, true);
+                }
+                if(prev[v].from != -1 || !(residual(e) > 0))
+                    continue;
+                prev[v] = e;
+                if(v == source || v == sink){
+                    found = v;
+                    break;
+                }
+                Q.push_back(v);
+            }
+        }
+        if(found < 0)
+            return false;
+        Weight m = -excess[u];
+        for(int v = found; v != u; v = prev[v].from){
+            m = std::min(m, residual(prev[v]));
+        }
+        for(int v = found; v != u; v = prev[v].from){
+            push(prev[v], m);
+        }
+        excess[u] += m;
+        return true;
+    }
+
+    //Label each node with its BFS distance from the source in the residual graph, returning true if the sink is reachable.
+    bool buildLevels(){
+        for(int n = 0; n < g.nodes(); n++)
+            dist[n] = -1;
+        dist[source] = 0;
+        Q.clear();
+        Q.push_back(source);
+        for(int j = 0; j < Q.size(); j++){
+            int u = Q[j];
+            if(dist[sink] >= 0 && dist[u] >= dist[sink])
+                break;
+            int n_arcs = g.nIncident(u) + g.nIncoming(u);
+            for(int i = 0; i < n_arcs; i++){
+                int v;
+                LocalEdge e = arc(u, i, v);
+                if(dist[v] < 0 && residual(e) > 0){
+                    dist[v] = dist[u] + 1;
+                    Q.push_back(v);
+                }
+            }
+        }
+        return dist[sink] >= 0;
+    }
+
+    //Find a blocking flow in the level graph, using an iterative DFS that remembers the current arc of each node.
+    void blockingFlow(){
+        for(int n = 0; n < g.nodes(); n++)
+            pos[n] = 0;
+        path.clear();
+        int u = source;
+        while(true){
+            if(u == sink){
+                Weight m = residual(path[0]);
+                for(const LocalEdge& e : path)
+                    m = std::min(m, residual(e));
+                int retreat_to = -1;
+                for(int i = 0; i < path.size(); i++){
+                    push(path[i], m);
+                    if(retreat_to < 0 && !(residual(path[i]) > 0))
+                        retreat_to = i;
+                }
+                stats_augmenting_paths++;
+                //resume the search from the tail of the first saturated arc
+                assert(retreat_to >= 0);
+                u = path[retreat_to].from;
+                path.resize(retreat_to);
+                continue;
+            }
+            int n_arcs = g.nIncident(u) + g.nIncoming(u);
+            bool advanced = false;
+            for(; pos[u] < n_arcs; pos[u]++){
+                int v;
+                LocalEdge e = arc(u, pos[u], v);
+                if(dist[v] == dist[u] + 1 && residual(e) > 0){
+                    path.push_back(e);
+                    u = v;
+                    advanced = true;
+                    break;
+                }
+            }
+            if(!advanced){
+                //u is a dead end in this phase
+                dist[u] = -1;
+                if(u == source)
+                    break;
+                u = path.back().from;
+                path.pop_back();
+                pos[u]++;
+            }
+        }
+    }
+
+    void augment(){
+        while(buildLevels()){
+            stats_phases++;
+            blockingFlow();
+        }
+    }
+
+    //Compute the source side of the minimum cut (the nodes reachable from the source in the residual graph)
+    void updatePartition(){
+        if(partition_update == num_updates)
+            return;
+        partition_update = num_updates;
+        if(in_source_partition.size() != g.nodes()){
+            in_source_partition.clear();
+            in_source_partition.resize(g.nodes(), false);
+            partition_changed.clear();
+            partition_changed.resize(g.nodes(), false);
+            changed_partition.clear();
+        }
+        for(int n = 0; n < g.nodes(); n++)
+            prev[n].from = -1;
+        Q.clear();
+        if(source != sink){
+            prev[source].from = -2;
+            Q.push_back(source);
+        }
+        for(int j = 0; j < Q.size(); j++){
+            int u = Q[j];
+            int n_arcs = g.nIncident(u) + g.nIncoming(u);
+            for(int i = 0; i < n_arcs; i++){
+                int v;
+                LocalEdge e = arc(u, i, v);
+                if(prev[v].from == -1 && residual(e) > 0){
+                    prev[v] = e;
+                    Q.push_back(v);
+                }
+            }
+        }
+        for(int n = 0; n < g.nodes(); n++){
+            bool in_source = prev[n].from != -1;
+            if(in_source != in_source_partition[n]){
+                in_source_partition[n] = in_source;
+                if(!partition_changed[n]){
+                    partition_changed[n] = true;
+                    changed_partition.push_back(n);
+                }
+            }
+        }
+    }
+
+    void dbg_check_flow(){
+#ifdef DEBUG_DGL
+        for(int u = 0; u < g.nodes(); u++){
+            Weight inflow = 0;
+            Weight outflow = 0;
+            for(int i = 0; i < g.nIncoming(u); i++){
+                int id = g.incoming(u, i).id;
+                assert(F[id] >= 0 && F[id] <= cap[id]);
+                inflow += F[id];
+            }
+            for(int i = 0; i < g.nIncident(u); i++){
+                outflow += F[g.incident(u, i).id];
+            }
+            if(u == source){
+                assert(outflow - inflow == curflow);
+            }else if(u == sink){
+                assert(inflow - outflow == curflow);
+            }else{
+                assert(inflow == outflow);
+            }
+        }
+#endif
+    }
+};
+};
+#endif
@@ -27,7 +27,7 @@
 #include "Graph.h"
 #include "monosat/core/Config.h"
 #include "ConnectedComponents.h"
-#include "monosat/dgl/alg/DisjointSets.h"
+#include "monosat/dgl/alg/UndoableDisjointSets.h"
 #include <limits>
 
 namespace dgl {
@@ -46,7 +46,19 @@ public:
     int last_history_clear;
     bool hasParents = false;
     int INF;
-    DisjointSets sets;
+    UndoableDisjointSets sets;
+    //The enabled edges, in the order they were added to the sets, and the undo checkpoint taken before each was added.
+    //Edges that are disabled are rolled back together with every edge added after them, so that when edges are
+    //disabled in the reverse of the order they were enabled (as happens when the solver backtracks), the update
+    //only touches the edges that changed.
+    std::vector<int> edge_stack;
+    std::vector<int> edge_checkpoints;
+    std::vector<int> stack_pos;
+    std::vector<int> readd;
+    std::vector<int> elements;
+    std::vector<bool> seen;
+    int64_t elements_update = -1;
+    int64_t num_updates = 0;
 
     std::vector<int> q;
     std::vector<int> check;
@@ -94,34 +106,90 @@ public:
 
     }
 
+private:
+
+    void addEdge(int edgeID){
+        assert(stack_pos[edgeID] < 0);
+        stack_pos[edgeID] = edge_stack.size();
+        edge_stack.push_back(edgeID);
+        edge_checkpoints.push_back(sets.Checkpoint());
+        sets.UnionElements(g.getEdge(edgeID).from, g.getEdge(edgeID).to);
+    }
+
+    void rebuild(){
+        stats_full_updates++;
+        sets.Reset();
+        setNodes(g.nodes());
+        edge_stack.clear();
+        edge_checkpoints.clear();
+        stack_pos.clear();
+        stack_pos.resize(g.edges(), -1);
+        for(int i = 0; i < g.edges(); i++){
+            if(g.edgeEnabled(i)){
+                addEdge(i);
+            }
+        }
+    }
+
+    //Roll back to just before the earliest disabled edge, then add back any edges after it that are still enabled,
+    //followed by the newly enabled edges.
+    void updateChanges(){
+        stats_fast_updates++;
+        int lowest = edge_stack.size();
+        for(int i = history_qhead; i < g.historySize(); i++){
+            int edgeID = g.getChange(i).id;
+            if(stack_pos[edgeID] >= 0 && stack_pos[edgeID] < lowest && !g.edgeEnabled(edgeID)){
+                lowest = stack_pos[edgeID];
+            }
+        }
+        if(lowest < edge_stack.size()){
+            sets.Rollback(edge_checkpoints[lowest]);
+            readd.clear();
+            for(int j = lowest; j < edge_stack.size(); j++){
+                int edgeID = edge_stack[j];
+                stack_pos[edgeID] = -1;
+                if(g.edgeEnabled(edgeID))
+                    readd.push_back(edgeID);
+            }
+            edge_stack.resize(lowest);
+            edge_checkpoints.resize(lowest);
+            for(int edgeID : readd){
+                addEdge(edgeID);
+            }
+        }
+        for(int i = history_qhead; i < g.historySize(); i++){
+            int edgeID = g.getChange(i).id;
+            if(stack_pos[edgeID] < 0 && g.edgeEnabled(edgeID)){
+                addEdge(edgeID);
+            }
+        }
+    }
+
+public:
+
     void addConnectedCheck(int u, int v){
         connectChecks.push_back({u, v});
     }
 
     void update(){
-        static int iteration = 0;
+        static thread_local int iteration = 0;
         int local_it = ++iteration;
 
         if(last_modification > 0 && g.getCurrentHistory() == last_modification){
             stats_skipped_updates++;
             return;
         }
-        stats_full_updates++;
-
         if(last_deletion == g.nDeletions()){
             stats_num_skipable_deletions++;
         }
         hasParents = false;
-        sets.Reset();
-        setNodes(g.nodes());
-
-        for(int i = 0; i < g.edges(); i++){
-            if(g.edgeEnabled(i)){
-                int u = g.getEdge(i).from;
-                int v = g.getEdge(i).to;
-                sets.UnionElements(u, v);
-            }
+        if(last_modification <= 0 || g.changed() || g.nHistoryClears() != last_history_clear
+           || history_qhead < g.historyStart() || g.nodes() != sets.NumElements() || g.edges() != stack_pos.size()){
+            rebuild();
+        }else{
+            updateChanges();
         }
+        num_updates++;
 
         status.setComponents(sets.NumSets());
 
@@ -161,7 +229,21 @@ public:
 
     int getElement(int set){
         update();
-        return sets.GetElement(set);
+        if(elements_update != num_updates){
+            //collect one element (the root) of each set
+            elements_update = num_updates;
+            elements.clear();
+            seen.clear();
+            seen.resize(g.nodes());
+            for(int i = 0; i < g.nodes(); i++){
+                int s = sets.FindSet(i);
+                if(!seen[s]){
+                    seen[s] = true;
+                    elements.push_back(s);
+                }
+            }
+        }
+        return elements[set];
     }
 
     bool dbg_uptodate(){
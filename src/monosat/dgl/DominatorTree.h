@@ -0,0 +1,273 @@
+/**************************************************************************************************
+ The MIT License (MIT)
+
+ Copyright (c) 2014, Sam Bayless
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef DOMINATOR_TREE_H_
+#define DOMINATOR_TREE_H_
+
+#include <vector>
+#include <cassert>
+#include "Graph.h"
+#include "DynamicGraph.h"
+
+namespace dgl {
+
+/**
+ * Dominator tree of the enabled edges of a graph, from a single source, computed with the
+ * Semi-NCA algorithm (Georgiadis, 2005; see also "Finding Dominators in Practice", Georgiadis, Tarjan, Werneck).
+ *
+ * Dominators are computed over the edge-split graph, in which each edge (u,v) is replaced by a vertex 'e'
+ * and the edges (u,e) and (e,v); vertex ids below g.nodes() are nodes, and vertex g.nodes()+edgeID is edge edgeID.
+ * An edge (or node) is then on every path from the source to t if and only if its vertex dominates t,
+ * so a single pass finds the edges and nodes that every target of the source must use.
+ *
+ * The tree is only recomputed if an edge leaving a node that was reachable from the source has changed
+ * since the last update; other changes cannot affect the set of reachable nodes or their dominators.
+ */
+template<typename Weight, typename Graph = DynamicGraph<Weight>>
+class DominatorTree {
+public:
+    Graph& g;
+    int source;
+
+    int last_modification = -1;
+    int history_qhead = 0;
+    int last_history_clear = 0;
+
+    int n = 0;
+    //immediate dominator of each vertex of the edge-split graph, or -1 if the vertex is unreachable (or is the source)
+    std::vector<int> idom;
+
+private:
+    //all of these are indexed by preorder number, with 0 reserved to mean 'none'
+    std::vector<int> vertex;
+    std::vector<int> parent;
+    std::vector<int> semi;
+    std::vector<int> label;
+    std::vector<int> ancestor;
+    std::vector<int> dom;
+    //preorder number of each vertex, or 0 if the vertex is unreachable
+    std::vector<int> pre;
+    std::vector<int> stack;
+    std::vector<int> next_incident;
+    std::vector<int> path;
+
+public:
+    int64_t stats_full_updates = 0;
+    int64_t stats_skipped_updates = 0;
+    double stats_full_update_time = 0;
+
+    DominatorTree(int s, Graph& graph) :
+            g(graph), source(s){
+    }
+
+    int getSource() const{
+        return source;
+    }
+
+    bool isEdgeVertex(int v) const{
+        return v >= n;
+    }
+
+    int getEdge(int v) const{
+        assert(isEdgeVertex(v));
+        return v - n;
+    }
+
+    bool reachable(int node){
+        update();
+        return node < n && pre[node] > 0;
+    }
+
+    //The immediate dominator of 'v' in the edge-split graph (see above)
+    int immediateDominator(int v){
+        update();
+        return idom[v];
+    }
+
+    //Collect the edges that are on every path from the source to 'to' (which must be reachable),
+    //nearest to 'to' first.
+    void getDominatingEdges(int to, std::vector<int>& store){
+        update();
+        assert(reachable(to));
+        for(int v = idom[to]; v >= 0; v = idom[v]){
+            if(isEdgeVertex(v))
+                store.push_back(getEdge(v));
+        }
+    }
+
+    //Collect the nodes (other than 'to' and the source) that are on every path from the source to 'to',
+    //nearest to 'to' first.
+    void getDominatingNodes(int to, std::vector<int>& store){
+        update();
+        assert(reachable(to));
+        for(int v = idom[to]; v >= 0; v = idom[v]){
+            if(!isEdgeVertex(v) && v != source)
+                store.push_back(v);
+        }
+    }
+
+    void update(){
+        if(last_modification > 0 && g.getCurrentHistory() == last_modification){
+            stats_skipped_updates++;
+            return;
+        }
+        if(!needsRecompute()){
+            stats_skipped_updates++;
+        }else{
+            stats_full_updates++;
+            recompute();
+        }
+        last_modification = g.getCurrentHistory();
+        history_qhead = g.historySize();
+        last_history_clear = g.nHistoryClears();
+    }
+
+private:
+
+    bool needsRecompute(){
+        if(last_modification <= 0 || g.changed() || n != g.nodes() || idom.size() != g.nodes() + g.edges()
+           || g.nHistoryClears() != last_history_clear || history_qhead < g.historyStart()){
+            return true;
+        }
+        for(int i = history_qhead; i < g.historySize(); i++){
+            int edgeID = g.getChange(i).id;
+            if(pre[g.getEdge(edgeID).from] > 0){
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void visit(int v, int p){
+        int num = vertex.size();
+        pre[v] = num;
+        vertex.push_back(v);
+        parent.push_back(p);
+        stack.push_back(v);
+    }
+
+    //The vertex with the least semidominator on the path from v to the root of its tree in the link-eval forest,
+    //excluding that root, with path compression.
+    int eval(int v){
+        if(ancestor[v] == 0)
+            return v;
+        path.clear();
+        for(int u = v; ancestor[ancestor[u]] != 0; u = ancestor[u]){
+            path.push_back(u);
+        }
+        for(int i = path.size() - 1; i >= 0; i--){
+            int u = path[i];
+            int a = ancestor[u];
+            if(semi[label[a]] < semi[label[u]])
+                label[u] = label[a];
+            ancestor[u] = ancestor[a];
+        }
+        return label[v];
+    }
+
+    void recompute(){
+        n = g.nodes();
+        int nv = n + g.edges();
+        idom.clear();
+        idom.resize(nv, -1);
+        pre.clear();
+        pre.resize(nv, 0);
+        vertex.clear();
+        parent.clear();
+        vertex.push_back(-1);
+        parent.push_back(0);
+
+        //preorder depth first search of the edge-split graph
+        stack.clear();
+        visit(source, 0);
+        next_incident.clear();
+        next_incident.resize(n, 0);
+        while(stack.size()){
+            int v = stack.back();
+            if(isEdgeVertex(v)){
+                stack.pop_back();
+                int to = g.getEdge(getEdge(v)).to;
+                if(!pre[to]){
+                    visit(to, pre[v]);
+                }
+                continue;
+            }
+            bool pushed = false;
+            while(next_incident[v] < g.nIncident(v)){
+                auto& edge = g.incident(v, next_incident[v]++);
+                if(g.edgeEnabled(edge.id) && !pre[n + edge.id]){
+                    visit(n + edge.id, pre[v]);
+                    pushed = true;
+                    break;
+                }
+            }
+            if(!pushed){
+                stack.pop_back();
+            }
+        }
+
+        int count = vertex.size() - 1;
+        semi.resize(count + 1);
+        label.resize(count + 1);
+        ancestor.clear();
+        ancestor.resize(count + 1, 0);
+        dom.clear();
+        dom.resize(count + 1, 0);
+        for(int i = 1; i <= count; i++){
+            semi[i] = i;
+            label[i] = i;
+        }
+        //semidominators, in reverse preorder
+        for(int i = count; i >= 2; i--){
+            int w = vertex[i];
+            if(isEdgeVertex(w)){
+                //the only predecessor of an edge vertex is the edge's source node, which is its dfs parent
+                int p = pre[g.getEdge(getEdge(w)).from];
+                int s = semi[eval(p)];
+                if(s < semi[i])
+                    semi[i] = s;
+            }else{
+                for(int j = 0; j < g.nIncoming(w); j++){
+                    auto& edge = g.incoming(w, j);
+                    int p = pre[n + edge.id];
+                    if(p == 0)
+                        continue;//this edge is disabled or unreachable
+                    int s = semi[eval(p)];
+                    if(s < semi[i])
+                        semi[i] = s;
+                }
+            }
+            label[i] = i;
+            ancestor[i] = parent[i];
+        }
+        //immediate dominators, as nearest common ancestors in the dfs tree, in preorder
+        for(int i = 2; i <= count; i++){
+            int d = parent[i];
+            while(d > semi[i]){
+                d = dom[d];
+            }
+            dom[i] = d;
+            idom[vertex[i]] = vertex[d];
+        }
+    }
+};
+};
+#endif
@@ -44,6 +44,7 @@ public:
     typedef typename Graph<Weight>::Edge Edge;
     typedef typename Graph<Weight>::FullEdge FullEdge;
     typedef typename Graph<Weight>::EdgeChange EdgeChange;
+    typedef typename Graph<Weight>::EdgeRange EdgeRange;
 private:
     DynamicGraph <Weight>& base;
     std::vector<FullEdge> all_back_edges;
@@ -135,6 +136,14 @@ public:
         return base.incident(node, i, undirected);
     };
 
+    EdgeRange incidentEdges(int node, bool undirected = false) override{
+        return base.incomingEdges(node, undirected);
+    };
+
+    EdgeRange incomingEdges(int node, bool undirected = false) override{
+        return base.incidentEdges(node, undirected);
+    };
+
     std::vector<FullEdge>& getEdges() override{
         updateEdges();
         return all_back_edges;
@@ -203,6 +212,8 @@ public:
 
     int historySize() override{return base.historySize();};
 
+    int historyStart() override{return base.historyStart();};
+
     int nHistoryClears() const override{
         return base.nHistoryClears();
     }
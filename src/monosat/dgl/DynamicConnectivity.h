@@ -141,16 +141,10 @@ public:
     }
 
     void updateEdge(int u, int v, int edgeid, bool add){
-        if(edgeid == 2){
-            int a = 1;
-        }
-        if(u == 16 || v == 16){
-            int a = 1;
-        }
         assert(transitive_closure[0][sources[0]].reachable);
         assert(
-                (g.all_edges[edgeid].to == u && g.all_edges[edgeid].from == v)
-                || (g.all_edges[edgeid].to == v && g.all_edges[edgeid].from == u));
+                (g.getEdge(edgeid).to == u && g.getEdge(edgeid).from == v)
+                || (g.getEdge(edgeid).to == v && g.getEdge(edgeid).from == u));
         if(add){
             bool already_connected = false;
             if(!t.connected(u, v)){
@@ -175,11 +169,8 @@ public:
 
                         for(int edgeid : v_component){
 
-                            int u = g.all_edges[edgeid].from;
-                            int v = g.all_edges[edgeid].to;
-                            if(u == 16 || v == 16){
-                                int a = 1;
-                            }
+                            int u = g.getEdge(edgeid).from;
+                            int v = g.getEdge(edgeid).to;
                             assert(!(transitive_closure[i][u].reachable && transitive_closure[i][v].reachable));
                             assert((transitive_closure[i][u].reachable || transitive_closure[i][v].reachable));
                             int n = transitive_closure[i][u].reachable ? v : u;
@@ -204,11 +195,8 @@ public:
                         }
 
                         for(int edgeid : u_component){
-                            int u = g.all_edges[edgeid].from;
-                            int v = g.all_edges[edgeid].to;
-                            if(u == 16 || v == 16){
-                                int a = 1;
-                            }
+                            int u = g.getEdge(edgeid).from;
+                            int v = g.getEdge(edgeid).to;
                             assert(!(transitive_closure[i][u].reachable && transitive_closure[i][v].reachable));
                             assert((transitive_closure[i][u].reachable || transitive_closure[i][v].reachable));
                             int n = transitive_closure[i][u].reachable ? v : u;
@@ -305,10 +293,10 @@ public:
 
         dbg_sets.AddElements(g.nodes());
 
-        for (int i = 0; i < g.all_edges.size(); i++) {
-            if (g.edgeEnabled(i) && g.all_edges[i].id >= 0) {
-                int u = g.all_edges[i].from;
-                int v = g.all_edges[i].to;
+        for (int i = 0; i < g.getEdges().size(); i++) {
+            if (g.edgeEnabled(i) && g.getEdge(i).id >= 0) {
+                int u = g.getEdge(i).from;
+                int v = g.getEdge(i).to;
                 dbg_sets.UnionElements(u, v);
             }
         }
@@ -318,9 +306,9 @@ public:
 
         assert(transitive_closure[0][sources[0]].reachable);
 
-        if(last_modification <= 0 || g.nHistoryClears() != last_history_clear){
+        if(last_modification <= 0 || g.nHistoryClears() != last_history_clear || history_qhead < g.historyStart()){
             last_history_clear = g.nHistoryClears();
-            history_qhead = 0;
+            history_qhead = g.historyStart();
 
             //initialize the transitive closure.
             for(int s = 0; s < sources.size(); s++){
@@ -344,11 +332,11 @@ public:
             }
 
             //start from scratch
-            for(int i = 0; i < g.all_edges.size(); i++){
-                if(g.all_edges[i].id >= 0){
+            for(int i = 0; i < g.getEdges().size(); i++){
+                if(g.getEdge(i).id >= 0){
                     bool add = g.edgeEnabled(i);
-                    int u = g.all_edges[i].from;
-                    int v = g.all_edges[i].to;
+                    int u = g.getEdge(i).from;
+                    int v = g.getEdge(i).to;
                     updateEdge(u, v, i, add);
                 }
             }
@@ -358,18 +346,18 @@ public:
             for(; history_qhead < g.historySize(); history_qhead++){
                 int edgeid = g.getChange(history_qhead).id;
                 bool add = g.getChange(history_qhead).addition;
-                int u = g.all_edges[edgeid].from;
-                int v = g.all_edges[edgeid].to;
+                int u = g.getEdge(edgeid).from;
+                int v = g.getEdge(edgeid).to;
                 updateEdge(u, v, edgeid, add);
             }
 
         }
 #ifdef DEBUG_DGL
         for (int i = 0; i < g.edges(); i++) {
-            if (g.all_edges[i].id >= 0) {
-                assert(t.edges[i].edgeID == g.all_edges[i].id);
-                assert(t.edges[i].from == g.all_edges[i].from);
-                assert(t.edges[i].to == g.all_edges[i].to);
+            if (g.getEdge(i).id >= 0) {
+                assert(t.edges[i].edgeID == g.getEdge(i).id);
+                assert(t.edges[i].from == g.getEdge(i).from);
+                assert(t.edges[i].to == g.getEdge(i).to);
                 assert(t.edgeEnabled(i) == g.edgeEnabled(i));
             }
         }
@@ -411,7 +399,6 @@ public:
          prev.resize(g.nodes(),-1);
          //ok, traverse the nodes connected to this component
          component.clear();
-         static int iter=0;
          //this is NOT the right way to do this.
          //need to only see check from t!
          t.getConnectedComponent(default_source,component);
@@ -476,8 +463,8 @@ public:
         for (int i = 0; i < path.size(); i++) {
             int edgeid = path[i];
 
-            int v = g.all_edges[edgeid].from;
-            int u = g.all_edges[edgeid].to;
+            int v = g.getEdge(edgeid).from;
+            int u = g.getEdge(edgeid).to;
             assert(v == n || u == n);
             assert(g.hasEdgeUndirected(u, v));
             if (v == n) {
@@ -613,10 +600,10 @@ public:
             int n = getSource();
 
             for(int edge : path){
-                int v = g.all_edges[edge].from;
-                assert(v == n || g.all_edges[edge].to == n);
+                int v = g.getEdge(edge).from;
+                assert(v == n || g.getEdge(edge).to == n);
                 if(v == n){
-                    v = g.all_edges[edge].to;
+                    v = g.getEdge(edge).to;
                 }
                 assert(v != getSource());
                 prev[v] = edge;
@@ -635,11 +622,11 @@ public:
             return -1;
         assert(transitive_closure[default_source_index][t].reachable);
 
-        if(g.all_edges[edgeID].from == t){
-            return g.all_edges[edgeID].to;
+        if(g.getEdge(edgeID).from == t){
+            return g.getEdge(edgeID).to;
         }
-        assert(g.all_edges[edgeID].to == t);
-        return g.all_edges[edgeID].from;
+        assert(g.getEdge(edgeID).to == t);
+        return g.getEdge(edgeID).from;
     }
 
     void getPath(int t, std::vector<int>& path_store){
@@ -30,7 +30,9 @@
 #include <sstream>
 #include <stdexcept>
 #include <cstdio>
+#include <memory>
 #include "Graph.h"
+#include "monosat/dgl/alg/SegmentedLog.h"
 
 namespace dgl {
 
@@ -56,9 +58,140 @@ public:
     typedef typename Graph<Weight>::Edge Edge;
     typedef typename Graph<Weight>::FullEdge FullEdge;
     typedef typename Graph<Weight>::EdgeChange EdgeChange;
+    typedef typename Graph<Weight>::EdgeRange EdgeRange;
+
+    /**
+     * Compressed sparse row adjacency: the edges of node n are stored contiguously,
+     * in edges[start[n]] .. edges[start[n]+count[n]-1], in the order they were added to the graph.
+     * Each node's run has room for cap[n] edges. Adding an edge to a full run moves that run to the end of the array,
+     * with twice as much room, so adding an edge takes amortized constant time. The gaps left behind by moved runs
+     * are compacted away once they make up half of the array.
+     */
+    struct Adjacency {
+        std::vector<int> start;
+        std::vector<int> count;
+        std::vector<int> cap;
+        std::vector<Edge> edges;
+        int64_t gaps = 0;
+
+        inline int size(int node) const{
+            return count[node];
+        }
+
+        inline Edge& get(int node, int i){
+            return edges[start[node] + i];
+        }
+
+        inline const Edge& get(int node, int i) const{
+            return edges[start[node] + i];
+        }
+
+        inline EdgeRange range(int node){
+            Edge* base = edges.data() + start[node];
+            return {base, base + count[node]};
+        }
+
+        void addNode(){
+            start.push_back(edges.size());
+            count.push_back(0);
+            cap.push_back(0);
+        }
+
+        inline void add(int node, const Edge& e){
+            if(count[node] == cap[node]){
+                grow(node);
+            }
+            edges[start[node] + count[node]++] = e;
+        }
+
+        void clear(){
+            start.clear();
+            count.clear();
+            cap.clear();
+            edges.clear();
+            gaps = 0;
+        }
+
+    private:
+        void grow(int node){
+            if(gaps * 2 >= (int64_t) edges.size() && gaps > 0){
+                compact();
+            }
+            int new_cap = std::max(2 * cap[node], 2);
+            if(start[node] + cap[node] == edges.size()){
+                //this run is already at the end of the array, so it can grow in place
+                edges.resize(start[node] + new_cap);
+            }else{
+                int new_start = edges.size();
+                edges.resize(new_start + new_cap);
+                std::copy(edges.begin() + start[node], edges.begin() + start[node] + count[node],
+                          edges.begin() + new_start);
+                gaps += cap[node];
+                start[node] = new_start;
+            }
+            cap[node] = new_cap;
+        }
+
+        //Move every node's run back into node order, with no gaps between them (or spare room in them).
+        void compact(){
+            std::vector<Edge> packed;
+            packed.reserve(edges.size() - gaps);
+            for(int n = 0; n < start.size(); n++){
+                int new_start = packed.size();
+                packed.insert(packed.end(), edges.begin() + start[n], edges.begin() + start[n] + count[n]);
+                start[n] = new_start;
+                cap[n] = count[n];
+            }
+            edges.swap(packed);
+            gaps = 0;
+        }
+    };
+
+    /**
+     * The nodes and edges of a graph, without their enabled/disabled status or weights.
+     * Several DynamicGraphs can share one topology (see shareTopology()), in which case each edge must be added
+     * to each of those graphs, with the same ID and endpoints.
+     */
+    struct Topology {
+        int num_nodes = 0;
+        std::vector<FullEdge> all_edges;
+        Adjacency adjacency_list;
+        Adjacency inverted_adjacency_list;
+        Adjacency adjacency_undirected_list;
+
+        bool hasEdge(int edgeID) const{
+            return edgeID < all_edges.size() && all_edges[edgeID].id == edgeID;
+        }
+
+        void addNode(){
+            num_nodes++;
+            adjacency_list.addNode();
+            inverted_adjacency_list.addNode();
+            adjacency_undirected_list.addNode();
+        }
+
+        void addEdge(int from, int to, int id){
+            if(all_edges.size() <= id)
+                all_edges.resize(id + 1);
+            all_edges[id] = {from, to, id};
+            adjacency_list.add(from, {to, id});
+            inverted_adjacency_list.add(to, {from, id});
+            adjacency_undirected_list.add(from, {to, id});
+            adjacency_undirected_list.add(to, {from, id});
+        }
+
+        void clear(){
+            num_nodes = 0;
+            all_edges.clear();
+            adjacency_list.clear();
+            inverted_adjacency_list.clear();
+            adjacency_undirected_list.clear();
+        }
+    };
 private:
-    std::vector<bool> edge_status;
-    std::vector<bool> edge_status_const;
+    //one byte per edge, rather than std::vector<bool>, so that checking an edge's status is a single load
+    std::vector<char> edge_status;
+    std::vector<char> edge_status_const;
     std::vector<Weight> weights;
     int num_nodes = 0;
     int num_edges = 0;
@@ -66,6 +199,8 @@ private:
     bool is_changed = false;
     std::vector<DynamicGraphAlgorithm*> dynamic_algs;
     std::vector<int> dynamic_history_pos;
+    //the number of history clears at the time each dynamic algorithm last reported its history position
+    std::vector<int64_t> dynamic_history_epoch;
 
     int64_t history_offset = 0;
 
@@ -76,6 +211,9 @@ public:
 
     bool adaptive_history_clear = false;
     int64_t historyClearInterval = 1000;
+    //History clears keep any changes that registered dynamic algorithms have not yet read, unless that would leave
+    //more than this many times the history clear interval in the history.
+    int64_t historyRetentionFactor = 4;
     int modifications = 0;
     int additions = 0;
     int deletions = 0;
@@ -85,26 +223,17 @@ public:
     int64_t historyclears = 0;
     int64_t skipped_historyclears = 0;
 
-    std::vector<std::vector<Edge>> adjacency_list;
-    std::vector<std::vector<Edge>> inverted_adjacency_list;
-    std::vector<std::vector<Edge>> adjacency_undirected_list;
-public:
-
-
 private:
-#ifdef DEBUG_DGL
-    public:
-#endif
-    std::vector<FullEdge> all_edges;
+    std::shared_ptr<Topology> topology;
 public:
 
 private:
-    std::vector<EdgeChange> history;
+    alg::SegmentedLog<EdgeChange> history;
 public:
     //Logfile information if recording is enabled.
     FILE* _outfile = nullptr;
 
-    DynamicGraph(){
+    DynamicGraph() : topology(std::make_shared<Topology>()){
     }
 
     ~DynamicGraph(){
@@ -125,10 +254,21 @@ public:
         return hasEdge(edgeID) && getEdge(edgeID).from == getEdge(edgeID).to;
     }
 
+    //Make this graph share its nodes and edges with another graph, instead of storing a separate copy of them.
+    //Must be called before any nodes or edges are added to this graph. After this, each node and edge must
+    //be added to both graphs, in the same order (edges with the same IDs), but edge status, weights and history
+    //remain separate.
+    void shareTopology(DynamicGraph& other){
+        if(num_nodes > 0 || num_edges > 0){
+            throw std::runtime_error("DynamicGraph topology can only be shared before any nodes or edges are added");
+        }
+        topology = other.topology;
+    }
+
     //SLOW!
     bool hasEdge(int from, int to) const override{
-        for(int i = 0; i < adjacency_list[from].size(); i++){
-            if(adjacency_list[from][i].node == to && edgeEnabled(adjacency_list[from][i].id)){
+        for(int i = 0; i < topology->adjacency_list.size(from); i++){
+            if(topology->adjacency_list.get(from, i).node == to && edgeEnabled(topology->adjacency_list.get(from, i).id)){
                 return true;
             }
         }
@@ -137,17 +277,18 @@ public:
 
     //SLOW! Returns -1 if there is no edge
     int getEdge(int from, int to) const override{
-        for(int i = 0; i < adjacency_list[from].size(); i++){
-            if(adjacency_list[from][i].node == to && edgeEnabled(adjacency_list[from][i].id)){
-                return adjacency_list[from][i].id;
+        for(int i = 0; i < topology->adjacency_list.size(from); i++){
+            if(topology->adjacency_list.get(from, i).node == to && edgeEnabled(topology->adjacency_list.get(from, i).id)){
+                return topology->adjacency_list.get(from, i).id;
             }
         }
         return -1;
     }
 
     bool hasEdgeUndirected(int from, int to) const override{
-        for(int i = 0; i < adjacency_undirected_list[from].size(); i++){
-            if(adjacency_undirected_list[from][i].node == to && edgeEnabled(adjacency_undirected_list[from][i].id)){
+        for(int i = 0; i < topology->adjacency_undirected_list.size(from); i++){
+            if(topology->adjacency_undirected_list.get(from, i).node == to &&
+               edgeEnabled(topology->adjacency_undirected_list.get(from, i).id)){
                 return true;
             }
         }
@@ -155,10 +296,9 @@ public:
     }
 
     int addNode() override{
-
-        adjacency_list.push_back({}); //adj list
-        adjacency_undirected_list.push_back({});
-        inverted_adjacency_list.push_back({});
+        if(num_nodes == topology->num_nodes){
+            topology->addNode();
+        }//else, this node was already added by another graph sharing this topology
         modifications++;
         additions = modifications;
         deletions = modifications;
@@ -176,7 +316,7 @@ public:
     }
 
     //true iff the edge's current assignment will never be altered.
-    bool isConstant(int edgeID) const override{
+    inline bool isConstant(int edgeID) const override{
         return edge_status_const[edgeID];
     }
 
@@ -184,13 +324,13 @@ public:
         edge_status_const[edgeID] = true;
     }
 
-    bool edgeEnabled(int edgeID) const override{
+    inline bool edgeEnabled(int edgeID) const override{
         assert(edgeID < edge_status.size());
         return edge_status[edgeID];
     }
 
     bool isEdge(int edgeID) const override{
-        return edgeID < all_edges.size() && all_edges[edgeID].id == edgeID;
+        return edgeID < edge_status.size() && topology->hasEdge(edgeID);
     }
 
     bool hasEdge(int edgeID) const override{
@@ -212,9 +352,13 @@ public:
         }
 
         num_edges = next_id;
-        adjacency_list[from].push_back({to, id});
-        adjacency_undirected_list[from].push_back({to, id});
-        adjacency_undirected_list[to].push_back({from, id});
+        if(!topology->hasEdge(id)){
+            topology->addEdge(from, to, id);
+        }else{
+            //this edge was already added by another graph sharing this topology
+            assert(topology->all_edges[id].from == from);
+            assert(topology->all_edges[id].to == to);
+        }
         if(edge_status.size() <= id)
             edge_status.resize(id + 1);
 
@@ -222,10 +366,6 @@ public:
             edge_status_const.resize(id + 1, false);
         }
 
-        inverted_adjacency_list[to].push_back({from, id});
-        if(all_edges.size() <= id)
-            all_edges.resize(id + 1);
-        all_edges[id] = {from, to, id}; //,weight};
         if(weights.size() <= id)
             weights.resize(id + 1, 1);//default uninitialized edges to unit weight.
         weights[id] = weight;
@@ -251,8 +391,8 @@ public:
     }
 
     int nEdgeIDs() override{
-        assert(num_edges == all_edges.size());
-        return num_edges;        //all_edges.size();
+        assert(num_edges <= topology->all_edges.size());
+        return num_edges;
     }
 
     inline int nodes() const override{
@@ -267,9 +407,9 @@ public:
         assert(node >= 0);
         assert(node < nodes());
         if(undirected){
-            return adjacency_undirected_list[node].size();
+            return topology->adjacency_undirected_list.size(node);
         }else{
-            return adjacency_list[node].size();
+            return topology->adjacency_list.size(node);
         }
     }
 
@@ -295,9 +435,9 @@ public:
         assert(node >= 0);
         assert(node < nodes());
         if(undirected){
-            return adjacency_undirected_list[node].size();
+            return topology->adjacency_undirected_list.size(node);
         }else{
-            return inverted_adjacency_list[node].size();
+            return topology->inverted_adjacency_list.size(node);
         }
     }
 
@@ -306,9 +446,9 @@ public:
         assert(node < nodes());
         assert(i < nIncident(node, undirected));
         if(undirected){
-            return adjacency_undirected_list[node][i];
+            return topology->adjacency_undirected_list.get(node, i);
         }else{
-            return adjacency_list[node][i];
+            return topology->adjacency_list.get(node, i);
         }
     }
 
@@ -317,14 +457,34 @@ public:
         assert(node < nodes());
         assert(i < nIncoming(node, undirected));
         if(undirected){
-            return adjacency_undirected_list[node][i];
+            return topology->adjacency_undirected_list.get(node, i);
         }else{
-            return inverted_adjacency_list[node][i];
+            return topology->inverted_adjacency_list.get(node, i);
+        }
+    }
+
+    inline EdgeRange incidentEdges(int node, bool undirected = false) override{
+        assert(node >= 0);
+        assert(node < nodes());
+        if(undirected){
+            return topology->adjacency_undirected_list.range(node);
+        }else{
+            return topology->adjacency_list.range(node);
+        }
+    }
+
+    inline EdgeRange incomingEdges(int node, bool undirected = false) override{
+        assert(node >= 0);
+        assert(node < nodes());
+        if(undirected){
+            return topology->adjacency_undirected_list.range(node);
+        }else{
+            return topology->inverted_adjacency_list.range(node);
         }
     }
 
     std::vector<FullEdge>& getEdges() override{
-        return all_edges;
+        return topology->all_edges;
     }
 
     std::vector<Weight>& getWeights() override{
@@ -341,7 +501,7 @@ public:
     }
 
     FullEdge& getEdge(int id) override{
-        return all_edges[id];
+        return topology->all_edges[id];
     }
 
     void setEdgeEnabled(int id, bool enable) override{
@@ -353,11 +513,11 @@ public:
     }
 
     void enableEdge(int id) override{
-        enableEdge(all_edges[id].from, all_edges[id].to, id);
+        enableEdge(getEdge(id).from, getEdge(id).to, id);
     }
 
     void disableEdge(int id) override{
-        disableEdge(all_edges[id].from, all_edges[id].to, id);
+        disableEdge(getEdge(id).from, getEdge(id).to, id);
     }
 
     void enableEdge(int from, int to, int id) override{
@@ -498,10 +658,10 @@ public:
             printf("n%d\n", i);
         }
 
-        for(int i = 0; i < adjacency_list.size(); i++){
-            for(int j = 0; j < adjacency_list[i].size(); j++){
-                int id = adjacency_list[i][j].id;
-                int u = adjacency_list[i][j].node;
+        for(int i = 0; i < num_nodes; i++){
+            for(int j = 0; j < topology->adjacency_list.size(i); j++){
+                int id = topology->adjacency_list.get(i, j).id;
+                int u = topology->adjacency_list.get(i, j).node;
                 const char* s = "black";
                 if(edgeEnabled(id))
                     s = "red";
@@ -550,6 +710,7 @@ public:
         }
         dynamic_algs.push_back(alg);
         dynamic_history_pos.push_back(0);
+        dynamic_history_epoch.push_back(-1);
         //n_dynamic_algs_updtodate+= (historySize()==0);
         return dynamic_algs.size() - 1;
     }
@@ -567,6 +728,7 @@ public:
         }
         //bool was_uptodate = dynamic_history_pos[algorithmID]==historySize();
         dynamic_history_pos[algorithmID] = historyPos;
+        dynamic_history_epoch[algorithmID] = historyclears;
 /*		if(!was_uptodate && historyPos ==historySize()){
 			dynamic_history_pos[algorithmID]++;
 		}*/
@@ -582,50 +744,52 @@ public:
         return history.size() + history_offset;
     }
 
+    int historyStart() override{
+        return history_offset;
+    }
+
     int getCurrentHistory() const override{
         return modifications;
     }
 
 
+    /**
+     * Discards the changes that every registered dynamic algorithm has already read, once the history grows
+     * past the history clear interval. Positions in the history are unchanged by this, and it does not count as a
+     * history clear, so algorithms that have read past historyStart() can continue to update incrementally.
+     * (Algorithms that have not reported their position since the last full history clear are ignored.)
+     * If that would retain too much of the history, or if forceClear is set, the entire history is cleared instead,
+     * and every algorithm will treat the history as lost.
+     */
     void clearHistory(bool forceClear = false) override{
-        //int64_t expect=std::max(1000,historyClearInterval*edges());
-        //check whether we can do a cheap history cleanup (without resetting all the dynamic algorithms)
         if(disable_history_clears)
             return;
-
-        if(history.size()
-           && (forceClear
-               || (history.size()
-                   >= (std::min((int64_t) history.max_size(), (adaptive_history_clear ?
-                                                               std::max((int64_t) 1000, historyClearInterval * edges())
-                                                                                      : historyClearInterval)))))){//){
-
-
-            if(!forceClear && dynamic_history_clears > 0){
-                int n_uptodate = 0;
+        int64_t interval = adaptive_history_clear ? std::max((int64_t) 1000, historyClearInterval * edges())
+                                                  : historyClearInterval;
+        if(history.size() && (forceClear || history.size() >= interval)){
+            if(!forceClear && historySize() < INT32_MAX / 2){
+                int64_t min_pos = historySize();
                 for(int algorithmID = 0; algorithmID < dynamic_algs.size(); algorithmID++){
-                    if(dynamic_history_pos[algorithmID] != historySize()){
-                        if(dynamic_history_clears == 2){
-                            dynamic_algs[algorithmID]->updateHistory();
-                            if(dynamic_history_pos[algorithmID] == historySize()){
-                                n_uptodate++;
-                            }
-                        }
-                    }else{
-                        n_uptodate++;
+                    if(dynamic_history_epoch[algorithmID] != historyclears
+                       || dynamic_history_pos[algorithmID] < history_offset){
+                        continue;
+                    }
+                    if(dynamic_history_clears == 2 && dynamic_history_pos[algorithmID] != historySize()){
+                        dynamic_algs[algorithmID]->updateHistory();
                     }
+                    min_pos = std::min(min_pos, (int64_t) dynamic_history_pos[algorithmID]);
                 }
-
-                if(n_uptodate == dynamic_algs.size()){
-                    //we can skip this history clear.
-                    history_offset = historySize();
-                    skipped_historyclears++;
-                    history.clear();
-                    assert(history_offset == historySize());
+                assert(min_pos >= history_offset);
+                if(historySize() - min_pos < historyRetentionFactor * interval){
+                    if(min_pos > history_offset){
+                        history.popFront(min_pos - history_offset);
+                        history_offset = min_pos;
+                        skipped_historyclears++;
+                    }
                     return;
                 }
             }
-            previous_history_size = history.size();
+            previous_history_size = historySize();
             history_offset = 0;
             history.clear();
             historyclears++;
@@ -707,17 +871,17 @@ public:
         num_edges = 0;
         next_id = 0;
 
-
-        adjacency_list.clear();
-        inverted_adjacency_list.clear();
-        adjacency_undirected_list.clear();
-        all_edges.clear();
+        //Clears the topology in place, so any other graphs sharing it must be cleared as well.
+        topology->clear();
         history.clear();
         invalidate();
         clearHistory(true);
     }
 
+public:
+    //The copy gets its own topology, even if it previously shared one with this graph.
     void copyTo(DynamicGraph& to){
+        to.topology = std::make_shared<Topology>();
         to.clear();
 
         to.num_nodes = num_nodes;
@@ -725,10 +889,7 @@ public:
         to.next_id = next_id;
         to.edge_status = edge_status;
         to.historyClearInterval = historyClearInterval;
-        to.adjacency_list = adjacency_list;
-        to.adjacency_undirected_list = adjacency_undirected_list;
-        to.all_edges = all_edges;
-        to.inverted_adjacency_list = inverted_adjacency_list;
+        to.topology = std::make_shared<Topology>(*topology);
 
 
     }
@@ -209,10 +209,6 @@ public:
         int s = source;
         int t = sink;
         //see http://cstheory.stackexchange.com/a/10186
-        static int it = 0;
-        if(++it == 56){
-            int a = 1;
-        }
 
         if(g.outfile()){
             fprintf(g.outfile(), "f %d %d\n", s, t);
@@ -242,7 +238,8 @@ public:
             assert(curflow==expected_flow);
 #endif
             return curflow;
-        }else if(last_modification <= 0 || g.nHistoryClears() != last_history_clear || g.changed()){
+        }else if(last_modification <= 0 || g.nHistoryClears() != last_history_clear || history_qhead < g.historyStart()
+                 || g.changed()){
             F.clear();
             F.resize(g.edges());
             changed.resize(g.nEdgeIDs());
@@ -262,6 +259,7 @@ public:
             dbg_print_graph(s, t, -1, -1);
             f = maxFlow_p(s, t);
             dbg_print_graph(s, t, -1, -1);
+            history_qhead = g.historySize();
         }
 
 #ifdef DEBUG_MAXFLOW
@@ -687,7 +685,7 @@ private:
     void dbg_print_graph(int from, int to, Weight shortCircuitFrom = -1, Weight shortCircuitTo = -1){
 #ifdef DEBUG_DGL
         return;
-        static int it = 0;
+        static thread_local int it = 0;
         if (++it == 6) {
             int a = 1;
         }
@@ -80,6 +80,31 @@ public:
         int prev_mod;
     };
 
+    /**
+     * A contiguous run of edges, as returned by incidentEdges() and incomingEdges().
+     * Only valid until the next node or edge is added to the graph.
+     */
+    struct EdgeRange {
+        Edge* first;
+        Edge* last;
+
+        Edge* begin() const{
+            return first;
+        }
+
+        Edge* end() const{
+            return last;
+        }
+
+        int size() const{
+            return last - first;
+        }
+
+        Edge& operator[](int i) const{
+            return first[i];
+        }
+    };
+
 
     Graph(){
     }
@@ -137,6 +162,12 @@ public:
 
     virtual Edge& incoming(int node, int i, bool undirected = false) =0;
 
+    //All of the outgoing (or, if undirected, all of the adjacent) edges of a node, enabled or not.
+    virtual EdgeRange incidentEdges(int node, bool undirected = false) =0;
+
+    //All of the incoming (or, if undirected, all of the adjacent) edges of a node, enabled or not.
+    virtual EdgeRange incomingEdges(int node, bool undirected = false) =0;
+
     virtual std::vector<FullEdge>& getEdges()=0;
 
     virtual std::vector<Weight>& getWeights()=0;
@@ -178,6 +209,9 @@ public:
 
     virtual int historySize()=0;
 
+    //The position of the oldest change still in the history; changes before it have been discarded.
+    virtual int historyStart()=0;
+
     virtual int nHistoryClears() const =0;
 
     virtual int getCurrentHistory() const =0;
@@ -31,6 +31,7 @@
 #include <vector>
 
 #include "EdmondsKarpDynamic.h"
+#include "DinitzDynamic.h"
 #include <algorithm>
 #include <limits>
 
@@ -40,7 +41,7 @@
 
 #ifdef LINK_GPL
 //IF GPL sources are included, link them here.
-//Else, the 'KohliTorr' class will instead just be the much sloder EdmondsKarp algorithm
+//Else, the 'KohliTorr' class will instead just be the (MIT licensed) DinitzDynamic algorithm
 #include "monosat/dgl/alg/dyncut/graph.h"
 
 namespace dgl {
@@ -619,10 +620,6 @@ public:
         if(same_source_sink)
             return INF;
         //see http://cstheory.stackexchange.com/a/10186
-        static int it = 0;
-        if(++it == 54){
-            int a = 1;
-        }
 
         if(g.outfile()){
             fprintf(g.outfile(), "f %d %d\n", s, t);
@@ -642,12 +639,13 @@ public:
         }else if(!kt || last_modification <= 0 || kt->get_node_num() != g.nodes()
                  || edge_enabled.size() != g.edges()){
             initKT();
+            history_qhead = g.historySize();
         }else if(!g.changed() && last_history_clear >= 0 && last_history_clear == g.nHistoryClears() - 1 &&
-                 history_qhead == g.getPreviousHistorySize()){
+                 history_qhead == g.getPreviousHistorySize() && g.historyStart() == 0){
             //no information was lost in the history clear
             history_qhead = 0;
             last_history_clear = g.nHistoryClears();
-        }else if(g.nHistoryClears() != last_history_clear || g.changed()){
+        }else if(g.nHistoryClears() != last_history_clear || history_qhead < g.historyStart() || g.changed()){
             stats_reinits++;
 
             for(int edgeid = 0; edgeid < g.edges(); edgeid++){
@@ -918,7 +916,7 @@ private:
 
         if (edge_enabled.size() < g.edges())
             return;
-        static int it = 0;
+        static thread_local int it = 0;
         if (++it == 6) {
             int a = 1;
         }
@@ -1282,12 +1280,12 @@ public:
 };
 }
 #else
-//Simple wrapper around EdmondsKarpDynamic, to be used if GPL sources are not linked.
+//Simple wrapper around DinitzDynamic, to be used if GPL sources are not linked.
 //Notably, in this case, the 'KohliTorr' class does NOT implement Kohli and Torr's algorithm at all.
 namespace dgl {
 template<typename Weight>
-class KohliTorr : public EdmondsKarpDynamic<Weight> {
-    static bool warning_issued;
+class KohliTorr : public DinitzDynamic<Weight> {
+    static thread_local bool warning_issued;
 public:
     double stats_calc_time = 0;
     double stats_flow_time = 0;
@@ -1295,22 +1293,22 @@ public:
     int64_t stats_flow_calcs = 0;
     int64_t stats_inits=0;
     int64_t stats_reinits=0;
-    KohliTorr(Graph<Weight>& g,  int source, int sink,bool kt_preserve_order) :EdmondsKarpDynamic<Weight>(g,source,sink){
+    KohliTorr(Graph<Weight>& g,  int source, int sink,bool kt_preserve_order) :DinitzDynamic<Weight>(g,source,sink){
 
     }
     std::string getName() override {
-        return "EdmondsKarpDynamicKT()";
+        return "DinitzDynamicKT()";
     }
     const Weight update() override {
         if (!warning_issued){
             warning_issued=true;
-            fprintf(stderr,"Warning: MonoSAT was built without GPL sources, which will greatly decrease performance of the solver on maximum flow predicates.\n");
+            fprintf(stderr,"Warning: MonoSAT was built without GPL sources, so kohli-torr maximum flow predicates will use dinitz-dynamic instead.\n");
         }
-        return EdmondsKarpDynamic<Weight>::update();
+        return DinitzDynamic<Weight>::update();
     }
 };
 template<typename Weight>
-bool KohliTorr<Weight>::warning_issued = false;
+thread_local bool KohliTorr<Weight>::warning_issued = false;
 }
 #endif
 
@@ -0,0 +1,369 @@
+/**************************************************************************************************
+ The MIT License (MIT)
+
+ Copyright (c) 2014, Sam Bayless
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef MULTISOURCEREACH_H_
+#define MULTISOURCEREACH_H_
+
+#include <vector>
+#include <cstdint>
+#include <cinttypes>
+#include <stdexcept>
+#include "Graph.h"
+#include "DynamicGraph.h"
+#include "Reach.h"
+
+namespace dgl {
+
+/**
+ * Computes reachability from many sources at once over the same graph.
+ * Each node stores one bit per source, packed into 64-bit words, and sets of sources are pushed across
+ * each enabled edge a word at a time. A single traversal of the graph therefore answers the
+ * reachability queries of up to 64 sources (and the inner word loops are simple enough to be vectorized
+ * by the compiler, handling 256 sources per instruction with AVX2).
+ *
+ * The engine only tracks connectivity; it does not record paths.
+ * Each source is accessed through its own SourceReach, which implements the Reach interface.
+ */
+template<typename Weight, typename Graph = DynamicGraph<Weight>>
+class MultiSourceReach {
+public:
+    typedef uint64_t Word;
+    static const int word_bits = 64;
+
+    Graph& g;
+
+private:
+    int last_modification = -1;
+    int last_addition = -1;
+    int last_deletion = -1;
+    int history_qhead = 0;
+    int last_history_clear = 0;
+    int last_nodes = 0;
+    bool sources_changed = true;
+
+    std::vector<int> sources;
+    //number of words per node
+    int n_words = 0;
+    //seen[u*n_words+w] holds the sources (64 per word) that reach node u
+    std::vector<Word> seen;
+    //sources that have reached node u, but that have not yet been pushed along u's outgoing edges
+    std::vector<Word> pending;
+    std::vector<char> in_queue;
+    std::vector<int> q;
+    std::vector<Word> tmp;
+    //nodes whose bits changed (possibly repeatedly) since the start of the current log epoch.
+    //A new epoch starts after every full recompute (when any bit may have changed), or if the log grows too long.
+    std::vector<int> changed_nodes;
+    int64_t log_epoch = 0;
+
+public:
+    int64_t stats_full_updates = 0;
+    int64_t stats_fast_updates = 0;
+    int64_t stats_skipped_updates = 0;
+    int64_t num_updates = 0;
+
+    MultiSourceReach(Graph& graph) :
+            g(graph){
+
+    }
+
+    /**
+     * Adds a new source to the engine, and returns its index.
+     */
+    int addSource(int s){
+        sources.push_back(s);
+        sources_changed = true;
+        return sources.size() - 1;
+    }
+
+    void setSource(int index, int s){
+        assert(index >= 0 && index < sources.size());
+        if(sources[index] != s){
+            sources[index] = s;
+            sources_changed = true;
+        }
+    }
+
+    int getSource(int index) const{
+        return sources[index];
+    }
+
+    int nSources() const{
+        return sources.size();
+    }
+
+    bool connected_unsafe(int index, int t) const{
+        assert(index >= 0 && index < sources.size());
+        if(t >= last_nodes)
+            return false;
+        return (seen[t * n_words + (index / word_bits)] >> (index % word_bits)) & 1;
+    }
+
+    bool upToDate() const{
+        return !sources_changed && last_modification > 0 && g.getCurrentHistory() == last_modification;
+    }
+
+    int64_t logEpoch() const{
+        return log_epoch;
+    }
+
+    int nChanged() const{
+        return changed_nodes.size();
+    }
+
+    int getChanged(int i) const{
+        return changed_nodes[i];
+    }
+
+    void update(){
+        if(upToDate()){
+            stats_skipped_updates++;
+            return;
+        }
+
+        if(g.nHistoryClears() != last_history_clear || history_qhead < g.historyStart() || sources_changed
+           || g.nodes() != last_nodes
+           || last_modification <= 0 || last_deletion != g.nDeletions() || !update_additions()){
+            recompute();
+        }
+        if(changed_nodes.size() > 2 * last_nodes){
+            changed_nodes.clear();
+            log_epoch++;
+        }
+
+        num_updates++;
+        last_modification = g.getCurrentHistory();
+        last_deletion = g.nDeletions();
+        last_addition = g.nAdditions();
+        history_qhead = g.historySize();
+        last_history_clear = g.nHistoryClears();
+    }
+
+    /**
+     * Provides the Reach interface for a single source of a MultiSourceReach engine.
+     * All of the sources of an engine are brought up to date together, the first time any one of them is updated.
+     */
+    template<class Status = Reach::NullStatus>
+    class SourceReach : public Reach {
+        MultiSourceReach& engine;
+        Status& status;
+        const int index;
+        const int reportPolarity;
+        int last_modification = -1;
+        int64_t last_engine_update = -1;
+        int64_t num_updates = 0;
+        //the reachability last reported to status for each node (or 2, if it hasn't been reported)
+        std::vector<char> reported;
+        int64_t reported_epoch = -1;
+        int changed_qhead = 0;
+
+        void report(int u){
+            char reachable = engine.connected_unsafe(index, u);
+            if(reported[u] == reachable)
+                return;
+            reported[u] = reachable;
+            if(reachable && reportPolarity >= 0){
+                status.setReachable(u, true);
+            }else if(!reachable && reportPolarity <= 0){
+                status.setReachable(u, false);
+            }
+        }
+
+    public:
+        SourceReach(MultiSourceReach& engine, int s, Status& status = Reach::nullStatus, int reportPolarity = 0) :
+                engine(engine), status(status), index(engine.addSource(s)), reportPolarity(reportPolarity){
+
+        }
+
+        int numUpdates() const override{
+            return num_updates;
+        }
+
+        void setSource(int s) override{
+            engine.setSource(index, s);
+            last_modification = -1;
+            reported.clear();
+        }
+
+        int getSource() override{
+            return engine.getSource(index);
+        }
+
+        void update() override{
+            if(last_modification > 0 && engine.g.getCurrentHistory() == last_modification && engine.upToDate()){
+                return;
+            }
+            engine.update();
+            if(last_engine_update == engine.num_updates){
+                last_modification = engine.g.getCurrentHistory();
+                return;
+            }
+            num_updates++;
+            last_engine_update = engine.num_updates;
+            last_modification = engine.g.getCurrentHistory();
+
+            //Only report the nodes whose bits changed since this source last reported
+            if(reported_epoch != engine.logEpoch() || reported.size() != engine.g.nodes()){
+                reported_epoch = engine.logEpoch();
+                reported.resize(engine.g.nodes(), 2);
+                for(int u = 0; u < engine.g.nodes(); u++){
+                    report(u);
+                }
+            }else{
+                for(int i = changed_qhead; i < engine.nChanged(); i++){
+                    report(engine.getChanged(i));
+                }
+            }
+            changed_qhead = engine.nChanged();
+        }
+
+        bool connected_unsafe(int t) override{
+            return engine.connected_unsafe(index, t);
+        }
+
+        bool connected_unchecked(int t) override{
+            assert(engine.upToDate());
+            return connected_unsafe(t);
+        }
+
+        bool connected(int t) override{
+            update();
+            return connected_unsafe(t);
+        }
+
+        int previous(int node) override{
+            assert(false);
+            throw std::runtime_error("Paths are not tracked by MultiSourceReach");
+        }
+
+        int incomingEdge(int node) override{
+            assert(false);
+            throw std::runtime_error("Paths are not tracked by MultiSourceReach");
+        }
+
+        void printStats() override{
+            printf("Multi-source reach (%d sources): %" PRId64 " full updates, %" PRId64 " incremental updates, %" PRId64
+                   " skipped\n", engine.nSources(), engine.stats_full_updates, engine.stats_fast_updates,
+                   engine.stats_skipped_updates);
+        }
+    };
+
+private:
+
+    inline void enqueue(int v){
+        if(!in_queue[v]){
+            in_queue[v] = true;
+            q.push_back(v);
+        }
+    }
+
+    //Push the pending sources of each queued node along its enabled outgoing edges, until no new sources reach any node.
+    void propagate(){
+        for(int i = 0; i < q.size(); i++){
+            int u = q[i];
+            in_queue[u] = false;
+            Word* pu = &pending[u * n_words];
+            for(int w = 0; w < n_words; w++){
+                tmp[w] = pu[w];
+                pu[w] = 0;
+            }
+            for(auto& edge:g.incidentEdges(u)){
+                if(!g.edgeEnabled(edge.id))
+                    continue;
+                int v = edge.node;
+                Word* sv = &seen[v * n_words];
+                Word* pv = &pending[v * n_words];
+                Word changed = 0;
+                for(int w = 0; w < n_words; w++){
+                    Word d = tmp[w] & ~sv[w];
+                    sv[w] |= d;
+                    pv[w] |= d;
+                    changed |= d;
+                }
+                if(changed){
+                    enqueue(v);
+                    changed_nodes.push_back(v);
+                }
+            }
+        }
+        q.clear();
+    }
+
+    void recompute(){
+        stats_full_updates++;
+        sources_changed = false;
+        last_nodes = g.nodes();
+        n_words = (sources.size() + word_bits - 1) / word_bits;
+        seen.clear();
+        seen.resize(last_nodes * n_words, 0);
+        pending.clear();
+        pending.resize(last_nodes * n_words, 0);
+        in_queue.clear();
+        in_queue.resize(last_nodes, false);
+        tmp.resize(n_words);
+        q.clear();
+        changed_nodes.clear();
+        log_epoch++;
+
+        for(int i = 0; i < sources.size(); i++){
+            int s = sources[i];
+            if(s < 0 || s >= last_nodes)
+                continue;
+            Word bit = Word(1) << (i % word_bits);
+            seen[s * n_words + i / word_bits] |= bit;
+            pending[s * n_words + i / word_bits] |= bit;
+            enqueue(s);
+        }
+        propagate();
+    }
+
+    //If only edges were enabled since the last update, push the sources of their tails across them.
+    bool update_additions(){
+        assert(last_deletion == g.nDeletions());
+        for(int i = history_qhead; i < g.historySize(); i++){
+            auto& change = g.getChange(i);
+            if(!change.addition || !g.edgeEnabled(change.id))
+                continue;
+            int from = g.getEdge(change.id).from;
+            int to = g.getEdge(change.id).to;
+            Word* sf = &seen[from * n_words];
+            Word* st = &seen[to * n_words];
+            Word* pt = &pending[to * n_words];
+            Word changed = 0;
+            for(int w = 0; w < n_words; w++){
+                Word d = sf[w] & ~st[w];
+                st[w] |= d;
+                pt[w] |= d;
+                changed |= d;
+            }
+            if(changed){
+                enqueue(to);
+                changed_nodes.push_back(to);
+            }
+        }
+        propagate();
+        stats_fast_updates++;
+        return true;
+    }
+};
+
+};
+#endif /* MULTISOURCEREACH_H_ */
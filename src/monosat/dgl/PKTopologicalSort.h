@@ -272,6 +272,18 @@ private:
         }
         int from = g.getEdge(edgeID).from;
         int to = g.getEdge(edgeID).to;
+        if(from == to){
+            //a self loop is a cycle on its own (and is invisible to the ordinal checks below)
+            assert(cycle.size() == 0);
+            has_cycle = true;
+            cycleComputed = true;
+            num_strict_sccs = 1;
+            cycle.push_back(edgeID);
+            in_cycle[from] = true;
+            edge_in_cycle[edgeID] = true;
+            has_topo = false;
+            return;
+        }
         lower_bound = ord[to];
         upper_bound = ord[from];
         if(lower_bound < upper_bound){
@@ -486,7 +498,7 @@ private:
             return;
         }
         //assert ords are unique
-        static std::vector<bool> seen;
+        static thread_local std::vector<bool> seen;
         seen.clear();
         seen.resize(g.nodes());
         for(int i = 0;i<ord.size();i++){
@@ -512,7 +524,7 @@ private:
 
 public:
     void update() override{
-        static int iteration = 0;
+        static thread_local int iteration = 0;
 
 
         if(last_modification > 0 && g.getCurrentHistory() == last_modification){
@@ -525,7 +537,8 @@ public:
         if(local_it == 5){
             int a = 1;
         }
-        if(last_modification <= 0 || g.nHistoryClears() != last_history_clear || g.changed()){
+        if(last_modification <= 0 || g.nHistoryClears() != last_history_clear || history_qhead < g.historyStart()
+           || g.changed()){
             setNodes(g.nodes());
             cycleComputed = false;
             has_cycle = false;
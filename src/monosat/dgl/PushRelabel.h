@@ -0,0 +1,464 @@
+/**************************************************************************************************
+ The MIT License (MIT)
+
+ Copyright (c) 2014, Sam Bayless
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef PUSH_RELABEL_H
+#define PUSH_RELABEL_H
+
+#include "Graph.h"
+#include "MaxFlow.h"
+#include <vector>
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+
+namespace dgl {
+
+/**
+ * Highest-label push-relabel maximum flow (Goldberg and Tarjan), with the gap and global relabeling heuristics
+ * (as described by Cherkassky and Goldberg, 1997).
+ *
+ * The flow is computed from scratch whenever the graph has changed, in two phases: the first finds a maximum
+ * preflow (which already determines the maximum flow value and the minimum cut), and the second returns the
+ * excess that could not reach the sink to the source, so that the edge flows form a valid flow.
+ * This tends to be much faster than the augmenting path algorithms on large, dense networks.
+ */
+template<typename Weight = int>
+class PushRelabel : public MaxFlow<Weight> {
+    struct LocalEdge {
+        int from;
+        int id;
+        bool backward = false;
+
+        LocalEdge(int from = -1, int id = -1, bool backward = false) :
+                from(from), id(id), backward(backward){
+
+        }
+    };
+
+    Graph <Weight>& g;
+    int source = -1;
+    int sink = -1;
+
+    Weight curflow = 0;
+    int last_modification = -1;
+    int last_history_clear = -1;
+    int64_t num_updates = 0;
+
+    std::vector<Weight> F;
+    std::vector<Weight> old_F;
+    //The capacity of each edge (or 0, if the edge is disabled).
+    std::vector<Weight> cap;
+    std::vector<Weight> excess;
+
+    std::vector<int> label;
+    //current arc of each node, in its combined forward and backward adjacency list
+    std::vector<int> current;
+    //active[d] holds the nodes with label d that have (or had, when they were inserted) positive excess
+    std::vector<std::vector<int>> active;
+    int max_active = -1;
+    //doubly linked lists of all the nodes with each label below n, for the gap heuristic
+    std::vector<int> bucket_head;
+    std::vector<int> bucket_next;
+    std::vector<int> bucket_prev;
+    int max_label = 0;
+    int64_t work = 0;
+    std::vector<int> Q;
+
+    std::vector<int> changed_edges;
+    std::vector<bool> changed;
+    std::vector<bool> seen;
+
+public:
+    int64_t stats_pushes = 0;
+    int64_t stats_relabels = 0;
+    int64_t stats_gaps = 0;
+    int64_t stats_global_relabels = 0;
+
+    PushRelabel(Graph <Weight>& g, int source = -1, int sink = -1) :
+            g(g), source(source), sink(sink){
+
+    }
+
+    int getSource() const override{
+        return source;
+    }
+
+    int getSink() const override{
+        return sink;
+    }
+
+    int numUpdates() const override{
+        return num_updates;
+    }
+
+    void setSource(int s) override{
+        if(source == s){
+            return;
+        }
+        source = s;
+        last_modification = -1;
+    }
+
+    void setSink(int t) override{
+        if(sink == t){
+            return;
+        }
+        sink = t;
+        last_modification = -1;
+    }
+
+    void printStats() override{
+        printf("Push-relabel: %" PRId64 " pushes, %" PRId64 " relabels, %" PRId64 " gaps, %" PRId64
+               " global relabels\n", stats_pushes, stats_relabels, stats_gaps, stats_global_relabels);
+    }
+
+    const Weight update() override{
+        if(last_modification > 0 && g.getCurrentHistory() == last_modification
+           && last_history_clear == g.nHistoryClears()){
+            return curflow;
+        }
+        if(g.outfile()){
+            fprintf(g.outfile(), "f %d %d\n", source, sink);
+            fflush(g.outfile());
+        }
+        int n = g.nodes();
+        std::swap(F, old_F);
+        F.clear();
+        F.resize(g.edges(), 0);
+        cap.resize(g.edges());
+        for(int i = 0; i < g.edges(); i++){
+            cap[i] = (g.isEdge(i) && g.edgeEnabled(i)) ? g.getWeight(i) : 0;
+        }
+        excess.clear();
+        excess.resize(n, 0);
+        label.resize(n);
+        current.resize(n);
+        bucket_head.resize(n + 1);
+        bucket_next.resize(n);
+        bucket_prev.resize(n);
+        active.resize(n + 1);
+
+        curflow = 0;
+        if(source != sink){
+            //saturate the edges leaving the source
+            for(int i = 0; i < g.nIncident(source); i++){
+                int id = g.incident(source, i).id;
+                int v = g.incident(source, i).node;
+                if(v != source && cap[id] > 0){
+                    F[id] = cap[id];
+                    excess[v] += cap[id];
+                    excess[source] -= cap[id];
+                }
+            }
+            //find a maximum preflow
+            discharge(sink, source);
+            curflow = excess[sink];
+            //then return the excess that cannot reach the sink back to the source
+            discharge(source, sink);
+        }
+        changed.resize(g.edges());
+        for(int i = 0; i < g.edges(); i++){
+            if(i >= old_F.size() || F[i] != old_F[i])
+                markChanged(i);
+        }
+        dbg_check_flow();
+        num_updates++;
+        last_modification = g.getCurrentHistory();
+        last_history_clear = g.nHistoryClears();
+        return curflow;
+    }
+
+    std::vector<int>& getChangedEdges() override{
+        return changed_edges;
+    }
+
+    void clearChangedEdges() override{
+        for(int edgeID : changed_edges){
+            assert(changed[edgeID]);
+            changed[edgeID] = false;
+        }
+        changed_edges.clear();
+    }
+
+    const Weight minCut(std::vector<MaxFlowEdge>& cut) override{
+        Weight f = this->maxFlow();
+        cut.clear();
+        //the source side of the cut is the set of nodes reachable from the source in the residual graph
+        seen.clear();
+        seen.resize(g.nodes(), false);
+        Q.clear();
+        if(source != sink){
+            seen[source] = true;
+            Q.push_back(source);
+        }
+        for(int j = 0; j < Q.size(); j++){
+            int u = Q[j];
+            int n_arcs = g.nIncident(u) + g.nIncoming(u);
+            for(int i = 0; i < n_arcs; i++){
+                int v;
+                LocalEdge e = arc(u, i, v);
+                if(!seen[v] && residual(e) > 0){
+                    seen[v] = true;
+                    Q.push_back(v);
+                }
+            }
+        }
+        for(int u : Q){
+            for(int i = 0; i < g.nIncident(u); i++){
+                int id = g.incident(u, i).id;
+                int v = g.incident(u, i).node;
+                if(g.edgeEnabled(id) && !seen[v]){
+                    assert(F[id] == cap[id]);
+                    cut.push_back(MaxFlowEdge{u, v, id});
+                }
+            }
+        }
+        return f;
+    }
+
+    const Weight getEdgeCapacity(int id) override{
+        return g.getWeight(id);
+    }
+
+    const Weight getEdgeFlow(int id) override{
+        return F[id];
+    }
+
+    const Weight getEdgeResidualCapacity(int id) override{
+        return g.getWeight(id) - F[id];
+    }
+
+private:
+
+    void markChanged(int edgeID){
+        if(!changed[edgeID]){
+            changed[edgeID] = true;
+            changed_edges.push_back(edgeID);
+        }
+    }
+
+    Weight residual(const LocalEdge& e) const{
+        return e.backward ? F[e.id] : cap[e.id] - F[e.id];
+    }
+
+    //The arc in position 'i' of the combined forward and backward adjacency list of 'u', and the node it leads to.
+    LocalEdge arc(int u, int i, int& v){
+        int n_incident = g.nIncident(u);
+        if(i < n_incident){
+            v = g.incident(u, i).node;
+            return LocalEdge(u, g.incident(u, i).id, false);
+        }else{
+            v = g.incoming(u, i - n_incident).node;
+            return LocalEdge(u, g.incoming(u, i - n_incident).id, true);
+        }
+    }
+
+    void bucketInsert(int u){
+        int d = label[u];
+        bucket_prev[u] = -1;
+        bucket_next[u] = bucket_head[d];
+        if(bucket_head[d] >= 0)
+            bucket_prev[bucket_head[d]] = u;
+        bucket_head[d] = u;
+        if(d > max_label)
+            max_label = d;
+    }
+
+    void bucketRemove(int u){
+        int d = label[u];
+        if(bucket_prev[u] >= 0)
+            bucket_next[bucket_prev[u]] = bucket_next[u];
+        else
+            bucket_head[d] = bucket_next[u];
+        if(bucket_next[u] >= 0)
+            bucket_prev[bucket_next[u]] = bucket_prev[u];
+    }
+
+    void activate(int u){
+        active[label[u]].push_back(u);
+        if(label[u] > max_active)
+            max_active = label[u];
+    }
+
+    /**
+     * Set each node's label to its distance to 'target' in the residual graph (or n, if it cannot reach the target),
+     * and rebuild the buckets. The node 'other' (the other terminal) is never labeled or activated.
+     */
+    void globalRelabel(int target, int other){
+        stats_global_relabels++;
+        int n = g.nodes();
+        for(int u = 0; u < n; u++){
+            label[u] = n;
+            current[u] = 0;
+        }
+        for(int d = 0; d <= n; d++){
+            bucket_head[d] = -1;
+            active[d].clear();
+        }
+        max_label = 0;
+        max_active = -1;
+        label[target] = 0;
+        Q.clear();
+        Q.push_back(target);
+        for(int j = 0; j < Q.size(); j++){
+            int x = Q[j];
+            //an edge y->x is a residual arc into x if it has spare capacity, and an edge x->y is if it has flow.
+            for(int i = 0; i < g.nIncoming(x); i++){
+                int y = g.incoming(x, i).node;
+                int id = g.incoming(x, i).id;
+                if(label[y] == n && y != other && cap[id] - F[id] > 0){
+                    label[y] = label[x] + 1;
+                    Q.push_back(y);
+                }
+            }
+            for(int i = 0; i < g.nIncident(x); i++){
+                int y = g.incident(x, i).node;
+                int id = g.incident(x, i).id;
+                if(label[y] == n && y != other && F[id] > 0){
+                    label[y] = label[x] + 1;
+                    Q.push_back(y);
+                }
+            }
+        }
+        for(int u : Q){
+            if(u == target)
+                continue;
+            bucketInsert(u);
+            if(excess[u] > 0)
+                activate(u);
+        }
+    }
+
+    //Relabel every node above the now empty label 'd' to n, as none of them can reach the target any more.
+    void gap(int d){
+        stats_gaps++;
+        int n = g.nodes();
+        for(int l = d + 1; l <= max_label; l++){
+            for(int u = bucket_head[l]; u >= 0; u = bucket_next[u]){
+                label[u] = n;
+            }
+            bucket_head[l] = -1;
+        }
+        max_label = d - 1;
+    }
+
+    //Push excess towards 'target', highest label first, until no node that can reach it has any excess left.
+    void discharge(int target, int other){
+        int n = g.nodes();
+        int64_t global_relabel_threshold = 6 * (int64_t) n + g.edges() / 2;
+        globalRelabel(target, other);
+        work = 0;
+        while(max_active >= 0){
+            if(active[max_active].empty()){
+                max_active--;
+                continue;
+            }
+            int u = active[max_active].back();
+            active[max_active].pop_back();
+            if(label[u] != max_active || !(excess[u] > 0))
+                continue;//stale entry
+            int n_arcs = g.nIncident(u) + g.nIncoming(u);
+            while(excess[u] > 0){
+                for(; current[u] < n_arcs; current[u]++){
+                    int v;
+                    LocalEdge e = arc(u, current[u], v);
+                    if(label[v] + 1 != label[u])
+                        continue;
+                    Weight r = residual(e);
+                    if(!(r > 0))
+                        continue;
+                    Weight m = std::min(excess[u], r);
+                    if(e.backward){
+                        F[e.id] -= m;
+                    }else{
+                        F[e.id] += m;
+                    }
+                    stats_pushes++;
+                    bool was_inactive = !(excess[v] > 0);
+                    excess[u] -= m;
+                    excess[v] += m;
+                    if(was_inactive && v != target && v != other)
+                        activate(v);
+                    if(!(excess[u] > 0))
+                        break;
+                }
+                if(!(excess[u] > 0))
+                    break;
+                //relabel u
+                stats_relabels++;
+                int old_label = label[u];
+                int new_label = n;
+                for(int i = 0; i < n_arcs; i++){
+                    int v;
+                    LocalEdge e = arc(u, i, v);
+                    if(label[v] + 1 < new_label && residual(e) > 0)
+                        new_label = label[v] + 1;
+                }
+                work += 12 + n_arcs;
+                bucketRemove(u);
+                current[u] = 0;
+                if(bucket_head[old_label] < 0){
+                    //u was the last node with its label, so nothing above it can reach the target either
+                    label[u] = n;
+                    gap(old_label);
+                    break;
+                }
+                label[u] = new_label;
+                if(new_label >= n)
+                    break;
+                bucketInsert(u);
+            }
+            if(excess[u] > 0 && label[u] < n){
+                activate(u);
+            }
+            if(work > global_relabel_threshold){
+                globalRelabel(target, other);
+                work = 0;
+            }
+        }
+    }
+
+    void dbg_check_flow(){
+#ifdef DEBUG_DGL
+        for(int u = 0; u < g.nodes(); u++){
+            Weight inflow = 0;
+            Weight outflow = 0;
+            for(int i = 0; i < g.nIncoming(u); i++){
+                int id = g.incoming(u, i).id;
+                assert(F[id] >= 0 && F[id] <= cap[id]);
+                inflow += F[id];
+            }
+            for(int i = 0; i < g.nIncident(u); i++){
+                outflow += F[g.incident(u, i).id];
+            }
+            if(u == source){
+                assert(source == sink || outflow - inflow == curflow);
+            }else if(u == sink){
+                assert(inflow - outflow == curflow);
+            }else{
+                assert(inflow == outflow);
+            }
+        }
+#endif
+    }
+};
+};
+#endif
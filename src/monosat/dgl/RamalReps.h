@@ -45,7 +45,7 @@ namespace dgl {
 template<typename Weight = int, typename Graph = DynamicGraph<Weight>, class Status = typename Distance<Weight>::NullStatus>
 class RamalReps : public Distance<Weight>, public DynamicGraphAlgorithm {
 public:
-    static bool ever_warned_about_zero_weights;
+    static thread_local bool ever_warned_about_zero_weights;
     Graph& g;
     std::vector<Weight>& weights;
     std::vector<Weight> local_weights;
@@ -304,8 +304,6 @@ public:
     }
 
     void AddEdge(int edgeID){
-        static int iter = 0;
-        ++iter;
         dbg_delta_lite();
         assert(g.edgeEnabled(edgeID));
         if(edgeInShortestPathGraph[edgeID])
@@ -415,8 +413,6 @@ public:
 
     //Called if an edge weight is decreased
     void DecreaseWeight(int edgeID){
-        static int iter = 0;
-        ++iter;
         dbg_delta_lite();
         assert(g.edgeEnabled(edgeID));
         //if (edgeInShortestPathGraph[edgeID]) //must process this whether or not the edge is in the shortest path
@@ -853,7 +849,7 @@ public:
             //fprintf(g.outfile(), "r %d\n", getSource());
         }
 
-        static int iteration = 0;
+        static thread_local int iteration = 0;
         int local_it = ++iteration;
         if(local_it == 7668){
             int a = 1;
@@ -914,9 +910,9 @@ public:
             dijkstras.update();
         }else{
 
-            if(last_history_clear != g.nHistoryClears()){
+            if(last_history_clear != g.nHistoryClears() || history_qhead < g.historyStart()){
                 if(!g.changed() && last_history_clear >= 0 && last_history_clear == g.nHistoryClears() - 1 &&
-                   history_qhead == g.getPreviousHistorySize()){
+                   history_qhead == g.getPreviousHistorySize() && g.historyStart() == 0){
                     //no information was lost in the history clear
                     history_qhead = 0;
                     last_history_clear = g.nHistoryClears();
@@ -1015,8 +1011,8 @@ public:
         last_modification = g.getCurrentHistory();
         last_deletion = g.nDeletions();
         last_addition = g.nAdditions();
-        g.updateAlgorithmHistory(this, alg_id, history_qhead);
         history_qhead = g.historySize();
+        g.updateAlgorithmHistory(this, alg_id, history_qhead);
         last_history_clear = g.nHistoryClears();
 
 #ifdef DEBUG_RAMAL
@@ -1488,8 +1484,6 @@ public:
     }
 
     void AddEdge(int edgeID){
-        static int iter = 0;
-        ++iter;
         dbg_delta_lite();
         assert(g.edgeEnabled(edgeID));
         if(edgeInShortestPathGraph[edgeID])
@@ -1949,9 +1943,9 @@ public:
             }
         }
 
-        if(last_history_clear != g.nHistoryClears()){
+        if(last_history_clear != g.nHistoryClears() || history_qhead < g.historyStart()){
             if(!g.changed() && last_history_clear >= 0 && last_history_clear == g.nHistoryClears() - 1 &&
-               history_qhead == g.getPreviousHistorySize()){
+               history_qhead == g.getPreviousHistorySize() && g.historyStart() == 0){
                 //no information was lost in the history clear
                 history_qhead = 0;
                 last_history_clear = g.nHistoryClears();
@@ -2192,6 +2186,6 @@ public:
 };
 
 template<typename Weight, typename Graph, class Status>
-bool RamalReps<Weight, Graph, Status>::ever_warned_about_zero_weights = false;
+thread_local bool RamalReps<Weight, Graph, Status>::ever_warned_about_zero_weights = false;
 };
 #endif
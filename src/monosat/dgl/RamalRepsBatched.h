@@ -46,7 +46,7 @@ namespace dgl {
 template<typename Weight = int, typename Graph = DynamicGraph<Weight>, class Status = typename Distance<Weight>::NullStatus>
 class RamalRepsBatched : public Distance<Weight>, public DynamicGraphAlgorithm {
 public:
-    static bool ever_warned_about_zero_weights;
+    static thread_local bool ever_warned_about_zero_weights;
     Graph& g;
     std::vector<Weight>& weights;
     std::vector<Weight> local_weights;
@@ -310,8 +310,6 @@ public:
 
     //Called when an edge is enabled
     void AddEdge(int edgeID){
-        static int iter = 0;
-        ++iter;
 
         assert(g.edgeEnabled(edgeID));
         if(edgeInShortestPathGraph[edgeID])
@@ -384,8 +382,6 @@ public:
 
     //Called if an edge weight is decreased
     void DecreaseWeight(int edgeID){
-        static int iter = 0;
-        ++iter;
 
         assert(g.edgeEnabled(edgeID));
         //if (edgeInShortestPathGraph[edgeID]) //must process this whether or not the edge is in the shortest path
@@ -524,7 +520,7 @@ public:
             //fprintf(g.outfile(), "r %d\n", getSource());
         }
 
-        static int iteration = 0;
+        static thread_local int iteration = 0;
         int local_it = ++iteration;
         if(local_it == 5){
             int a = 1;
@@ -592,9 +588,9 @@ public:
             dijkstras.update();
         }else{
 
-            if(last_history_clear != g.nHistoryClears()){
+            if(last_history_clear != g.nHistoryClears() || history_qhead < g.historyStart()){
                 if(!g.changed() && last_history_clear >= 0 && last_history_clear == g.nHistoryClears() - 1 &&
-                   history_qhead == g.getPreviousHistorySize()){
+                   history_qhead == g.getPreviousHistorySize() && g.historyStart() == 0){
                     //no information was lost in the history clear
                     history_qhead = 0;
                     last_history_clear = g.nHistoryClears();
@@ -698,8 +694,8 @@ public:
         last_modification = g.getCurrentHistory();
         last_deletion = g.nDeletions();
         last_addition = g.nAdditions();
-        g.updateAlgorithmHistory(this, alg_id, history_qhead);
         history_qhead = g.historySize();
+        g.updateAlgorithmHistory(this, alg_id, history_qhead);
         last_history_clear = g.nHistoryClears();
 
 #ifdef DEBUG_RAMAL
@@ -1508,8 +1504,6 @@ public:
     }
 
     void AddEdge(int edgeID){
-        static int iter = 0;
-        ++iter;
         dbg_delta_lite();
         assert(g.edgeEnabled(edgeID));
         if(edgeInShortestPathGraph[edgeID])
@@ -1731,9 +1725,9 @@ public:
             }
         }
 
-        if(last_history_clear != g.nHistoryClears()){
+        if(last_history_clear != g.nHistoryClears() || history_qhead < g.historyStart()){
             if(!g.changed() && last_history_clear >= 0 && last_history_clear == g.nHistoryClears() - 1 &&
-               history_qhead == g.getPreviousHistorySize()){
+               history_qhead == g.getPreviousHistorySize() && g.historyStart() == 0){
                 //no information was lost in the history clear
                 history_qhead = 0;
                 last_history_clear = g.nHistoryClears();
@@ -2467,6 +2461,6 @@ public:
 };
 
 template<typename Weight, typename Graph, class Status>
-bool RamalRepsBatched<Weight, Graph, Status>::ever_warned_about_zero_weights = false;
+thread_local bool RamalRepsBatched<Weight, Graph, Status>::ever_warned_about_zero_weights = false;
 };
 #endif
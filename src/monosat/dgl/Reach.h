@@ -91,6 +91,17 @@ public:
 
     }
 
+    //Optional: mark a node as an active target (a node whose status the caller still needs to learn), or not.
+    //Algorithms that support it may stop traversing the graph once the status of every active target is settled.
+    //connected() still gives an exact answer for every node, but connected_unsafe() and connected_unchecked()
+    //may report that an inactive node is not connected, even if it is.
+    //Currently only BFSReachability implements this (and CachedReach forwards it). Incremental algorithms such as
+    //RamalReps repair their distances to every node after each change, and cannot skip inactive nodes without
+    //leaving those distances invalid for later updates, so they ignore it.
+    virtual void setTargetActive(int node, bool active){
+
+    }
+
     virtual void clearCache(){
 
     }
@@ -154,11 +154,11 @@ public:
             printf("n%d\n", i);
         }*/
 
-        for (int i = 0; i < g.adjacency_list.size(); i++) {
-            for (int j = 0; j < g.adjacency_list[i].size(); j++) {
-                int id = g.adjacency_list[i][j].id;
+        for (int i = 0; i < g.nodes(); i++) {
+            for (int j = 0; j < g.nIncident(i); j++) {
+                int id = g.incident(i, j).id;
 
-                int u = g.adjacency_list[i][j].node;
+                int u = g.incident(i, j).node;
                 const char * s = "black";
                 if(in_tree[id]){
                     s="green";
@@ -662,7 +662,7 @@ public:
     }
 
     void update() override{
-        static int iteration = 0;
+        static thread_local int iteration = 0;
         int local_it = ++iteration;
 
         if(g.outfile()){
@@ -679,7 +679,8 @@ public:
         }
 
         assert(components_to_visit.size() == 0);
-        if(last_modification <= 0 || g.changed() || last_history_clear != g.nHistoryClears()){
+        if(last_modification <= 0 || g.changed() || last_history_clear != g.nHistoryClears()
+           || history_qhead < g.historyStart()){
             INF = 1;                //g.nodes()+1;
             setNodes(g.nodes());
 
@@ -0,0 +1,403 @@
+/**************************************************************************************************
+ The MIT License (MIT)
+
+ Copyright (c) 2014, Sam Bayless
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef TRANSITIVE_CLOSURE_H_
+#define TRANSITIVE_CLOSURE_H_
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include "Graph.h"
+#include "DynamicGraph.h"
+#include "AllPairs.h"
+
+namespace dgl {
+/**
+ * All pairs reachability, as a packed bit-matrix holding the transitive closure of the enabled edges
+ * (row u has bit v set if v is reachable from u).
+ *
+ * The closure is computed from scratch by condensing the strongly connected components of the graph (Tarjan),
+ * and OR-ing the rows of each component's successors into its row, in reverse topological order.
+ * Edge additions are applied incrementally: if v was not already reachable from u, then the row of v is OR-ed into
+ * the row of every node that reaches u. Any deletion causes the closure to be recomputed, once, at the next update.
+ *
+ * This only tracks reachability: reachable pairs report distance 0 (and unreachable pairs INF), so it should not be
+ * used for reachability constraints with a bounded number of steps.
+ * Paths are not stored; getPath() finds one on demand, by a breadth first search restricted to nodes that reach the target.
+ */
+template<typename Weight, typename Graph = DynamicGraph<Weight>, class Status = AllPairs::NullStatus>
+class TransitiveClosure : public AllPairs, public DynamicGraphAlgorithm {
+public:
+
+    Graph& g;
+    Status& status;
+    int last_modification = -1;
+    int last_addition = -1;
+    int last_deletion = -1;
+    int history_qhead = 0;
+
+    int last_history_clear = 0;
+    int alg_id = -1;
+
+    std::vector<int> sources;
+    int INF = 0;
+
+    const int reportPolarity;
+
+    //number of nodes, and of 64-bit words per row, that the matrix was laid out for
+    int n = 0;
+    int words = 0;
+    std::vector<uint64_t> matrix;
+    std::vector<bool> edge_enabled;
+    std::vector<int> additions;
+
+    //Tarjan's algorithm
+    std::vector<int> index;
+    std::vector<int> lowlink;
+    std::vector<int> component;
+    std::vector<int> scc_stack;
+    std::vector<bool> on_stack;
+    struct Frame {
+        int node;
+        int edge;
+    };
+    std::vector<Frame> dfs_stack;
+    std::vector<int> members;
+    std::vector<int> last_merged;
+
+    std::vector<int> q;
+    std::vector<int> prev;
+
+public:
+    int stats_full_updates = 0;
+    int stats_fast_updates = 0;
+    int stats_fast_failed_updates = 0;
+    int stats_skip_deletes = 0;
+    int stats_skipped_updates = 0;
+    int stats_num_skipable_deletions = 0;
+    int64_t stats_insertions = 0;
+    int64_t stats_redundant_insertions = 0;
+
+    double stats_full_update_time = 0;
+    double stats_fast_update_time = 0;
+
+    TransitiveClosure(Graph& graph, Status& _status = AllPairs::nullStatus, int _reportPolarity = 0) :
+            g(graph), status(_status), reportPolarity(_reportPolarity){
+        alg_id = g.addDynamicAlgorithm(this);
+    }
+
+    std::string getName() override{
+        return "TransitiveClosure";
+    }
+
+    void addSource(int s) override{
+        assert(!std::count(sources.begin(), sources.end(), s));
+        sources.push_back(s);
+
+        last_modification = -1;
+        last_addition = -1;
+        last_deletion = -1;
+    }
+
+    int64_t num_updates = 0;
+
+    int numUpdates() const override{
+        return num_updates;
+    }
+
+private:
+
+    uint64_t* row(int u){
+        return &matrix[(size_t) u * words];
+    }
+
+    bool bit(int u, int v) const{
+        return (matrix[(size_t) u * words + (v >> 6)] >> (v & 63)) & 1;
+    }
+
+    void setBit(int u, int v){
+        matrix[(size_t) u * words + (v >> 6)] |= ((uint64_t) 1) << (v & 63);
+    }
+
+    //dest |= src, over one row; written as a plain loop over words so that the compiler can vectorize it.
+    void orRow(uint64_t* __restrict dest, const uint64_t* __restrict src){
+        for(int i = 0; i < words; i++){
+            dest[i] |= src[i];
+        }
+    }
+
+    void setNodes(int nodes){
+        n = nodes;
+        words = (n + 63) / 64;
+        matrix.clear();
+        matrix.resize((size_t) n * words, 0);
+        index.resize(n);
+        lowlink.resize(n);
+        component.resize(n);
+        on_stack.resize(n);
+        last_merged.resize(n);
+        prev.clear();
+        prev.resize(n, -1);
+        INF = n + 1;
+    }
+
+    //Recompute the closure from scratch
+    void recompute(){
+        stats_full_updates++;
+        setNodes(g.nodes());
+        edge_enabled.clear();
+        edge_enabled.resize(g.edges());
+        for(int edgeID = 0; edgeID < g.edges(); edgeID++){
+            edge_enabled[edgeID] = g.hasEdge(edgeID) && g.edgeEnabled(edgeID);
+        }
+        for(int u = 0; u < n; u++){
+            index[u] = -1;
+            on_stack[u] = false;
+            last_merged[u] = -1;
+        }
+        int next_index = 0;
+        int n_components = 0;
+        //Tarjan's algorithm finishes each component after all the components reachable from it,
+        //so each component's row can be completed as soon as the component is found.
+        for(int root = 0; root < n; root++){
+            if(index[root] >= 0)
+                continue;
+            dfs_stack.push_back({root, 0});
+            index[root] = lowlink[root] = next_index++;
+            scc_stack.push_back(root);
+            on_stack[root] = true;
+            while(dfs_stack.size()){
+                int u = dfs_stack.back().node;
+                int i = dfs_stack.back().edge;
+                if(i < g.nIncident(u)){
+                    dfs_stack.back().edge++;
+                    if(!edge_enabled[g.incident(u, i).id])
+                        continue;
+                    int w = g.incident(u, i).node;
+                    if(index[w] < 0){
+                        index[w] = lowlink[w] = next_index++;
+                        scc_stack.push_back(w);
+                        on_stack[w] = true;
+                        dfs_stack.push_back({w, 0});
+                    }else if(on_stack[w]){
+                        lowlink[u] = std::min(lowlink[u], index[w]);
+                    }
+                }else{
+                    dfs_stack.pop_back();
+                    if(dfs_stack.size()){
+                        int parent = dfs_stack.back().node;
+                        lowlink[parent] = std::min(lowlink[parent], lowlink[u]);
+                    }
+                    if(lowlink[u] == index[u]){
+                        int c = n_components++;
+                        members.clear();
+                        int w;
+                        do{
+                            w = scc_stack.back();
+                            scc_stack.pop_back();
+                            on_stack[w] = false;
+                            component[w] = c;
+                            members.push_back(w);
+                        }while(w != u);
+                        completeComponent(c);
+                    }
+                }
+            }
+        }
+    }
+
+    //Fill in the row of each member of component c, given the rows of all the components it reaches.
+    void completeComponent(int c){
+        int rep = members[0];
+        uint64_t* r = row(rep);
+        for(int w:members){
+            setBit(rep, w);
+        }
+        for(int w:members){
+            for(int i = 0; i < g.nIncident(w); i++){
+                if(!edge_enabled[g.incident(w, i).id])
+                    continue;
+                int x = g.incident(w, i).node;
+                int cx = component[x];
+                if(cx != c && last_merged[cx] != c){
+                    last_merged[cx] = c;
+                    orRow(r, row(x));
+                }
+            }
+        }
+        for(int k = 1; k < members.size(); k++){
+            std::copy(r, r + words, row(members[k]));
+        }
+    }
+
+    void insertEdge(int from, int to){
+        stats_insertions++;
+        if(bit(from, to)){
+            stats_redundant_insertions++;
+            return;
+        }
+        const uint64_t* r = row(to);
+        int word = from >> 6;
+        uint64_t mask = ((uint64_t) 1) << (from & 63);
+        for(int u = 0; u < n; u++){
+            //if 'to' reaches 'from', then row(to) is OR-ed into itself here, which leaves it unchanged
+            if(matrix[(size_t) u * words + word] & mask){
+                orRow(row(u), r);
+            }
+        }
+    }
+
+public:
+
+    void update() override{
+        if(last_modification > 0 && g.getCurrentHistory() == last_modification){
+            stats_skipped_updates++;
+            return;
+        }
+
+        if(last_deletion == g.nDeletions()){
+            stats_num_skipable_deletions++;
+        }
+
+        bool full = last_modification <= 0 || g.changed() || n != g.nodes()
+                    || g.nHistoryClears() != last_history_clear || history_qhead < g.historyStart();
+        additions.clear();
+        if(!full){
+            for(int i = history_qhead; i < g.historySize() && !full; i++){
+                int edgeID = g.getChange(i).id;
+                if(g.edgeEnabled(edgeID) != edge_enabled[edgeID]){
+                    if(edge_enabled[edgeID]){
+                        //deletions are applied by recomputing the closure
+                        full = true;
+                    }else{
+                        additions.push_back(edgeID);
+                    }
+                }
+            }
+            //each insertion scans a column of the matrix, and may OR a row into every other row
+            if(!full && (int64_t) additions.size() * n > g.edges() + n){
+                full = true;
+            }
+        }
+        if(full){
+            recompute();
+        }else{
+            stats_fast_updates++;
+            for(int edgeID:additions){
+                if(!edge_enabled[edgeID]){
+                    edge_enabled[edgeID] = true;
+                    insertEdge(g.getEdge(edgeID).from, g.getEdge(edgeID).to);
+                }
+            }
+        }
+
+        for(int s:sources){
+            for(int u = 0; u < n; u++){
+                if(!bit(s, u) && reportPolarity < 1){
+                    status.setReachable(s, u, false);
+                    status.setMininumDistance(s, u, false, INF);
+                }else if(bit(s, u) && reportPolarity > -1){
+                    status.setReachable(s, u, true);
+                    status.setMininumDistance(s, u, true, 0);
+                }
+            }
+        }
+        num_updates++;
+        last_modification = g.getCurrentHistory();
+        last_deletion = g.nDeletions();
+        last_addition = g.nAdditions();
+
+        history_qhead = g.historySize();
+        g.updateAlgorithmHistory(this, alg_id, history_qhead);
+        last_history_clear = g.nHistoryClears();
+    }
+
+    void updateHistory() override{
+        update();
+    }
+
+    //Return a shortest path of nodes from 'from' to 'to', found by breadth first search over the nodes that reach 'to'.
+    void getPath(int from, int to, std::vector<int>& path) override{
+        update();
+        assert(bit(from, to));
+        path.clear();
+        q.clear();
+        q.push_back(from);
+        prev[from] = from;
+        bool found = from == to;
+        for(int i = 0; i < q.size() && !found; i++){
+            int u = q[i];
+            for(int j = 0; j < g.nIncident(u); j++){
+                if(!edge_enabled[g.incident(u, j).id])
+                    continue;
+                int w = g.incident(u, j).node;
+                if(prev[w] < 0 && bit(w, to)){
+                    prev[w] = u;
+                    q.push_back(w);
+                    if(w == to){
+                        found = true;
+                        break;
+                    }
+                }
+            }
+        }
+        assert(found);
+        for(int u = to; u != from; u = prev[u]){
+            path.push_back(u);
+        }
+        path.push_back(from);
+        std::reverse(path.begin(), path.end());
+        for(int u:q){
+            prev[u] = -1;
+        }
+    }
+
+    bool connected_unsafe(int from, int t) override{
+        return from < n && t < n && bit(from, t);
+    }
+
+    bool connected_unchecked(int from, int t) override{
+        assert(last_modification == g.getCurrentHistory());
+        return connected_unsafe(from, t);
+    }
+
+    bool connected(int from, int t) override{
+        if(last_modification != g.getCurrentHistory())
+            update();
+        return bit(from, t);
+    }
+
+    int distance(int from, int t) override{
+        if(connected(from, t))
+            return 0;
+        else
+            return INF;
+    }
+
+    int distance_unsafe(int from, int t) override{
+        if(connected_unsafe(from, t))
+            return 0;
+        else
+            return INF;
+    }
+};
+};
+#endif
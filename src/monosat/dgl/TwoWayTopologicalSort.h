@@ -0,0 +1,637 @@
+/**************************************************************************************************
+ The MIT License (MIT)
+
+ Copyright (c) 2014, Sam Bayless
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef TWOWAY_TOPOLOGICAL_SORT_H_
+#define TWOWAY_TOPOLOGICAL_SORT_H_
+
+//Incremental cycle detection by two-way ordered search, as in "Incremental Cycle Detection, Topological Ordering,
+//and Strong Component Maintenance" (Haeupler, Kavitha, Mathew, Sen, Tarjan, 2012); see also the two-way search of
+//Bender, Fineman, Gilbert and Tarjan (2016).
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include "Graph.h"
+#include "Cycle.h"
+#include "DynamicGraph.h"
+
+namespace dgl {
+/**
+ * Maintains a topological order of the enabled edges of a graph, detecting directed cycles as edges are added.
+ *
+ * The order is kept as a linked list of nodes with increasing (sparse) integer labels, so that nodes can be
+ * moved between any two neighbours. When an edge (u,v) is added against the order, a forward search from v
+ * and a backward search from u are interleaved, visiting nodes in order of their labels, until either the two
+ * searches meet (a cycle), or the next node of the forward search comes after the next node of the backward
+ * search. Only the nodes visited so far are then moved, which is typically far fewer than the nodes between
+ * v and u in the order that PK would reorder.
+ *
+ * An edge that would close a cycle is left out of the order as 'pending', and one cycle through it is kept as
+ * a witness. While the witness is intact, further additions are simply made pending, and deletions outside
+ * of it cost O(1); deleting an edge from a DAG never invalidates the order. Only once the witness is broken
+ * are the pending edges tried again. Large batches of additions (as after backtracking) are handled by
+ * recomputing the order from scratch, in linear time.
+ *
+ * getDirectedCycle() returns a shortest cycle through the pending edge of the witness.
+ */
+template<typename Weight, typename Graph = DynamicGraph<Weight>>
+class TwoWayTopologicalSort : public Cycle, public DynamicGraphAlgorithm {
+public:
+
+    Graph& g;
+
+    int last_modification = -1;
+    int history_qhead = 0;
+    int last_history_clear = 0;
+    int alg_id = -1;
+
+    //If a single update adds more than this fraction of the edges of the graph (or more than this fraction must
+    //be retried after a cycle is broken), the order is recomputed from scratch rather than incrementally.
+    double rebuild_fraction = 0.25;
+
+    int64_t stats_searches = 0;
+    int64_t stats_search_nodes = 0;
+    int64_t stats_relabels = 0;
+
+private:
+
+    enum EdgeState {
+        ABSENT = 0, ORDERED = 1, PENDING = 2
+    };
+
+    //node marks used by the searches
+    enum {
+        FORWARD = 1, BACKWARD = 2, POPPED = 4
+    };
+
+    static const int64_t label_spacing = ((int64_t) 1) << 24;
+
+    std::vector<char> edge_state;
+    //edges that close a cycle, and are not respected by the order (may contain stale entries)
+    std::vector<int> pending;
+    std::vector<bool> queued;
+    std::vector<int> additions;
+
+    //the nodes in topological order, as a doubly linked list with increasing labels
+    std::vector<int64_t> label;
+    std::vector<int> next;
+    std::vector<int> prev;
+    int first = -1;
+
+    //a cycle through the pending edge witness_edge, or empty if the graph is acyclic
+    int witness_edge = -1;
+    std::vector<int> witness;
+    std::vector<bool> edge_in_witness;
+
+    std::vector<int> cycle;
+    bool cycle_computed = false;
+    std::vector<int> ignore;
+
+    std::vector<char> mark;
+    std::vector<int> parent_edge;
+    std::vector<int> touched;
+    std::vector<int> forward_heap;
+    std::vector<int> backward_heap;
+    std::vector<int> forward_visited;
+    std::vector<int> backward_visited;
+    std::vector<int> q;
+
+    struct LabelGreater {
+        const std::vector<int64_t>& label;
+
+        bool operator()(int a, int b) const{
+            return label[a] > label[b];
+        }
+
+        LabelGreater(const std::vector<int64_t>& label) : label(label){
+        }
+    };
+
+    struct LabelLess {
+        const std::vector<int64_t>& label;
+
+        bool operator()(int a, int b) const{
+            return label[a] < label[b];
+        }
+
+        LabelLess(const std::vector<int64_t>& label) : label(label){
+        }
+    };
+
+public:
+
+    TwoWayTopologicalSort(Graph& graph, int _reportPolarity = 0) :
+            g(graph){
+        alg_id = g.addDynamicAlgorithm(this);
+    }
+
+    std::string getName() override{
+        return "TwoWayTopologicalSort";
+    }
+
+private:
+
+    void setWitness(int edgeID){
+        witness_edge = edgeID;
+        for(int e:witness){
+            edge_in_witness[e] = true;
+        }
+    }
+
+    void clearWitness(){
+        for(int e:witness){
+            edge_in_witness[e] = false;
+        }
+        witness.clear();
+        witness_edge = -1;
+    }
+
+    void unlink(int n){
+        if(prev[n] >= 0){
+            next[prev[n]] = next[n];
+        }else{
+            first = next[n];
+        }
+        if(next[n] >= 0){
+            prev[next[n]] = prev[n];
+        }
+    }
+
+    //Relabel all nodes evenly, in list order.
+    void relabel(){
+        stats_relabels++;
+        int64_t l = 0;
+        for(int n = first; n >= 0; n = next[n]){
+            label[n] = l;
+            l += label_spacing;
+        }
+    }
+
+    //Recompute the order from scratch, by depth first search; edges that close a cycle in the search are made pending.
+    void rebuild(){
+        int n = g.nodes();
+        label.resize(n);
+        next.resize(n);
+        prev.resize(n);
+        mark.clear();
+        mark.resize(n, 0);
+        parent_edge.resize(n);
+        edge_state.clear();
+        edge_state.resize(g.edges(), ABSENT);
+        queued.clear();
+        queued.resize(g.edges());
+        edge_in_witness.clear();
+        edge_in_witness.resize(g.edges());
+        witness.clear();
+        witness_edge = -1;
+        pending.clear();
+
+        //nodes are placed at the front of the list as they finish, so that the list is in reverse post-order
+        first = -1;
+        //stack of (node, next incident edge to explore)
+        std::vector<std::pair<int, int>>& stack = dfs_stack;
+        for(int root = 0; root < n; root++){
+            if(mark[root])
+                continue;
+            mark[root] = FORWARD;
+            parent_edge[root] = -1;
+            stack.push_back({root, 0});
+            while(stack.size()){
+                int u = stack.back().first;
+                int i = stack.back().second;
+                if(i < g.nIncident(u)){
+                    stack.back().second++;
+                    int edgeID = g.incident(u, i).id;
+                    if(!g.edgeEnabled(edgeID))
+                        continue;
+                    int w = g.incident(u, i).node;
+                    if(mark[w] == FORWARD){
+                        //w is on the stack, so this edge closes a cycle
+                        edge_state[edgeID] = PENDING;
+                        pending.push_back(edgeID);
+                        if(witness_edge < 0){
+                            witness.push_back(edgeID);
+                            for(int x = u; x != w; x = g.getEdge(parent_edge[x]).from){
+                                witness.push_back(parent_edge[x]);
+                            }
+                            setWitness(edgeID);
+                        }
+                    }else{
+                        edge_state[edgeID] = ORDERED;
+                        if(!mark[w]){
+                            mark[w] = FORWARD;
+                            parent_edge[w] = edgeID;
+                            stack.push_back({w, 0});
+                        }
+                    }
+                }else{
+                    stack.pop_back();
+                    mark[u] = BACKWARD;
+                    prev[u] = -1;
+                    next[u] = first;
+                    if(first >= 0)
+                        prev[first] = u;
+                    first = u;
+                }
+            }
+        }
+        for(int i = 0; i < n; i++){
+            mark[i] = 0;
+        }
+        relabel();
+        dbg_check_order();
+    }
+
+    std::vector<std::pair<int, int>> dfs_stack;
+
+    void visit(int n, int direction, int parent, std::vector<int>& heap){
+        mark[n] = direction;
+        parent_edge[n] = parent;
+        touched.push_back(n);
+        heap.push_back(n);
+        if(direction == FORWARD){
+            std::push_heap(heap.begin(), heap.end(), LabelGreater(label));
+        }else{
+            std::push_heap(heap.begin(), heap.end(), LabelLess(label));
+        }
+    }
+
+    //Record the cycle formed by edgeID (from u to v), the forward search path from v to 'forward_end',
+    //the edge 'meet' from forward_end to backward_start, and the backward search path from backward_start to u.
+    void recordCycle(int edgeID, int forward_end, int meet, int backward_start){
+        assert(witness.size() == 0);
+        witness.push_back(edgeID);
+        for(int x = forward_end; parent_edge[x] >= 0; x = g.getEdge(parent_edge[x]).from){
+            witness.push_back(parent_edge[x]);
+        }
+        witness.push_back(meet);
+        for(int x = backward_start; parent_edge[x] >= 0; x = g.getEdge(parent_edge[x]).to){
+            witness.push_back(parent_edge[x]);
+        }
+        setWitness(edgeID);
+    }
+
+    //Try to add the enabled edgeID to the order, returning false (and recording a witness cycle) if it closes a cycle.
+    bool insertEdge(int edgeID){
+        int u = g.getEdge(edgeID).from;
+        int v = g.getEdge(edgeID).to;
+        if(u == v){
+            witness.push_back(edgeID);
+            setWitness(edgeID);
+            return false;
+        }
+        if(label[u] < label[v]){
+            return true;
+        }
+        stats_searches++;
+        LabelGreater forward_lt(label);
+        LabelLess backward_lt(label);
+
+        visit(v, FORWARD, -1, forward_heap);
+        visit(u, BACKWARD, -1, backward_heap);
+        bool found_cycle = false;
+        //Each step settles the lowest unsettled node reachable from v, and the highest unsettled node that reaches u.
+        //If the former comes after the latter, then no path from v to u remains to be found.
+        while(!found_cycle && forward_heap.size() && backward_heap.size()){
+            int f = forward_heap[0];
+            int b = backward_heap[0];
+            if(label[f] > label[b]){
+                break;
+            }
+            std::pop_heap(forward_heap.begin(), forward_heap.end(), forward_lt);
+            forward_heap.pop_back();
+            mark[f] |= POPPED;
+            forward_visited.push_back(f);
+            for(auto& edge:g.incidentEdges(f)){
+                if(edge_state[edge.id] != ORDERED)
+                    continue;
+                int w = edge.node;
+                if(mark[w] & BACKWARD){
+                    recordCycle(edgeID, f, edge.id, w);
+                    found_cycle = true;
+                    break;
+                }else if(!mark[w]){
+                    visit(w, FORWARD, edge.id, forward_heap);
+                }
+            }
+            if(found_cycle)
+                break;
+            std::pop_heap(backward_heap.begin(), backward_heap.end(), backward_lt);
+            backward_heap.pop_back();
+            mark[b] |= POPPED;
+            backward_visited.push_back(b);
+            for(auto& edge:g.incomingEdges(b)){
+                if(edge_state[edge.id] != ORDERED)
+                    continue;
+                int w = edge.node;
+                if(mark[w] & FORWARD){
+                    recordCycle(edgeID, w, edge.id, b);
+                    found_cycle = true;
+                    break;
+                }else if(!mark[w]){
+                    visit(w, BACKWARD, edge.id, backward_heap);
+                }
+            }
+        }
+        stats_search_nodes += touched.size();
+
+        if(!found_cycle){
+            reorder();
+        }
+
+        for(int n:touched){
+            mark[n] = 0;
+        }
+        touched.clear();
+        forward_heap.clear();
+        backward_heap.clear();
+        forward_visited.clear();
+        backward_visited.clear();
+        return !found_cycle;
+    }
+
+    //Move the settled nodes of a successful search into the order, with the nodes that reach u (in their existing
+    //order) immediately followed by the nodes reachable from v (in their existing order).
+    //Every unsettled node reached by the forward search comes after the last settled forward node and after every
+    //unsettled node of the backward search (and vice versa), so the moved nodes are placed directly after the last
+    //unmoved node that precedes both of these.
+    void reorder(){
+        assert(forward_visited.size());
+        assert(backward_visited.size());
+        int last_forward = forward_visited.back();
+        int anchor;
+        if(backward_heap.size() && label[backward_heap[0]] > label[last_forward]){
+            anchor = backward_heap[0];
+        }else{
+            anchor = prev[last_forward];
+            while(anchor >= 0 && (mark[anchor] & POPPED)){
+                anchor = prev[anchor];
+            }
+        }
+        for(int n:forward_visited){
+            unlink(n);
+        }
+        for(int n:backward_visited){
+            unlink(n);
+        }
+        int after = anchor >= 0 ? next[anchor] : first;
+        int64_t k = forward_visited.size() + backward_visited.size();
+        int64_t lo;
+        int64_t hi;
+        if(anchor >= 0){
+            lo = label[anchor];
+            hi = after >= 0 ? label[after] : lo + (k + 1) * label_spacing;
+        }else if(after >= 0){
+            hi = label[after];
+            lo = hi - (k + 1) * label_spacing;
+        }else{
+            //every node is being moved
+            lo = 0;
+            hi = (k + 1) * label_spacing;
+        }
+        int64_t step = (hi - lo) / (k + 1);
+
+        //the backward search settled nodes in decreasing order
+        int p = anchor;
+        int64_t l = lo;
+        for(int i = backward_visited.size() - 1; i >= 0; i--){
+            l += step;
+            link(backward_visited[i], p, l);
+            p = backward_visited[i];
+        }
+        for(int n:forward_visited){
+            l += step;
+            link(n, p, l);
+            p = n;
+        }
+        if(step < 1){
+            relabel();
+        }
+    }
+
+    //Insert n into the list after p (or at the front, if p is -1)
+    void link(int n, int p, int64_t l){
+        label[n] = l;
+        prev[n] = p;
+        if(p >= 0){
+            next[n] = next[p];
+            next[p] = n;
+        }else{
+            next[n] = first;
+            first = n;
+        }
+        if(next[n] >= 0){
+            prev[next[n]] = n;
+        }
+    }
+
+    void removeEdge(int edgeID){
+        edge_state[edgeID] = ABSENT;
+        if(edge_in_witness[edgeID]){
+            clearWitness();
+        }
+    }
+
+    //Try to add the pending edges to the order again, stopping at the first one that still closes a cycle.
+    void retryPending(){
+        int j = 0;
+        for(int i = 0; i < pending.size(); i++){
+            int edgeID = pending[i];
+            if(edge_state[edgeID] != PENDING)
+                continue;
+            if(witness_edge < 0 && insertEdge(edgeID)){
+                edge_state[edgeID] = ORDERED;
+            }else{
+                pending[j++] = edgeID;
+            }
+        }
+        pending.resize(j);
+    }
+
+    bool tooLarge(int batch){
+        return batch > 16 && batch > rebuild_fraction * g.edges();
+    }
+
+    void dbg_check_order(){
+#ifdef DEBUG_DGL
+        int count = 0;
+        for(int n = first; n >= 0; n = next[n]){
+            count++;
+            if(next[n] >= 0){
+                assert(prev[next[n]] == n);
+                assert(label[n] < label[next[n]]);
+            }
+        }
+        assert(count == g.nodes());
+        for(int edgeID = 0; edgeID < g.edges(); edgeID++){
+            assert((edge_state[edgeID] != ABSENT) == g.edgeEnabled(edgeID));
+            if(edge_state[edgeID] == ORDERED){
+                assert(label[g.getEdge(edgeID).from] < label[g.getEdge(edgeID).to]);
+            }
+        }
+        for(int edgeID:witness){
+            assert(g.edgeEnabled(edgeID));
+        }
+        if(witness_edge < 0){
+            for(int edgeID:pending){
+                assert(edge_state[edgeID] != PENDING);
+            }
+        }
+#endif
+    }
+
+public:
+    void update() override{
+        if(last_modification > 0 && g.getCurrentHistory() == last_modification){
+            stats_skipped_updates++;
+            return;
+        }
+        cycle_computed = false;
+        if(last_modification <= 0 || g.nHistoryClears() != last_history_clear || history_qhead < g.historyStart()
+           || g.changed()){
+            stats_full_updates++;
+            stats_history_clears++;
+            rebuild();
+        }else{
+            additions.clear();
+            for(int i = history_qhead; i < g.historySize(); i++){
+                int edgeID = g.getChange(i).id;
+                if(g.edgeEnabled(edgeID)){
+                    if(edge_state[edgeID] == ABSENT && !queued[edgeID]){
+                        queued[edgeID] = true;
+                        additions.push_back(edgeID);
+                    }
+                }else if(edge_state[edgeID] != ABSENT){
+                    removeEdge(edgeID);
+                }
+            }
+            for(int edgeID:additions){
+                queued[edgeID] = false;
+            }
+            if(tooLarge(additions.size()) || (witness_edge < 0 && tooLarge(pending.size()))){
+                stats_full_updates++;
+                rebuild();
+            }else{
+                stats_fast_updates++;
+                for(int edgeID:additions){
+                    if(witness_edge < 0 && insertEdge(edgeID)){
+                        edge_state[edgeID] = ORDERED;
+                    }else{
+                        //while a cycle is known, new edges are left for later
+                        edge_state[edgeID] = PENDING;
+                        pending.push_back(edgeID);
+                    }
+                }
+                if(witness_edge < 0){
+                    retryPending();
+                }
+            }
+            dbg_check_order();
+        }
+
+        last_modification = g.getCurrentHistory();
+        history_qhead = g.historySize();
+        g.updateAlgorithmHistory(this, alg_id, history_qhead);
+        last_history_clear = g.nHistoryClears();
+    }
+
+    void updateHistory() override{
+        update();
+    }
+
+    bool hasDirectedCycle() override{
+        update();
+        return witness_edge >= 0;
+    }
+
+    //get a shortest directed cycle through the witness edge (the graph must be cyclic)
+    std::vector<int>& getDirectedCycle() override{
+        update();
+        if(!cycle_computed){
+            cycle_computed = true;
+            cycle.clear();
+            if(witness_edge >= 0){
+                shortestCycle();
+            }
+        }
+        return cycle;
+    }
+
+private:
+
+    //Breadth first search for a shortest path from the head of the witness edge back to its tail.
+    void shortestCycle(){
+        int u = g.getEdge(witness_edge).from;
+        int v = g.getEdge(witness_edge).to;
+        cycle.push_back(witness_edge);
+        if(u == v){
+            return;
+        }
+        q.clear();
+        q.push_back(v);
+        mark[v] = FORWARD;
+        bool found = false;
+        for(int i = 0; i < q.size() && !found; i++){
+            int n = q[i];
+            for(auto& edge:g.incidentEdges(n)){
+                if(edge_state[edge.id] == ABSENT)
+                    continue;
+                int w = edge.node;
+                if(!mark[w]){
+                    mark[w] = FORWARD;
+                    parent_edge[w] = edge.id;
+                    q.push_back(w);
+                    if(w == u){
+                        found = true;
+                        break;
+                    }
+                }
+            }
+        }
+        for(int n:q){
+            mark[n] = 0;
+        }
+        if(found){
+            for(int x = u; x != v; x = g.getEdge(parent_edge[x]).from){
+                cycle.push_back(parent_edge[x]);
+            }
+        }else{
+            //unreachable: the witness itself is such a path
+            assert(false);
+            cycle = witness;
+        }
+    }
+
+public:
+
+    bool hasUndirectedCycle() override{
+        assert(false);
+        return false;//not implemented
+    }
+
+    std::vector<int>& getUndirectedCycle() override{
+        assert(false);
+        return ignore;
+    }
+};
+};
+
+#endif /* TWOWAY_TOPOLOGICAL_SORT_H_ */
@@ -358,10 +358,6 @@ public:
 
     void dbg_isGrossMin(int min, int v){
 #ifdef DEBUG_DGL_LINKCUT
-        static int iter = 0;
-        if (++iter == 22349) {
-            int a = 1;
-        }
         // dbg_print_forest();
         Weight minGrossCost = nodes[v].cost;
 
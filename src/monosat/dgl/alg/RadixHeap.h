@@ -0,0 +1,114 @@
+/**************************************************************************************************
+ The MIT License (MIT)
+
+ Copyright (c) 2014, Sam Bayless
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef DGL_RADIX_HEAP_H_
+#define DGL_RADIX_HEAP_H_
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace dgl {
+namespace alg {
+
+/**
+ * A monotone priority queue of (key, value) pairs with non-negative integer keys (Ahuja et al., 1990).
+ * Keys must never be smaller than the last key removed, which always holds for Dijkstra's algorithm with
+ * non-negative edge weights.
+ * Bucket i holds the keys that first differ from the last removed key at bit i-1, so each entry is moved
+ * at most 64 times over its lifetime, and insertion is O(1).
+ * There is no decrease-key; callers insert a value again with its smaller key, and skip stale entries on removal.
+ */
+class RadixHeap {
+    struct Entry {
+        uint64_t key;
+        int value;
+    };
+    static const int n_buckets = 65;
+    std::vector<Entry> buckets[n_buckets];
+    uint64_t last = 0;
+    int64_t n_entries = 0;
+
+    static inline int bucket(uint64_t key, uint64_t last){
+        return key == last ? 0 : 64 - __builtin_clzll(key ^ last);
+    }
+
+    //Moves the entries of the first non-empty bucket into lower buckets, so that bucket 0 holds the minimum key.
+    void pull(){
+        assert(n_entries > 0);
+        int i = 1;
+        while(buckets[i].empty())
+            i++;
+        uint64_t new_last = buckets[i][0].key;
+        for(const Entry& e:buckets[i]){
+            if(e.key < new_last)
+                new_last = e.key;
+        }
+        last = new_last;
+        for(const Entry& e:buckets[i]){
+            buckets[bucket(e.key, last)].push_back(e);
+        }
+        buckets[i].clear();
+    }
+
+public:
+
+    int64_t size() const{
+        return n_entries;
+    }
+
+    bool empty() const{
+        return n_entries == 0;
+    }
+
+    void clear(){
+        for(int i = 0; i < n_buckets; i++)
+            buckets[i].clear();
+        last = 0;
+        n_entries = 0;
+    }
+
+    void insert(uint64_t key, int value){
+        assert(key >= last);
+        buckets[bucket(key, last)].push_back({key, value});
+        n_entries++;
+    }
+
+    uint64_t peekMinKey(){
+        if(buckets[0].empty())
+            pull();
+        return last;
+    }
+
+    //Removes an entry with the minimum key, and returns its value.
+    int removeMin(){
+        if(buckets[0].empty())
+            pull();
+        int value = buckets[0].back().value;
+        buckets[0].pop_back();
+        n_entries--;
+        return value;
+    }
+};
+
+}
+}
+#endif /* DGL_RADIX_HEAP_H_ */
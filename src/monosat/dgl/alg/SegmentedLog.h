@@ -0,0 +1,160 @@
+/**************************************************************************************************
+ The MIT License (MIT)
+
+ Copyright (c) 2014, Sam Bayless
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef DGL_SEGMENTED_LOG_H_
+#define DGL_SEGMENTED_LOG_H_
+
+#include <cassert>
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+namespace dgl {
+namespace alg {
+
+/**
+ * An append-only log, stored in fixed size segments, that can also be truncated at either end.
+ * Elements are addressed by their index from the front of the log; popFront() discards elements from
+ * the front, and returns each segment it empties to a free list, so that a log that is repeatedly
+ * appended to and trimmed from the front reuses a bounded set of segments (like a ring buffer),
+ * without ever moving the elements that remain.
+ */
+template<typename T, int SegmentBits = 10>
+class SegmentedLog {
+    static const size_t segment_size = ((size_t) 1) << SegmentBits;
+    static const size_t segment_mask = segment_size - 1;
+
+    std::deque<std::vector<T>*> segments;
+    std::vector<std::vector<T>*> free_segments;
+    //offset of the first element within the first segment
+    size_t head = 0;
+    size_t n_elements = 0;
+
+    std::vector<T>* newSegment(){
+        std::vector<T>* s;
+        if(free_segments.size()){
+            s = free_segments.back();
+            free_segments.pop_back();
+        }else{
+            s = new std::vector<T>();
+            s->reserve(segment_size);
+        }
+        assert(s->empty());
+        return s;
+    }
+
+    void releaseSegment(std::vector<T>* s){
+        s->clear();
+        free_segments.push_back(s);
+    }
+
+public:
+    SegmentedLog(){
+    }
+
+    SegmentedLog(const SegmentedLog& other) = delete;
+    SegmentedLog& operator=(const SegmentedLog& other) = delete;
+
+    ~SegmentedLog(){
+        for(std::vector<T>* s:segments)
+            delete s;
+        for(std::vector<T>* s:free_segments)
+            delete s;
+    }
+
+    size_t size() const{
+        return n_elements;
+    }
+
+    bool empty() const{
+        return n_elements == 0;
+    }
+
+    //The number of segments currently allocated, including free ones.
+    size_t allocatedSegments() const{
+        return segments.size() + free_segments.size();
+    }
+
+    T& operator[](size_t i){
+        assert(i < n_elements);
+        size_t p = head + i;
+        return (*segments[p >> SegmentBits])[p & segment_mask];
+    }
+
+    const T& operator[](size_t i) const{
+        assert(i < n_elements);
+        size_t p = head + i;
+        return (*segments[p >> SegmentBits])[p & segment_mask];
+    }
+
+    T& back(){
+        assert(n_elements > 0);
+        return segments.back()->back();
+    }
+
+    void push_back(const T& value){
+        if(segments.empty() || segments.back()->size() == segment_size){
+            segments.push_back(newSegment());
+        }
+        segments.back()->push_back(value);
+        n_elements++;
+    }
+
+    void pop_back(){
+        assert(n_elements > 0);
+        segments.back()->pop_back();
+        n_elements--;
+        if(n_elements == 0){
+            clear();
+        }else if(segments.back()->empty()){
+            releaseSegment(segments.back());
+            segments.pop_back();
+        }
+    }
+
+    //Discard the first n elements of the log.
+    void popFront(size_t n){
+        assert(n <= n_elements);
+        if(n == n_elements){
+            clear();
+            return;
+        }
+        n_elements -= n;
+        head += n;
+        while(head >= segment_size){
+            releaseSegment(segments.front());
+            segments.pop_front();
+            head -= segment_size;
+        }
+    }
+
+    void clear(){
+        for(std::vector<T>* s:segments)
+            releaseSegment(s);
+        segments.clear();
+        head = 0;
+        n_elements = 0;
+    }
+};
+
+};
+};
+#endif /* DGL_SEGMENTED_LOG_H_ */
@@ -0,0 +1,125 @@
+/**************************************************************************************************
+ The MIT License (MIT)
+
+ Copyright (c) 2014, Sam Bayless
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef UNDOABLE_DISJOINT_SETS_H
+#define UNDOABLE_DISJOINT_SETS_H
+
+#include <vector>
+#include <cassert>
+#include <utility>
+
+/**
+ * A disjoint set (union-find) data structure whose unions can be undone, in the reverse of the order they were made.
+ * Sets are merged by rank, and no path compression is performed, so that each union changes only a single
+ * parent pointer (and at most one rank); FindSet is O(log n).
+ *
+ * Checkpoint() returns a position in the undo log, and Rollback(position) undoes every union made since then.
+ */
+class UndoableDisjointSets {
+    struct Node {
+        int rank;
+        int parent;
+    };
+
+    //each union that merged two sets, recorded as the root that was attached below the other
+    struct Union {
+        int child;
+        bool rank_increased;
+    };
+
+    std::vector<Node> nodes;
+    std::vector<Union> log;
+    int n_sets = 0;
+
+public:
+
+    UndoableDisjointSets(int count = 0){
+        AddElements(count);
+    }
+
+    void Reset(){
+        nodes.clear();
+        log.clear();
+        n_sets = 0;
+    }
+
+    void AddElements(int numToAdd){
+        for(int i = 0; i < numToAdd; i++){
+            nodes.push_back({0, (int) nodes.size()});
+        }
+        n_sets += numToAdd;
+    }
+
+    int NumElements() const{
+        return nodes.size();
+    }
+
+    int NumSets() const{
+        return n_sets;
+    }
+
+    int FindSet(int element) const{
+        assert(element >= 0 && element < nodes.size());
+        while(nodes[element].parent != element){
+            element = nodes[element].parent;
+        }
+        return element;
+    }
+
+    //Combine the sets that these two elements belong to into one, returning false if they were already in the same set.
+    bool UnionElements(int element1, int element2){
+        int a = FindSet(element1);
+        int b = FindSet(element2);
+        if(a == b)
+            return false;
+        if(nodes[a].rank < nodes[b].rank){
+            std::swap(a, b);
+        }
+        //attach b below a
+        bool rank_increased = nodes[a].rank == nodes[b].rank;
+        nodes[b].parent = a;
+        if(rank_increased)
+            nodes[a].rank++;
+        log.push_back({b, rank_increased});
+        n_sets--;
+        return true;
+    }
+
+    int Checkpoint() const{
+        return log.size();
+    }
+
+    //Undo all the unions made since the given checkpoint.
+    void Rollback(int checkpoint){
+        assert(checkpoint >= 0 && checkpoint <= log.size());
+        while(log.size() > checkpoint){
+            Union u = log.back();
+            log.pop_back();
+            int parent = nodes[u.child].parent;
+            if(u.rank_increased)
+                nodes[parent].rank--;
+            nodes[u.child].parent = u.child;
+            n_sets++;
+        }
+    }
+};
+
+#endif
@@ -414,8 +414,8 @@ public:
         if(string.size() == 0)
             return startState ==
                    finalState;//this isn't quite correct, because there may be emoves connecting start to final state...
-        static vec<int> curStates;
-        static vec<int> nextStates;
+        static thread_local vec<int> curStates;
+        static thread_local vec<int> nextStates;
         nextStates.clear();
         curStates.clear();
         curStates.push(startState);
@@ -493,8 +493,8 @@ public:
         if(string.size() == 0)
             return startState ==
                    finalState;//this isn't quite correct, because there may be emoves connecting start to final state...
-        static vec<int> curStates;
-        static vec<int> nextStates;
+        static thread_local vec<int> curStates;
+        static thread_local vec<int> nextStates;
         nextStates.clear();
         curStates.clear();
         curStates.push(finalState);
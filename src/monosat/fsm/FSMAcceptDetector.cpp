@@ -224,10 +224,6 @@ Lit FSMAcceptDetector::decide(int level){
 }
 
 bool FSMAcceptDetector::propagate(vec<Lit>& conflict){
-    static int iter = 0;
-    if(++iter == 17){
-        int a = 1;
-    }
 
     if(opt_fsm_symmetry_breaking){
         if(!checkSymmetryConstraints(conflict))
@@ -577,8 +573,6 @@ bool FSMAcceptDetector::checkSymmetryConstraintsPopCount(vec<Lit>& conflict){
 
 
 void FSMAcceptDetector::buildAcceptReason(int node, int str, vec<Lit>& conflict){
-    static int iter = 0;
-    ++iter;
 //find a path - ideally, the one that traverses the fewest unique transitions - from source to node, learn that one of the transitions on that path must be disabled.
 /*	g_under.draw(source);
 	vec<int> & string = strings[str];
@@ -587,7 +581,7 @@ void FSMAcceptDetector::buildAcceptReason(int node, int str, vec<Lit>& conflict)
 		printf("%d ",s);
 	}
 	printf("\"\n");*/
-    static vec<NFATransition> path;
+    static thread_local vec<NFATransition> path;
     path.clear();
     bool hasPath = underapprox_detector->getPath(str, node, path);
     assert(hasPath);
@@ -605,7 +599,7 @@ void FSMAcceptDetector::buildAcceptReason(int node, int str, vec<Lit>& conflict)
 
 void FSMAcceptDetector::buildNonAcceptReason(int node, int str, vec<Lit>& conflict){
 
-    static int iter = 0;
+    static thread_local int iter = 0;
 //optionally, remove all transitions from the graph that would not be traversed by this string operating on the level 0 overapprox graph.
 
     //This doesn't work:
@@ -616,8 +610,8 @@ void FSMAcceptDetector::buildNonAcceptReason(int node, int str, vec<Lit>& confli
     //graph must be unrolled to length of string.
 
     //instead of actually unrolling the graph, I am going to traverse it backwards, 'unrolling it' implicitly.
-    static vec<int> to_visit;
-    static vec<int> next_visit;
+    static thread_local vec<int> to_visit;
+    static thread_local vec<int> next_visit;
     vec<int>& string = strings[str];
     /*
     g_over.draw(source);
@@ -640,8 +634,8 @@ void FSMAcceptDetector::buildNonAcceptReason(int node, int str, vec<Lit>& confli
     to_visit.clear();
     next_visit.clear();
 
-    static vec<bool> cur_seen;
-    static vec<bool> next_seen;
+    static thread_local vec<bool> cur_seen;
+    static thread_local vec<bool> next_seen;
     cur_seen.clear();
     cur_seen.growTo(g_under.states());
 
@@ -26,6 +26,7 @@
 
 #include "monosat/mtl/Vec.h"
 #include "monosat/core/Config.h"
+#include "monosat/core/Profile.h"
 #include <cstdio>
 #include <iostream>
 
@@ -57,6 +58,7 @@ public:
     double stats_decide_time = 0;
     int64_t stats_under_clause_length = 0;
     int64_t stats_over_clause_length = 0;
+    PropagationProfile profile;//Propagation and reason calls made to this detector by the fsm theory
 
     int getID(){
         return detectorID;
@@ -94,10 +94,6 @@ void FSMGeneratesDetector::GenerateStatus::generates(int string, bool generates)
 
 
 bool FSMGeneratesDetector::propagate(vec<Lit>& conflict){
-    static int iter = 0;
-    if(++iter == 87){
-        int a = 1;
-    }
     changed.clear();
     bool skipped_positive = false;
     if(underapprox_detector && (!opt_detect_pure_theory_lits || unassigned_positives > 0)){
@@ -205,8 +201,6 @@ void FSMGeneratesDetector::buildReason(Lit p, vec<Lit>& reason, CRef marker){
 }
 
 void FSMGeneratesDetector::buildGeneratesReason(int str, vec<Lit>& conflict){
-    static int iter = 0;
-    ++iter;
 //find a path - ideally, the one that traverses the fewest unique transitions - from source to node, learn that one of the transitions on that path must be disabled.
 /*	g_under.draw(source);
 	vec<int> & string = strings[str];
@@ -215,7 +209,7 @@ void FSMGeneratesDetector::buildGeneratesReason(int str, vec<Lit>& conflict){
 		printf("%d ",s);
 	}
 	printf("\"\n");*/
-    static vec<NFATransition> path;
+    static thread_local vec<NFATransition> path;
     path.clear();
     bool hasPath = underapprox_detector->getPath(str, path);
     assert(hasPath);
@@ -316,17 +310,13 @@ FSMGeneratesDetector::unique_path_conflict(int s, int string, int str_pos, int e
 
 void FSMGeneratesDetector::buildNonGeneratesReason(int str, vec<Lit>& conflict){
 
-    static int iter = 0;
 
 
     vec<int>& string = strings[str];
     used_transitions.clear();
     used_transitions.growTo(g_over.nodes());
 
-    if(++iter == 10189){
-        int a = 1;
-    }
-    static vec<NFATransition> ignore;
+    static thread_local vec<NFATransition> ignore;
     ignore.clear();
     unique_path_conflict(source, str, 0, 0, ignore, conflict);
 
@@ -335,8 +325,8 @@ void FSMGeneratesDetector::buildNonGeneratesReason(int str, vec<Lit>& conflict){
 void FSMGeneratesDetector::printSolution(std::ostream& out){
 
 
-    static vec<NFATransition> ignore;
-    static vec<Lit> ignore_conf;
+    static thread_local vec<NFATransition> ignore;
+    static thread_local vec<Lit> ignore_conf;
     for(int str = 0; str < strings.size(); str++){
         ignore.clear();
         ignore_conf.clear();
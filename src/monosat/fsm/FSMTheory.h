@@ -190,6 +190,7 @@ public:
     double pathtime = 0;
     double propagationtime = 0;
     int64_t stats_propagations = 0;
+    int64_t stats_enqueued = 0;//Number of literals implied by this theory
     int64_t propagations = 0;
     int64_t stats_num_conflicts = 0;
     int64_t stats_decisions = 0;
@@ -233,6 +234,12 @@ public:
         return S;
     }
 
+    void getProfiles(std::vector<ProfilePart>& parts) override{
+        for(FSMDetector* d:detectors){
+            parts.push_back({std::string(d->getName()) + " " + std::to_string(d->getID()), &d->profile});
+        }
+    }
+
     void printStats(int detailLevel) override{
         printf("FSM %d stats:\n", getGraphID());
         if(stats_decisions > 0){
@@ -507,6 +514,7 @@ public:
 
         Lit sl = toSolver(l);
         if(S->enqueue(sl, reason)){
+            stats_enqueued++;
             enqueueTheory(l);
             return true;
         }else{
@@ -538,7 +546,6 @@ public:
     }
 
     void backtrackUntil(int level) override{
-        static int it = 0;
 
         bool changed = false;
         //need to remove and add edges in the two graphs accordingly.
@@ -602,7 +609,7 @@ public:
 
     Lit decideTheory(CRef& decision_reason) override{
         decision_reason = CRef_Undef;
-        if(!opt_decide_theories)
+        if(!S->decide_theories)
             return lit_Undef;
         double start = rtime(1);
 
@@ -689,7 +696,10 @@ public:
         backtrackUntil(p);
 
         assert(d < detectors.size());
-        detectors[d]->buildReason(p, reason, marker);
+        {
+            ProfileTimer timer(detectors[d]->profile, ProfileTimer::REASON);
+            detectors[d]->buildReason(p, reason, marker);
+        }
         toSolver(reason);
         double finish = rtime(1);
         stats_reason_time += finish - start;
@@ -733,7 +743,10 @@ public:
 
         int lev = level(v);
 
-        assert(decisionLevel() <= lev);
+        //With chronological backtracking (-chrono), lev may be lower than decisionLevel(), if the SAT solver assigned l
+        //out of order; l is then recorded at the current level, and re-enqueued by the SAT solver if this theory
+        //backtracks past it.
+        assert(opt_chrono >= 0 || decisionLevel() <= lev);
 
         while(lev > trail_lim.size()){
             newDecisionLevel();
@@ -816,10 +829,6 @@ public:
     }
 
     bool propagateTheory(vec<Lit>& conflict, bool force_propagation){
-        static int itp = 0;
-        if(++itp == 11673){
-            int a = 1;
-        }
         stats_propagations++;
 
         if(!requiresPropagation){
@@ -851,8 +860,16 @@ public:
 
         for(int d = 0; d < detectors.size(); d++){
             assert(conflict.size() == 0);
-            bool r = detectors[d]->propagate(conflict);
+            PropagationProfile& profile = detectors[d]->profile;
+            int64_t enqueued = stats_enqueued;
+            bool r;
+            {
+                ProfileTimer timer(profile, ProfileTimer::CALL);
+                r = detectors[d]->propagate(conflict);
+            }
+            profile.propagations += stats_enqueued - enqueued;
             if(!r){
+                profile.conflicts++;
                 stats_num_conflicts++;
                 toSolver(conflict);
                 propagationtime += rtime(1) - startproptime;
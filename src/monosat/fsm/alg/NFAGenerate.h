@@ -143,7 +143,7 @@ public:
             stats_skipped_updates++;
             return;
         }
-        static int iteration = 0;
+        static thread_local int iteration = 0;
         int local_it = ++iteration;
         stats_full_updates++;
 
@@ -197,7 +197,7 @@ public:
 
     //inefficient!
     bool generatesString(int string){
-        static vec<NFATransition> ignore;
+        static thread_local vec<NFATransition> ignore;
         ignore.clear();
         return getPath(string, ignore);
     }
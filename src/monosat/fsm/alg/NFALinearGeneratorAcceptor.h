@@ -1049,7 +1049,7 @@ public:
             stats_skipped_updates++;
             return;
         }
-        static int iteration = 0;
+        static thread_local int iteration = 0;
         int local_it = ++iteration;
         stats_full_updates++;
 
@@ -21,7 +21,9 @@
 
 #include "GraphTheory.h"
 #include "monosat/dgl/FloydWarshall.h"
+#include "monosat/dgl/BlockedFloydWarshall.h"
 #include "monosat/dgl/DijkstraAllPairs.h"
+#include "monosat/dgl/TransitiveClosure.h"
 
 using namespace Monosat;
 
@@ -42,6 +44,19 @@ AllPairsDetector<Weight, Graph>::AllPairsDetector(int _detectorID, GraphTheorySo
                 _antig,
                 *(negativeReachStatus), -1);
         underapprox_path_detector = underapprox_reach_detector;
+    }else if(allpairsalg == AllPairsAlg::ALG_BLOCKED_FLOYDWARSHALL){
+        underapprox_reach_detector = new BlockedFloydWarshall<Weight, Graph, AllPairsDetector<Weight, Graph>::ReachStatus>(
+                _g, *(positiveReachStatus), opt_allpairs_threads);
+        overapprox_reach_detector = new BlockedFloydWarshall<Weight, Graph, AllPairsDetector<Weight, Graph>::ReachStatus>(
+                _antig, *(negativeReachStatus), opt_allpairs_threads);
+        underapprox_path_detector = underapprox_reach_detector;
+    }else if(allpairsalg == AllPairsAlg::ALG_TRANSITIVE_CLOSURE){
+        underapprox_reach_detector = new TransitiveClosure<Weight, Graph, AllPairsDetector<Weight, Graph>::ReachStatus>(
+                _g, *(positiveReachStatus), 1);
+        overapprox_reach_detector = new TransitiveClosure<Weight, Graph, AllPairsDetector<Weight, Graph>::ReachStatus>(
+                _antig, *(negativeReachStatus), -1);
+        underapprox_path_detector = underapprox_reach_detector;
+        reach_only = true;
     }/*else if (allpairsalg==ALG_THORUP_ALLPAIRS){
 	 positive_reach_detector = new DynamicConnectivity<AllPairsDetector<Weight,Graph>::ReachStatus>(_g,*(positiveReachStatus),1);
 	 negative_reach_detector = new DynamicConnectivity<AllPairsDetector<Weight,Graph>::ReachStatus>(_antig,*(negativeReachStatus),-1);
@@ -86,6 +101,28 @@ void AllPairsDetector<Weight, Graph>::addLit(int from, int to, Var outer_reach_v
     if(within_steps > outer->nNodes())
         within_steps = outer->nNodes();
 
+    if(reach_only && within_steps < outer->nNodes()){
+        //the transitive closure doesn't track distances, so fall back to Dijkstra for bounded reachability
+        reach_only = false;
+        if(underapprox_reach_detector->numUpdates() == 0 && overapprox_reach_detector->numUpdates() == 0){
+            delete underapprox_reach_detector;
+            delete overapprox_reach_detector;
+        }else{
+            //these have already reported their history positions to the graphs, and must outlive them
+            retired_detectors.push_back(underapprox_reach_detector);
+            retired_detectors.push_back(overapprox_reach_detector);
+        }
+        underapprox_reach_detector = new DijkstraAllPairs<Weight, Graph, AllPairsDetector<Weight, Graph>::ReachStatus>(
+                g_under, *(positiveReachStatus), 1);
+        overapprox_reach_detector = new DijkstraAllPairs<Weight, Graph, AllPairsDetector<Weight, Graph>::ReachStatus>(
+                g_over, *(negativeReachStatus), -1);
+        underapprox_path_detector = underapprox_reach_detector;
+        for(int s:sources){
+            underapprox_reach_detector->addSource(s);
+            overapprox_reach_detector->addSource(s);
+        }
+    }
+
     dist_lits.growTo(outer->nNodes());
 
     dist_lits[from].growTo(outer->nNodes());
@@ -183,10 +220,6 @@ template<typename Weight, typename Graph>
 void AllPairsDetector<Weight, Graph>::buildReachReason(int source, int to, vec<Lit>& conflict){
     //drawFull();
     AllPairs& d = *underapprox_path_detector;
-    static int iter = 0;
-    if(++iter == 3){
-        int a = 1;
-    }
 
     double starttime = rtime(2);
     d.update();
@@ -204,20 +237,23 @@ void AllPairsDetector<Weight, Graph>::buildReachReason(int source, int to, vec<L
     d.getPath(source, to, tmp_path);
     //if(opt_learn_reaches ==0 || opt_learn_reaches==2)
     {
-        int u = to;
-
-        //while(( p = d.previous(u)) != -1){
-        for(int i = tmp_path.size() - 2; i >= 0; i--){
-            int edge_id = tmp_path[i];
-            int p = g_over.getEdge(edge_id).from;
+        //the path is a sequence of nodes; learn an enabled edge between each consecutive pair
+        for(int i = tmp_path.size() - 1; i > 0; i--){
+            int u = tmp_path[i];
+            int p = tmp_path[i - 1];
+            int edge_id = -1;
+            for(int j = 0; j < g_under.nIncident(p); j++){
+                if(g_under.incident(p, j).node == u && g_under.edgeEnabled(g_under.incident(p, j).id)){
+                    edge_id = g_under.incident(p, j).id;
+                    break;
+                }
+            }
+            assert(edge_id >= 0);
 
             Var e = outer->getEdgeVar(edge_id);
-            lbool val = outer->value(e);
             assert(outer->value(e) == l_True);
 
             conflict.push(mkLit(e, true));
-            u = p;
-
         }
     }
     outer->num_learnt_paths++;
@@ -229,8 +265,6 @@ void AllPairsDetector<Weight, Graph>::buildReachReason(int source, int to, vec<L
 
 template<typename Weight, typename Graph>
 void AllPairsDetector<Weight, Graph>::buildNonReachReason(int source, int node, vec<Lit>& conflict){
-    static int it = 0;
-    ++it;
     int u = node;
     //drawFull( non_reach_detectors[detector]->getSource(),u);
     //assert(outer->dbg_distance( source,u));
@@ -526,7 +560,7 @@ Lit AllPairsDetector<Weight, Graph>::decide(CRef& decision_reason){
                            min_dist);//else we would already be in conflict before this decision was attempted!
                     if(underapprox_reach_detector->distance(s, j) > min_dist){
                         //then lets try to connect this
-                        static vec<bool> print_path;
+                        static thread_local vec<bool> print_path;
 
                         assert(overapprox_reach_detector->connected(s,
                                                                     j));        //Else, we would already be in conflict
@@ -60,6 +60,9 @@ public:
     AllPairs* underapprox_reach_detector = nullptr;
     AllPairs* overapprox_reach_detector = nullptr;
     AllPairs* underapprox_path_detector = nullptr;
+    //set if the detectors only track reachability, and not distances
+    bool reach_only = false;
+    std::vector<AllPairs*> retired_detectors;
 
     //vec<Lit>  reach_lits;
     Var first_reach_var;
@@ -173,7 +176,7 @@ public:
     AllPairsDetector(int _detectorID, GraphTheorySolver<Weight>* _outer, Graph& _g, Graph& _antig, Graph& cutGraph,
                      double seed = 1); //:Detector(_detectorID),outer(_outer),within(-1),source(_source),rnd_seed(seed),positive_reach_detector(NULL),negative_reach_detector(NULL),positive_path_detector(NULL),positiveReachStatus(NULL),negativeReachStatus(NULL){}
     ~AllPairsDetector() override{
-        if(underapprox_path_detector && underapprox_path_detector != overapprox_reach_detector){
+        if(underapprox_path_detector && underapprox_path_detector != underapprox_reach_detector){
             delete underapprox_path_detector;
         }
 
@@ -186,6 +189,9 @@ public:
             delete overapprox_reach_detector;
 
         }
+        for(AllPairs* d:retired_detectors){
+            delete d;
+        }
 
 #ifdef DEBUG_ALLPAIRS
         {
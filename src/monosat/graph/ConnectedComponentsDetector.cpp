@@ -219,8 +219,6 @@ void ConnectedComponentsDetector<Weight, Graph>::buildMinComponentsTooLowReason(
 template<typename Weight, typename Graph>
 void
 ConnectedComponentsDetector<Weight, Graph>::buildMinComponentsTooHighReason(int min_components, vec<Lit>& conflict){
-    static int it = 0;
-    ++it;
 
     //drawFull( non_reach_detectors[detector]->getSource(),u);
     //assert(outer->dbg_distance( source,u));
@@ -21,6 +21,7 @@
 
 #include "GraphTheory.h"
 #include "monosat/dgl/PKTopologicalSort.h"
+#include "monosat/dgl/TwoWayTopologicalSort.h"
 
 using namespace Monosat;
 
@@ -47,6 +48,12 @@ CycleDetector<Weight, Graph>::CycleDetector(int _detectorID, GraphTheorySolver<W
         underapprox_directed_cycle_detector = new PKToplogicalSort<Weight, Graph>(g_under, 1);
         overapprox_directed_cycle_detector = new PKToplogicalSort<Weight, Graph>(g_over, 1);
 
+        underapprox_undirected_cycle_detector = new DFSCycle<Weight, Graph, false, true>(g_under, false, 1);
+        overapprox_undirected_cycle_detector = new DFSCycle<Weight, Graph, false, true>(g_over, false, 1);
+    }else if(cyclealg == CycleAlg::ALG_TWOWAY_CYCLE){
+        underapprox_directed_cycle_detector = new TwoWayTopologicalSort<Weight, Graph>(g_under, 1);
+        overapprox_directed_cycle_detector = new TwoWayTopologicalSort<Weight, Graph>(g_over, 1);
+
         underapprox_undirected_cycle_detector = new DFSCycle<Weight, Graph, false, true>(g_under, false, 1);
         overapprox_undirected_cycle_detector = new DFSCycle<Weight, Graph, false, true>(g_over, false, 1);
     }
@@ -193,7 +200,6 @@ void CycleDetector<Weight, Graph>::buildReason(Lit p, vec<Lit>& reason, CRef mar
 
 template<typename Weight, typename Graph>
 bool CycleDetector<Weight, Graph>::propagate(vec<Lit>& conflict){
-    static int it = 0;
 
 
     double startdreachtime = rtime(2);
@@ -215,7 +221,7 @@ bool CycleDetector<Weight, Graph>::propagate(vec<Lit>& conflict){
                 //do nothing
             }else if(outer->value(l) == l_Undef){
                 //trail.push(Assignment(false,false,detectorID,0,var(l)));
-                outer->enqueue(l, no_directed_cycle_marker);
+                outer->enqueue(l, directed_cycle_marker);
             }else if(outer->value(l) == l_False){
                 conflict.push(l);
                 buildDirectedCycleReason(conflict);
@@ -230,7 +236,7 @@ bool CycleDetector<Weight, Graph>::propagate(vec<Lit>& conflict){
                 //do nothing
             }else if(outer->value(l) == l_Undef){
                 //trail.push(Assignment(false,true,detectorID,0,var(l)));
-                outer->enqueue(l, directed_cycle_marker);
+                outer->enqueue(l, no_directed_cycle_marker);
             }else if(outer->value(l) == l_False){
                 conflict.push(l);
                 buildNoDirectedCycleReason(conflict);
@@ -252,7 +258,7 @@ bool CycleDetector<Weight, Graph>::propagate(vec<Lit>& conflict){
                 //do nothing
             }else if(outer->value(l) == l_Undef){
                 //trail.push(Assignment(false,false,detectorID,0,var(l)));
-                outer->enqueue(l, no_undirected_cycle_marker);
+                outer->enqueue(l, undirected_cycle_marker);
             }else if(outer->value(l) == l_False){
                 conflict.push(l);
                 buildUndirectedCycleReason(conflict);
@@ -267,7 +273,7 @@ bool CycleDetector<Weight, Graph>::propagate(vec<Lit>& conflict){
                 //do nothing
             }else if(outer->value(l) == l_Undef){
                 //trail.push(Assignment(false,true,detectorID,0,var(l)));
-                outer->enqueue(l, undirected_cycle_marker);
+                outer->enqueue(l, no_undirected_cycle_marker);
             }else if(outer->value(l) == l_False){
                 conflict.push(l);
                 buildNoUndirectedCycleReason(conflict);
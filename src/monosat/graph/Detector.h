@@ -27,6 +27,7 @@
 #include "monosat/mtl/Vec.h"
 #include "monosat/core/Config.h"
 #include "monosat/core/Heuristic.h"
+#include "monosat/core/Profile.h"
 #include <string>
 #include <cstdio>
 #include <iostream>
@@ -62,6 +63,7 @@ public:
     int64_t n_stats_vsids_decisions = 0;
     int64_t stats_under_clause_length = 0;
     int64_t stats_over_clause_length = 0;
+    PropagationProfile profile;//Propagation and reason calls made to this detector by the graph theory
     Heuristic* default_heuristic = nullptr;
 
     int getID(){
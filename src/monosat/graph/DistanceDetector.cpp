@@ -29,6 +29,8 @@
 #include "monosat/dgl/KohliTorr.h"
 #include "monosat/dgl/EdmondsKarpDynamic.h"
 #include "monosat/dgl/Dinics.h"
+#include "monosat/dgl/DinitzDynamic.h"
+#include "monosat/dgl/PushRelabel.h"
 #include "monosat/dgl/DinicsLinkCut.h"
 #include "monosat/graph/DistanceDetector.h"
 #include "monosat/graph/GraphTheory.h"
@@ -175,25 +177,38 @@ DistanceDetector<Weight, Graph>::DistanceDetector(int _detectorID, GraphTheorySo
                     typename DistanceDetector<Weight, Graph>::ReachStatus>(from, g_under, *(positiveReachStatus), 0);
         }
         //new UnweightedBFS<Weight,Distance<int>::NullStatus>(from, g_under, Distance<int>::nullStatus, 0);
+    }else if(distalg == DistAlg::ALG_BIDIRECTIONAL){
+        typedef BidirectionalDijkstra<Weight, Graph, typename DistanceDetector<Weight, Graph>::ReachStatus, true> BidirectionalDijkstraT;
+        if(opt_dist_landmarks > 0){
+            landmarks = new ALTLandmarks<Weight, Graph, true>(g_over, opt_dist_landmarks);
+        }
+        if(!opt_encode_dist_underapprox_as_sat){
+            underapprox_unweighted_distance_detector = new BidirectionalDijkstraT(from, g_under, *positiveReachStatus, 0,
+                                                                                  landmarks);
+        }
+        overapprox_unweighted_distance_detector = new BidirectionalDijkstraT(from, g_over, *negativeReachStatus, 0,
+                                                                             landmarks);
+        if(underapprox_unweighted_distance_detector)
+            underapprox_path_detector = underapprox_unweighted_distance_detector;
+        else
+            underapprox_path_detector = new BidirectionalDijkstraT(from, g_under, *positiveReachStatus, 0, landmarks);
     }else{
+        typedef UnweightedDijkstra<Weight, Graph, typename DistanceDetector<Weight, Graph>::ReachStatus> UnweightedDijkstraT;
         if(!opt_encode_dist_underapprox_as_sat){
-            underapprox_unweighted_distance_detector =
-                    new UnweightedDijkstra<Weight, Graph, typename DistanceDetector<Weight, Graph>::ReachStatus>(from,
-                                                                                                                 g_under,
-                                                                                                                 *positiveReachStatus,
-                                                                                                                 0);
+            auto* under = new UnweightedDijkstraT(from, g_under, *positiveReachStatus, 0);
+            under->opt_radix_heap = opt_radix_heap;
+            underapprox_unweighted_distance_detector = under;
         }
-        overapprox_unweighted_distance_detector =
-                new UnweightedDijkstra<Weight, Graph, typename DistanceDetector<Weight, Graph>::ReachStatus>(from,
-                                                                                                             g_over,
-                                                                                                             *negativeReachStatus,
-                                                                                                             0);
+        auto* over = new UnweightedDijkstraT(from, g_over, *negativeReachStatus, 0);
+        over->opt_radix_heap = opt_radix_heap;
+        overapprox_unweighted_distance_detector = over;
 
         if(underapprox_unweighted_distance_detector)
             underapprox_path_detector = underapprox_unweighted_distance_detector;
         else{
-            underapprox_path_detector = new UnweightedDijkstra<Weight, Graph, typename DistanceDetector<Weight, Graph>::ReachStatus>(
-                    from, g_under, *positiveReachStatus, 0);
+            auto* under_path = new UnweightedDijkstraT(from, g_under, *positiveReachStatus, 0);
+            under_path->opt_radix_heap = opt_radix_heap;
+            underapprox_path_detector = under_path;
         }
         //reach_detectors.last()->positive_dist_detector = new Dijkstra(from,g);
     }
@@ -210,6 +225,10 @@ DistanceDetector<Weight, Graph>::DistanceDetector(int _detectorID, GraphTheorySo
             //link-cut tree currently only supports ints
             conflict_flow = new Dinitz<Weight>(cutGraph, source, 0);
 
+        }else if(mincutalg == MinCutAlg::ALG_DINITZ_DYN){
+            conflict_flow = new DinitzDynamic<Weight>(cutGraph, source, 0);
+        }else if(mincutalg == MinCutAlg::ALG_PUSH_RELABEL){
+            conflict_flow = new PushRelabel<Weight>(cutGraph, source, 0);
         }else if(mincutalg == MinCutAlg::ALG_KOHLI_TORR){
             if(opt_use_kt_for_conflicts){
                 conflict_flow = new KohliTorr<Weight>(cutGraph, source, 0,
@@ -526,7 +545,12 @@ DistanceDetector<Weight, Graph>::addUnweightedShortestPathLit(int from, int to,
         }
         reach_lit_map[reach_var - first_reach_var] = {to, within_steps};
     }
-
+    if(underapprox_unweighted_distance_detector)
+        underapprox_unweighted_distance_detector->addDestination(to);
+    if(overapprox_unweighted_distance_detector)
+        overapprox_unweighted_distance_detector->addDestination(to);
+    if(underapprox_path_detector && underapprox_path_detector != underapprox_unweighted_distance_detector)
+        underapprox_path_detector->addDestination(to);
 }
 
 template<typename Weight, typename Graph>
@@ -644,13 +668,9 @@ void DistanceDetector<Weight, Graph>::buildUnweightedDistanceLEQReason(int node,
 
 template<typename Weight, typename Graph>
 void DistanceDetector<Weight, Graph>::buildUnweightedDistanceGTReason(int node, int within_steps, vec<Lit>& conflict){
-    static int it = 0;
     stats_unweighted_gt_reasons++;
     stats_over_conflicts++;
     double starttime = rtime(2);
-    if(++it == 14){
-        int a = 1;
-    }
 
     int u = node;
     bool reaches = overapprox_unweighted_distance_detector->connected(node);
@@ -850,12 +870,12 @@ bool DistanceDetector<Weight, Graph>::propagate(vec<Lit>& conflict){
     if(!underapprox_unweighted_distance_detector)
         return true;
 
-    static int iter = 0;
-    if(++iter == 1722){ //18303
-        int a = 1;
-    }
 
     //printf("iter %d\n",iter);
+    if(landmarks && outer->decisionLevel() == 0){
+        //edges are only disabled above level 0, so landmark distances computed now remain valid lower bounds
+        landmarks->update();
+    }
     bool skipped_positive = false;
     //getChanged().clear();
     if(!opt_detect_pure_theory_lits || unassigned_positives > 0){
@@ -29,6 +29,7 @@
 #include "monosat/dgl/Reach.h"
 #include "monosat/dgl/Distance.h"
 #include "monosat/dgl/Dijkstra.h"
+#include "monosat/dgl/BidirectionalDijkstra.h"
 #include "monosat/dgl/BFS.h"
 #include "monosat/dgl/MaxFlow.h"
 #include "monosat/core/SolverTypes.h"
@@ -66,6 +67,8 @@ public:
 
 
     Reach* underapprox_path_detector = nullptr;
+    //landmark lower bounds for -dist=bidirectional, computed on g_over at decision level 0
+    ALTLandmarks<Weight, Graph, true>* landmarks = nullptr;
 
     //vec<Lit>  reach_lits;
     Var first_reach_var = var_Undef;
@@ -304,6 +307,9 @@ public:
 
         if(conflict_flow)
             delete conflict_flow;
+
+        if(landmarks)
+            delete landmarks;
     }
 
     std::string getName() override{
@@ -58,7 +58,7 @@ public:
     }
 
     Lit decideTheory(CRef& decision_reason) override{
-        static int iter = 0;
+        static thread_local int iter = 0;
         if(++iter == 67749){
             int a = 1;
         };
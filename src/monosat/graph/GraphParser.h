@@ -603,7 +603,7 @@ private:
         //distance_lt grachID u w var dist is a reach query: var is true if can u reach w in graph g, false otherwise
 
         ++in;
-        static vec<char> tmp;
+        static thread_local vec<char> tmp;
         int graphID = parseInt(in);
         int from = parseInt(in);
         int to = parseInt(in);
@@ -640,7 +640,7 @@ private:
         //distance_lt grachID u w var dist is a reach query: var is true if can u reach w in graph g, false otherwise
 
         ++in;
-        static vec<char> tmp;
+        static thread_local vec<char> tmp;
         int graphID = parseInt(in);
         int from = parseInt(in);
         int to = parseInt(in);
@@ -706,7 +706,7 @@ private:
         //distance_lt grachID u w var dist is a reach query: var is true if can u reach w in graph g, false otherwise
 
         ++in;
-        static vec<char> tmp;
+        static thread_local vec<char> tmp;
         int graphID = parseInt(in);
         int reachVar = parseInt(in) - 1;
 
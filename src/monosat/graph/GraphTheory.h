@@ -28,6 +28,7 @@
 #include "monosat/dgl/Reach.h"
 #include "monosat/dgl/Dijkstra.h"
 #include "monosat/dgl/BFS.h"
+#include "monosat/dgl/MultiSourceReach.h"
 
 #include "monosat/core/SolverTypes.h"
 #include "monosat/mtl/Map.h"
@@ -471,7 +472,7 @@ public:
 
     void dbg_check_trail(int lev){
 #ifdef DEBUG_GRAPH
-                                                                                                                                static vec<bool> seen;
+                                                                                                                                static thread_local vec<bool> seen;
 		seen.clear();
 		seen.growTo(vars.size());
 		if(lev>=0){
@@ -570,6 +571,9 @@ public:
     vec<ReachInfo> reach_info;
     vec<ReachInfo> backward_reach_info;
     vec<ReachInfo> connect_info;
+    //all sources of all-pairs reachability constraints share a single detector (per direction)
+    Detector* allpairs_detector = nullptr;
+    Detector* backward_allpairs_detector = nullptr;
 
 public:
     vec<Theory*> theories;
@@ -577,6 +581,11 @@ public:
     vec<Detector*> detectors;
     vec<ReachDetector<Weight>*> reach_detectors;
     vec<ReachDetector<Weight, DynamicBackGraph<Weight>>*> reach_back_detectors;
+    //Shared reachability engines for all forward (and backward) reach detectors, if reachalg is ALG_BFS_MULTI_SOURCE
+    MultiSourceReach<Weight>* under_reach_engine = nullptr;
+    MultiSourceReach<Weight>* over_reach_engine = nullptr;
+    MultiSourceReach<Weight, DynamicBackGraph<Weight>>* under_back_reach_engine = nullptr;
+    MultiSourceReach<Weight, DynamicBackGraph<Weight>>* over_back_reach_engine = nullptr;
     vec<DistanceDetector<Weight>*> distance_detectors;
     vec<DistanceDetector<Weight, DynamicBackGraph<Weight>>*> distance_back_detectors;
     vec<WeightedDistanceDetector<Weight>*> weighted_distance_detectors;
@@ -680,6 +689,7 @@ public:
     double propagationtime = 0;
     int64_t propagations = -1;
     int64_t stats_propagations = 0;
+    int64_t stats_enqueued = 0;//Number of literals implied by this theory
     int64_t stats_num_conflicts = 0;
     int64_t stats_num_skipped_edgeset_props = 0;
     int64_t stats_num_lazy_conflicts = 0;
@@ -777,6 +787,11 @@ public:
             bitwidth = -2;
             has_fixed_bitwidth = false;
         }
+        //The under/over approximations (and their weight views) always have identical nodes and edges, so
+        //they share one copy of the topology. The cutgraph has two edges per edge, so it keeps its own.
+        g_over.shareTopology(g_under);
+        g_under_weights_over.shareTopology(g_under);
+        g_over_weights_under.shareTopology(g_under);
         if(opt_record){
             std::string t = (const char*) opt_record_file;
             t += "/LOG_GRAPH_UNDER" + std::to_string(S->getTheories().size());
@@ -855,6 +870,12 @@ public:
     }
 
 
+    void getProfiles(std::vector<ProfilePart>& parts) override{
+        for(Detector* d:detectors){
+            parts.push_back({d->getName() + " " + std::to_string(d->getID()), &d->profile});
+        }
+    }
+
     void printStats(int detailLevel) override{
 
 
@@ -1318,6 +1339,7 @@ public:
 
         Lit sl = toSolver(l);
         if(S->enqueue(sl, reason)){
+            stats_enqueued++;
             enqueueTheory(l);//is this still needed?
             return true;
         }else{
@@ -1414,7 +1436,10 @@ public:
     };
 
     ~GraphTheorySolver() override{
-
+        delete under_reach_engine;
+        delete over_reach_engine;
+        delete under_back_reach_engine;
+        delete over_back_reach_engine;
     }
 
     void setNodeName(int node, const std::string& symbol){
@@ -1526,7 +1551,7 @@ public:
 
     bool dbg_propgation(Lit l){
 #ifdef DEBUG_GRAPH
-                                                                                                                                static vec<Lit> c;
+                                                                                                                                static thread_local vec<Lit> c;
 		c.clear();
 		for (int i = 0; i < S->trail.size(); i++) {
 			if (!S->hasTheory(S->trail[i]) || S->theoryHasVar(var(S->trail[i]),this) != getTheoryIndex())
@@ -1628,7 +1653,7 @@ public:
 
     //vec<Lit> to_reenqueue;
     void backtrackUntil(int untilLevel) override{
-        static int it = 0;
+        static thread_local int it = 0;
         ++it;
         undoRewind();
 
@@ -1743,8 +1768,6 @@ public:
 
 
     void backtrackUntil(Lit p){
-        static int it = 0;
-        ++it;
         undoRewind();
         //printf("g%d : backtrack until lit %d\n", this->id,dimacs(p));
         //need to remove and add edges in the two graphs accordingly.
@@ -1755,7 +1778,9 @@ public:
         //on the other hand, a satisfied lit shouldn't be involved in a conflict, and
         //everything should end up correctly in sync after the solver backtracks post-conflict, so this will
         //*hopefully* not matter...
-        int untilLevel = level(var(p));
+        //use the level at which p was recorded on the theory's trail, which may be higher than p's level in the SAT solver
+        //(if p was assigned out of order)
+        int untilLevel = onTrail(var(p)) && !onLazyTrail(var(p)) ? trail[var(p)].level : level(var(p));
         while(satisfied_lits.size() && satisfied_lits.last().level > untilLevel){
             int lev = satisfied_lits.last().level;
             assert(lev > untilLevel);
@@ -1780,7 +1805,7 @@ public:
         Var v;
         if(!onLazyTrail(var(p))){
 
-            backtrackUntil(level(var(p)));//this is neccesary!
+            backtrackUntil(untilLevel);//this is neccesary!
             assert(trail[var(p)].level == decisionLevel());
             v = getBack(decisionLevel());
         }else{
@@ -1911,10 +1936,10 @@ public:
     }
 
     Lit decideTheory(CRef& decision_reason) override{
-        if(!opt_decide_theories)
+        if(!S->decide_theories)
             return lit_Undef;
         double start = rtime(1);
-        static int iter = 0;
+        static thread_local int iter = 0;
         iter++;
 
 
@@ -2024,7 +2049,6 @@ public:
 
 
     void buildBVReason(int bvID, Comparison comp, Weight compareTo, vec<Lit>& reason){
-        static int iter = 0;
         //todo: optimize this for case where bv is statically known to satisfy or fail the constraint...
         BitVector<Weight> bv = bvTheory->getBV(bvID);
         Lit c = getBV_COMP(bvID, -comp, compareTo);
@@ -2057,6 +2081,7 @@ public:
             backtrackUntil(p);
 
             assert(d < detectors.size());
+            ProfileTimer timer(detectors[d]->profile, ProfileTimer::REASON);
             detectors[d]->buildReason(p, reason, marker);
             //toSolver(reason);
             double finish = rtime(1);
@@ -2323,7 +2348,11 @@ public:
         Var v = var(l);
         stats_enqueues++;
         int lev = level(v);//level from the SAT solver.
-        if(!opt_lazy_backtrack){
+        //With chronological backtracking (-chrono), lev may be lower than the theory's current decision level, if the
+        //SAT solver assigned l out of order. Such literals are recorded at the current level of the theory's trail;
+        //if the theory backtracks past that level while l is still assigned, the SAT solver will enqueue l again
+        //(see Solver::cancelUntil).
+        if(!opt_lazy_backtrack && opt_chrono < 0){
             assert(decisionLevel() <= lev);
         }
 
@@ -2387,7 +2416,7 @@ public:
             }
             removeFromTrail(var(l));
         }
-        if(!opt_lazy_backtrack){
+        if(!opt_lazy_backtrack && opt_chrono < 0){
             assert(decisionLevel() <= lev);
             if(decisionLevel() > lev){
                 throw std::runtime_error("Internal error in graph enqueue");
@@ -2551,10 +2580,6 @@ public:
 #endif*/
 
 
-        static int itp = 0;
-        if(++itp == 33){
-            int a = 1;
-        }
         dbg_graphsUpToDate();
         stats_propagations++;
 
@@ -2640,7 +2665,17 @@ public:
             assert(conflict.size() == 0);
             Lit l = lit_Undef;
             bool backtrackOnly = lazy_backtracking_enabled && (opt_lazy_conflicts == 3) && lazy_trail_head != var_Undef;
-            bool r = detectors[d]->propagate(conflict, backtrackOnly, l);
+            PropagationProfile& profile = detectors[d]->profile;
+            int64_t enqueued = stats_enqueued;
+            bool r;
+            {
+                ProfileTimer timer(profile, ProfileTimer::CALL);
+                r = detectors[d]->propagate(conflict, backtrackOnly, l);
+            }
+            profile.propagations += stats_enqueued - enqueued;
+            if(!r && conflict.size()){
+                profile.conflicts++;
+            }
             if(!r && backtrackOnly && conflict.size() == 0){
                 backtrackUntil(decisionLevel());
                 stats_num_lazy_conflicts++;
@@ -3754,18 +3789,15 @@ public:
             within_steps = -1;
         if(!backward){
             if(reach_info[from].source < 0){
-
-                addDetector((new AllPairsDetector<Weight>(detectors.size(), this, g_under, g_over, cutGraph,
-                                                          drand(rnd_seed))));
-                //reach_detectors.push(reach_detectors.last());
-
-                assert(detectors.last()->getID() == detectors.size() - 1);
-
-                //reach_detectors.last()->negative_dist_detector = new Dijkstra(from,antig);
-                //reach_detectors.last()->source=from;
+                if(!allpairs_detector){
+                    addDetector((new AllPairsDetector<Weight>(detectors.size(), this, g_under, g_over, cutGraph,
+                                                              drand(rnd_seed))));
+                    assert(detectors.last()->getID() == detectors.size() - 1);
+                    allpairs_detector = detectors.last();
+                }
 
                 reach_info[from].source = from;
-                reach_info[from].detector = detectors.last();
+                reach_info[from].detector = allpairs_detector;
 
                 //reach_detectors.last()->within=within_steps;
 
@@ -3777,26 +3809,20 @@ public:
             d->addLit(from, to, reach_var, within_steps);
         }else{
             if(backward_reach_info[from].source < 0){
-
-                addDetector(
-                        (new AllPairsDetector<Weight, DynamicBackGraph<Weight>>(detectors.size(), this, g_under_back,
-                                                                                g_over_back, cutGraph_back,
-                                                                                drand(rnd_seed))));
-                //reach_detectors.push(reach_detectors.last());
-
-                assert(detectors.last()->getID() == detectors.size() - 1);
-
-                //reach_detectors.last()->negative_dist_detector = new Dijkstra(from,antig);
-                //reach_detectors.last()->source=from;
+                if(!backward_allpairs_detector){
+                    addDetector(
+                            (new AllPairsDetector<Weight, DynamicBackGraph<Weight>>(detectors.size(), this, g_under_back,
+                                                                                    g_over_back, cutGraph_back,
+                                                                                    drand(rnd_seed))));
+                    assert(detectors.last()->getID() == detectors.size() - 1);
+                    backward_allpairs_detector = detectors.last();
+                }
 
                 backward_reach_info[from].source = from;
-                backward_reach_info[from].detector = detectors.last();
-
-                //reach_detectors.last()->within=within_steps;
-
+                backward_reach_info[from].detector = backward_allpairs_detector;
             }
 
-            AllPairsDetector<Weight, DynamicBackGraph<Weight>>* d = (AllPairsDetector<Weight, DynamicBackGraph<Weight>>*) reach_info[from].detector;
+            AllPairsDetector<Weight, DynamicBackGraph<Weight>>* d = (AllPairsDetector<Weight, DynamicBackGraph<Weight>>*) backward_reach_info[from].detector;
             assert(d);
 
             d->addLit(from, to, reach_var, within_steps);
@@ -3819,10 +3845,14 @@ public:
             within_steps = -1;
         if(!backward){
             if(reach_info[from].source < 0){
-
+                if(reachalg == ReachAlg::ALG_BFS_MULTI_SOURCE && !under_reach_engine){
+                    under_reach_engine = new MultiSourceReach<Weight>(g_under);
+                    over_reach_engine = new MultiSourceReach<Weight>(g_over);
+                }
                 ReachDetector<Weight>* rd = new ReachDetector<Weight>(detectors.size(), this, g_under, g_over, cutGraph,
                                                                       from,
-                                                                      drand(rnd_seed));
+                                                                      drand(rnd_seed), under_reach_engine,
+                                                                      over_reach_engine);
                 addDetector(rd);
                 reach_detectors.push(rd);
 
@@ -3844,9 +3874,13 @@ public:
             d->addLit(from, to, reach_var);
         }else{
             if(backward_reach_info[from].source < 0){
-
+                if(reachalg == ReachAlg::ALG_BFS_MULTI_SOURCE && !under_back_reach_engine){
+                    under_back_reach_engine = new MultiSourceReach<Weight, DynamicBackGraph<Weight>>(g_under_back);
+                    over_back_reach_engine = new MultiSourceReach<Weight, DynamicBackGraph<Weight>>(g_over_back);
+                }
                 ReachDetector<Weight, DynamicBackGraph<Weight>>* rd = new ReachDetector<Weight, DynamicBackGraph<Weight>>
-                        (detectors.size(), this, g_under_back, g_over_back, cutGraph_back, from, drand(rnd_seed));
+                        (detectors.size(), this, g_under_back, g_over_back, cutGraph_back, from, drand(rnd_seed),
+                         under_back_reach_engine, over_back_reach_engine);
                 addDetector(rd);
                 reach_back_detectors.push(rd);
 
@@ -312,8 +312,6 @@ void MSTDetector<Weight, Graph>::TarjanOLCA(int node, vec<Lit>& conflict){
 template<typename Weight, typename Graph>
 void MSTDetector<Weight, Graph>::buildMinWeightTooLargeReason(Weight& weight, vec<Lit>& conflict){
 
-    static int it = 0;
-    ++it;
 
     //drawFull( non_reach_detectors[detector]->getSource(),u);
     //assert(outer->dbg_distance( source,u));
@@ -575,7 +573,7 @@ void MSTDetector<Weight, Graph>::buildEdgeInTreeReason(int edgeid, vec<Lit>& con
     Var vt = outer->getEdgeVar(edgeid);
     assert(vt > 0);
     //assert(outer->value(vt)==l_True);
-    static int it = 0;
+    static thread_local int it = 0;
     if(++it == 3){
         int a = 1;;
     }
@@ -706,10 +704,6 @@ void MSTDetector<Weight, Graph>::preprocess(){
 
 template<typename Weight, typename Graph>
 bool MSTDetector<Weight, Graph>::propagate(vec<Lit>& conflict){
-    static int it = 0;
-    if(++it == 7){
-        int a = 1;
-    }
     if(outer->has_any_bitvector_edges){
         throw std::runtime_error("MST constraints don't yet support bitvector weight edges");
     }
@@ -22,6 +22,8 @@
 #include <monosat/core/Config.h>
 #include <monosat/dgl/Dinics.h>
 #include <monosat/dgl/DinicsLinkCut.h>
+#include <monosat/dgl/DinitzDynamic.h>
+#include <monosat/dgl/PushRelabel.h>
 #include <monosat/dgl/EdmondsKarpDynamic.h>
 #include <monosat/dgl/Reach.h>
 #include <monosat/dgl/BFS.h>
@@ -47,7 +49,8 @@ MaxflowDetector<Weight, Graph>::MaxflowDetector(int _detectorID, GraphTheorySolv
 
     MinCutAlg alg = mincutalg;
     if(outer->hasBitVectorEdges()){
-        if(alg != MinCutAlg::ALG_EDKARP_ADJ && alg != MinCutAlg::ALG_KOHLI_TORR){
+        if(alg != MinCutAlg::ALG_EDKARP_ADJ && alg != MinCutAlg::ALG_KOHLI_TORR && alg != MinCutAlg::ALG_DINITZ_DYN
+           && alg != MinCutAlg::ALG_PUSH_RELABEL){
             printf("Note: falling back on kohli-torr for maxflow, because edge weights are bitvectors\n");
             alg = MinCutAlg::ALG_KOHLI_TORR;
         }
@@ -86,6 +89,20 @@ MaxflowDetector<Weight, Graph>::MaxflowDetector(int _detectorID, GraphTheorySolv
 
         if(opt_conflict_min_cut_maxflow || opt_adaptive_conflict_mincut)
             learn_cut = new EdmondsKarpAdj<Weight>(learn_graph, source, target);
+    }else if(alg == MinCutAlg::ALG_DINITZ_DYN){
+        underapprox_detector = new DinitzDynamic<Weight>(_g, source, target);
+        overapprox_detector = new DinitzDynamic<Weight>(_antig, source, target);
+        underapprox_conflict_detector = underapprox_detector;
+        overapprox_conflict_detector = overapprox_detector;
+        if(opt_conflict_min_cut_maxflow || opt_adaptive_conflict_mincut)
+            learn_cut = new DinitzDynamic<Weight>(learn_graph, source, target);
+    }else if(alg == MinCutAlg::ALG_PUSH_RELABEL){
+        underapprox_detector = new PushRelabel<Weight>(_g, source, target);
+        overapprox_detector = new PushRelabel<Weight>(_antig, source, target);
+        underapprox_conflict_detector = underapprox_detector;
+        overapprox_conflict_detector = overapprox_detector;
+        if(opt_conflict_min_cut_maxflow || opt_adaptive_conflict_mincut)
+            learn_cut = new PushRelabel<Weight>(learn_graph, source, target);
     }else if(alg == MinCutAlg::ALG_KOHLI_TORR){
         underapprox_detector = new KohliTorr<Weight>(_g, source, target,
                                                      opt_kt_preserve_order);
@@ -657,7 +674,7 @@ template<typename Weight, typename Graph>
 void MaxflowDetector<Weight, Graph>::buildMaxFlowTooLowReason(Weight maxflow, vec<Lit>& conflict, bool force_maxflow){
     //Consider using the kernigan-lin partitioning heuristic to get a separating cut here, instead of maxflow?
 
-    static int it = 0;
+    static thread_local int it = 0;
     ++it;
     if(it == 3){
         int a = 1;
@@ -774,7 +791,7 @@ bool MaxflowDetector<Weight, Graph>::propagate(vec<Lit>& conflict, bool backtrac
     if(flow_lits.size() == 0){
         return true;
     }
-    static int iter1 = 0;
+    static thread_local int iter1 = 0;
     if(++iter1 == 156 || iter1 == 19){
         int a = 1;
     }
@@ -968,10 +985,6 @@ template<typename Weight, typename Graph>
 void
 MaxflowDetector<Weight, Graph>::FlowOp::analyzeReason(bool compareOver, Comparison op, Weight to, vec<Lit>& conflict){
 //watch out - might need to backtrack the graph theory appropriately, here...
-    static int iter = 0;
-    if(++iter == 46){
-        int a = 1;
-    }
     GraphTheorySolver<Weight>::GraphTheoryOp::analyzeReason(compareOver, op, to, conflict);
     if(!compareOver){
         outer->analyzeMaxFlowGEQ(to, conflict);
@@ -1164,7 +1177,8 @@ void MaxflowDetector<Weight, Graph>::collectDisabledEdges(){
     if(opt_conflict_min_cut_maxflow){
         buildLearnGraph();
 
-        if(learngraph_history_clears != g_over.historyclears || g_over.changed()){
+        if(learngraph_history_clears != g_over.historyclears || learngraph_history_qhead < g_over.historyStart()
+           || g_over.changed()){
             //refresh
             overapprox_conflict_detector->update();
             for(int edgeid = 0; edgeid < g_over.edges(); edgeid++){
@@ -1289,7 +1303,7 @@ void MaxflowDetector<Weight, Graph>::collectChangedEdges(){
 
     //need to deal with changes to bv edge weights, also!
     for(int j = changed_edges.size() - 1; j >= 0; j--){
-        static int iter = 0;
+        static thread_local int iter = 0;
         ++iter;
         int edgeid = changed_edges[j];
         if(opt_theory_internal_vsids){
@@ -1434,7 +1448,7 @@ void MaxflowDetector<Weight, Graph>::collectChangedEdges(){
 template<typename Weight, typename Graph>
 void MaxflowDetector<Weight, Graph>::dbg_decisions(){
 #ifdef DEBUG_GRAPH
-    static int iter = 0;
+    static thread_local int iter = 0;
     ++iter;
     if (iter == 911) {
         int a = 1;
@@ -1667,7 +1681,7 @@ bool MaxflowDetector<Weight, Graph>::detectorIsSatisfied(){
 
 template<typename Weight, typename Graph>
 void MaxflowDetector<Weight, Graph>::undecide(Lit l){
-    static int iter = 0;
+    static thread_local int iter = 0;
     Detector::unassign(l);
     if(outer->isEdgeVar(var(l))){
         ++iter;
@@ -1698,10 +1712,6 @@ Lit MaxflowDetector<Weight, Graph>::decide(CRef& decision_reason){
     if(n_satisfied_lits == flow_lits.size())
         return lit_Undef;
 
-    static int it = 0;
-    if(++it == 51085){
-        int a = 1;
-    }
     double startdecidetime = rtime(2);
     auto* over = overapprox_conflict_detector;
     auto* under = underapprox_conflict_detector;
@@ -2030,7 +2040,7 @@ Lit MaxflowDetector<Weight, Graph>::decide(CRef& decision_reason){
                 assert(over_flow >= required_flow);
 
 #ifdef DEBUG_GRAPH
-                static vec<bool> dbg_expect;
+                static thread_local vec<bool> dbg_expect;
                 int dbg_count = 0;
                 dbg_expect.clear();
                 dbg_expect.growTo(g_under.edges());
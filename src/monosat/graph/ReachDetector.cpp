@@ -30,13 +30,16 @@
 #include "monosat/dgl/TarjansSCC.h"
 #include "monosat/graph/GraphHeuristic.h"
 #include "monosat/graph/MaxflowDetector.h"
+#include "monosat/dgl/PushRelabel.h"
 #include "monosat/dgl/CachedReach.h"
 
 using namespace Monosat;
 
 template<typename Weight, typename Graph>
 ReachDetector<Weight, Graph>::ReachDetector(int _detectorID, GraphTheorySolver<Weight>* _outer, Graph& g_under,
-                                            Graph& g_over, Graph& cutGraph, int from, double seed) :
+                                            Graph& g_over, Graph& cutGraph, int from, double seed,
+                                            MultiSourceReach<Weight, Graph>* under_engine,
+                                            MultiSourceReach<Weight, Graph>* over_engine) :
         Detector(_detectorID), outer(_outer), g_under(g_under), g_over(g_over), cutGraph(cutGraph), within(-1),
         source(from), rnd_seed(seed){
 
@@ -70,9 +73,9 @@ ReachDetector<Weight, Graph>::ReachDetector(int _detectorID, GraphTheorySolver<W
         return;
     }
 
-    if(opt_decide_graph_chokepoints){
-        chokepoint_detector = new DFSReachability<Weight, Graph, Reach::NullStatus>(from, g_over, Reach::nullStatus, 1);
-
+    if(opt_decide_graph_chokepoints || opt_reach_forced_edge_prop){
+        chokepoint_status = new ChokepointStatus(*this);
+        chokepoint_detector = new Chokepoint<Weight, Graph, ChokepointStatus>(*chokepoint_status, g_over, from);
     }
     if(opt_shrink_theory_conflicts){
         cutgraph_detector = new UnweightedRamalReps<Weight, DynamicGraph<Weight>, Reach::NullStatus>(from,
@@ -88,23 +91,29 @@ ReachDetector<Weight, Graph>::ReachDetector(int _detectorID, GraphTheorySolver<W
      }*/
     positiveReachStatus = new ReachDetector<Weight, Graph>::ReachStatus(*this, true);
     negativeReachStatus = new ReachDetector<Weight, Graph>::ReachStatus(*this, false);
-    if(reachalg == ReachAlg::ALG_BFS){
+    if(reachalg == ReachAlg::ALG_BFS || reachalg == ReachAlg::ALG_BFS_DO){
+        auto* under = new BFSReachability<Weight, Graph, ReachDetector<Weight, Graph>::ReachStatus>(from,
+                                                                                                     g_under,
+                                                                                                     *(positiveReachStatus),
+                                                                                                     1);
         if(!opt_encode_reach_underapprox_as_sat){
-            underapprox_detector = new BFSReachability<Weight, Graph, ReachDetector<Weight, Graph>::ReachStatus>(from,
-                                                                                                                 g_under,
-                                                                                                                 *(positiveReachStatus),
-                                                                                                                 1);
+            underapprox_detector = under;
         }else{
-            underapprox_fast_detector = new BFSReachability<Weight, Graph, ReachDetector<Weight, Graph>::ReachStatus>(
-                    from, g_under,
-                    *(positiveReachStatus), 1);
+            underapprox_fast_detector = under;
             //positive_reach_detector = new ReachDetector::CNFReachability(*this,false);
         }
 
-        overapprox_reach_detector = new BFSReachability<Weight, Graph, ReachDetector<Weight, Graph>::ReachStatus>(from,
-                                                                                                                  g_over,
-                                                                                                                  *(negativeReachStatus),
-                                                                                                                  -1);
+        auto* over = new BFSReachability<Weight, Graph, ReachDetector<Weight, Graph>::ReachStatus>(from,
+                                                                                                    g_over,
+                                                                                                    *(negativeReachStatus),
+                                                                                                    -1);
+        if(reachalg == ReachAlg::ALG_BFS_DO){
+            under->opt_direction_optimizing = true;
+            over->opt_direction_optimizing = true;
+        }
+        under->opt_early_termination = opt_reach_early_termination;
+        over->opt_early_termination = opt_reach_early_termination;
+        overapprox_reach_detector = over;
 
         underapprox_path_detector = underapprox_detector;
         overapprox_path_detector = overapprox_reach_detector;
@@ -256,6 +265,22 @@ ReachDetector<Weight, Graph>::ReachDetector(int _detectorID, GraphTheorySolver<W
         //underapprox_path_detector = new UnweightedBFS<Weight,Distance<int>::NullStatus>(from, g_under, Distance<int>::nullStatus, 1);
         //overapprox_path_detector = new UnweightedBFS<Weight,Distance<int>::NullStatus>(from, g_over, Distance<int>::nullStatus, -1);
         negative_distance_detector = (Distance<int>*) overapprox_path_detector;
+    }else if(reachalg == ReachAlg::ALG_BFS_MULTI_SOURCE){
+        assert(under_engine);
+        assert(over_engine);
+        typedef typename MultiSourceReach<Weight, Graph>::template SourceReach<ReachDetector<Weight, Graph>::ReachStatus> SourceReach;
+        if(!opt_encode_reach_underapprox_as_sat){
+            underapprox_detector = new SourceReach(*under_engine, from, *(positiveReachStatus), 1);
+        }else{
+            underapprox_fast_detector = new SourceReach(*under_engine, from, *(positiveReachStatus), 1);
+        }
+        overapprox_reach_detector = new SourceReach(*over_engine, from, *(negativeReachStatus), -1);
+
+        //The shared engines do not track paths, so conflict analysis and decisions use separate (lazily updated) BFS instances.
+        underapprox_path_detector = new BFSReachability<Weight, Graph, Reach::NullStatus>(from, g_under,
+                                                                                           Reach::nullStatus, 1);
+        overapprox_path_detector = new BFSReachability<Weight, Graph, Reach::NullStatus>(from, g_over,
+                                                                                          Reach::nullStatus, -1);
     }/*else if (reachalg==ReachAlg::ALG_THORUP){
 
 
@@ -309,6 +334,10 @@ ReachDetector<Weight, Graph>::ReachDetector(int _detectorID, GraphTheorySolver<W
 
             conflict_flow = new Dinitz<Weight>(cutGraph, source, 0);
 
+        }else if(mincutalg == MinCutAlg::ALG_DINITZ_DYN){
+            conflict_flow = new DinitzDynamic<Weight>(cutGraph, source, 0);
+        }else if(mincutalg == MinCutAlg::ALG_PUSH_RELABEL){
+            conflict_flow = new PushRelabel<Weight>(cutGraph, source, 0);
         }else if(mincutalg == MinCutAlg::ALG_KOHLI_TORR){
             if(opt_use_kt_for_conflicts){
                 conflict_flow = new KohliTorr<Weight>(cutGraph, source, 0,
@@ -320,7 +349,7 @@ ReachDetector<Weight, Graph>::ReachDetector(int _detectorID, GraphTheorySolver<W
         }
     }
 
-    if(opt_graph_cache_propagation){
+    if(opt_graph_cache_propagation && reachalg != ReachAlg::ALG_BFS_MULTI_SOURCE){
         if(underapprox_detector){
             Reach* original_underapprox_detector = underapprox_detector;
             underapprox_detector = new CachedReach<Weight, Graph, ReachDetector<Weight, Graph>::ReachStatus>(
@@ -610,6 +639,9 @@ class ReachHeuristic : public GraphHeuristic<Weight> {
     Graph& g_over;
     Graph& g_under;
     IntSet<int> path_edges;
+    std::vector<int> chokepoint_edges;
+    IntSet<int> is_chokepoint;
+    vec<Lit> path_decisions;
     bool path_is_cut = false;
     int dest_node = -1;
     Heuristic* sub_heuristic = nullptr;
@@ -653,7 +685,7 @@ public:
             under_reach = r->underapprox_fast_detector;
         }
 
-        static int iter = 0;
+        static thread_local int iter = 0;
         if(++iter == 16){
             int a = 1;
             /*for(int edgeID = 0;edgeID<g_over.nEdgeIDs();edgeID++){
@@ -754,6 +786,33 @@ public:
 
                             }
                             //printf("\n");
+                            if(r->chokepoint_detector && opt_decide_graph_chokepoints){
+                                //every path to j must use the chokepoint edges, so decide those first
+                                //(decisions are taken from the end of to_decide)
+                                chokepoint_edges.clear();
+                                r->chokepoint_detector->collectChokepointEdges(j, chokepoint_edges);
+                                if(chokepoint_edges.size()){
+                                    path_decisions.clear();
+                                    for(int i = 0; i < to_decide.size(); i++){
+                                        path_decisions.push(to_decide[i]);
+                                    }
+                                    to_decide.clear();
+                                    for(int edgeID:chokepoint_edges){
+                                        is_chokepoint.insert(edgeID);
+                                    }
+                                    for(Lit l:path_decisions){
+                                        if(!is_chokepoint.has(outer->getEdgeID(var(l))))
+                                            to_decide.push(l);
+                                    }
+                                    for(int edgeID:chokepoint_edges){
+                                        Var edge_var = outer->getEdgeVar(edgeID);
+                                        if(outer->value(edge_var) == l_Undef){
+                                            to_decide.push(mkLit(edge_var, false));
+                                        }
+                                    }
+                                    is_chokepoint.clear();
+                                }
+                            }
                         }
                     }else{
                         //Randomly re-weight the graph sometimes
@@ -856,7 +915,8 @@ public:
             return true;
         }
 
-        if(last_over_history_clear != g_over.nHistoryClears() || last_under_history_clear != g_under.nHistoryClears()){
+        if(last_over_history_clear != g_over.nHistoryClears() || last_under_history_clear != g_under.nHistoryClears()
+           || over_history_qhead < g_over.historyStart() || under_history_qhead < g_under.historyStart()){
             over_history_qhead = g_over.historySize();
             last_over_history_clear = g_over.nHistoryClears();
             under_history_qhead = g_under.historySize();
@@ -964,10 +1024,6 @@ public:
         if(outer->value(reach_lit) == l_Undef){
             return lit_Undef;//if the reach lit is unassigned, do not make any decisions here
         }
-        static int iter = 0;
-        if(++iter == 11){
-            int a = 1;
-        }
 
         {
             //Routing ideas from Alex Nadel's FMCAD16 paper
@@ -1095,9 +1151,11 @@ void ReachDetector<Weight, Graph>::addLit(int from, int to, Var outer_reach_var)
     reach_lit_map[reach_var - first_reach_var] = to;
     if(underapprox_detector){
         underapprox_detector->addDestination(to);
+        underapprox_detector->setTargetActive(to, true);
     }
     if(overapprox_reach_detector){
         overapprox_reach_detector->addDestination(to);
+        overapprox_reach_detector->setTargetActive(to, true);
     }
     if(overapprox_path_detector != overapprox_reach_detector){
         overapprox_path_detector->addDestination(to);
@@ -1148,6 +1206,10 @@ void ReachDetector<Weight, Graph>::addLit(int from, int to, Var outer_reach_var)
 
                         conflict_flow_t = new Dinitz<Weight>(cutGraph, source, i);
 
+                    }else if(mincutalg == MinCutAlg::ALG_DINITZ_DYN){
+                        conflict_flow_t = new DinitzDynamic<Weight>(cutGraph, source, i);
+                    }else if(mincutalg == MinCutAlg::ALG_PUSH_RELABEL){
+                        conflict_flow_t = new PushRelabel<Weight>(cutGraph, source, i);
                     }else if(mincutalg == MinCutAlg::ALG_KOHLI_TORR){
                         if(opt_use_kt_for_conflicts){
                             conflict_flow_t = new KohliTorr<Weight>(cutGraph, source, i,
@@ -1279,7 +1341,7 @@ void ReachDetector<Weight, Graph>::buildReachReason(int node, vec<Lit>& conflict
 
 template<typename Weight, typename Graph>
 void ReachDetector<Weight, Graph>::buildNonReachReason(int node, vec<Lit>& conflict, bool force_maxflow){
-    static int it = 0;
+    static thread_local int it = 0;
     ++it;
     if(it == 4){
         int a = 1;
@@ -1531,25 +1593,24 @@ void ReachDetector<Weight, Graph>::buildNonReachReason(int node, vec<Lit>& confl
 
 /**
  * Explain why an edge was forced (to true).
- * The reason is that _IF_ that edge is false, THEN there is a cut of disabled edges between source and target
- * So, create the graph that has that edge (temporarily) assigned false, and find a min-cut in it...
+ * The reason is that _IF_ that edge is false, THEN there is a cut of disabled edges between source and target,
+ * but the target must be reachable.
+ * So, walk back from the target in the over-approximate graph without that edge, collecting the disabled edges...
  */
 template<typename Weight, typename Graph>
 void ReachDetector<Weight, Graph>::buildForcedEdgeReason(int reach_node, int forced_edge_id, vec<Lit>& conflict){
-    static int it = 0;
-    ++it;
 
     assert(outer->value(outer->getEdgeVar(forced_edge_id)) == l_True);
     Lit edgeLit = mkLit(outer->getEdgeVar(forced_edge_id), false);
 
     conflict.push(edgeLit);
+    assert(outer->value(reach_lits[reach_node]) == l_True);
+    conflict.push(~reach_lits[reach_node]);
 
     int forced_edge_from = g_over.getEdge(forced_edge_id).from;
     int forced_edge_to = g_over.getEdge(forced_edge_id).to;
 
     int u = reach_node;
-    //drawFull( non_reach_detectors[detector]->getSource(),u);
-    assert(outer->dbg_notreachable(source, u));
     double starttime = rtime(2);
     cutGraph.clearHistory();
     outer->stats_mc_calls++;
@@ -1609,15 +1670,17 @@ void ReachDetector<Weight, Graph>::buildForcedEdgeReason(int reach_node, int for
             assert(u != source);
             to_visit.pop();
             assert(seen[u]);
-            assert(!overapprox_reach_detector->connected_unsafe(u));
             //Ok, then add all its incoming disabled edges to the cut, and visit any unseen, non-disabled incoming.edges()
             for(int i = 0; i < g_over.nIncoming(u); i++){
                 int v = outer->getEdgeVar(g_over.incoming(u, i).id);
                 int from = g_over.incoming(u, i).node;
-                //Note: the variable has to not only be assigned false, but assigned false earlier in the trail than the reach variable...
+                //Note: the variable has to not only be assigned false, but assigned false earlier in the trail than the forced edge,
+                //so check the (backtracked) over-approximate graph, rather than the assignment
                 int edge_num = outer->getEdgeID(v);                        // v-outer->min_edge_var;
 
-                if(edge_num == forced_edge_id || outer->value(v) == l_False){
+                if(edge_num == forced_edge_id){
+                    //the forced edge is already in the reason
+                }else if(!g_over.edgeEnabled(edge_num)){
                     //note: we know we haven't seen this edge variable before, because we know we haven't visited this node before
                     //if we are already planning on visiting the from node, then we don't need to include it in the conflict (is this correct?)
                     //if(!seen[from])
@@ -1706,10 +1769,6 @@ void ReachDetector<Weight, Graph>::buildReason(Lit p, vec<Lit>& reason, CRef mar
 
 template<typename Weight, typename Graph>
 bool ReachDetector<Weight, Graph>::propagate(vec<Lit>& conflict){
-    static int iter = 0;
-    if(++iter == 5){
-        int a = 1;
-    }
     conflictingHeuristic = nullptr;
     bool skipped_positive = false;
     if(underapprox_detector && (!opt_detect_pure_theory_lits || unassigned_positives > 0)){
@@ -1820,6 +1879,21 @@ bool ReachDetector<Weight, Graph>::propagate(vec<Lit>& conflict){
         }
     }
 
+    if(chokepoint_detector && opt_reach_forced_edge_prop){
+        //any edge that dominates a node that must be reached, in the over-approximate graph, must be enabled
+        forced_edges.clear();
+        chokepoint_detector->collectForcedEdges(forced_edges);
+        for(ForceReason& f:forced_edges){
+            Lit l = mkLit(outer->getEdgeVar(f.edge_id), false);
+            if(outer->value(l) == l_Undef){
+                force_reason.growTo(g_over.edges(), -1);
+                force_reason[f.edge_id] = f.node;
+                stats_forced_edges++;
+                outer->enqueue(l, forced_edge_marker);
+            }
+        }
+    }
+
 #ifdef DEBUG_GRAPH
     for(int i = 0;i<reach_lits.size();i++) {
         Lit l = reach_lits[i];
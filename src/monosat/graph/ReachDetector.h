@@ -28,6 +28,7 @@
 #include "monosat/dgl/Dijkstra.h"
 #include "monosat/dgl/BFS.h"
 #include "monosat/dgl/DFS.h"
+#include "monosat/dgl/MultiSourceReach.h"
 
 #include "monosat/core/SolverTypes.h"
 #include "monosat/mtl/Map.h"
@@ -115,6 +116,7 @@ public:
     int stats_learnt_components = 0;
     int stats_learnt_components_sz = 0;
     int64_t stats_heuristic_recomputes = 0;
+    int64_t stats_forced_edges = 0;
     double mod_percentage = 0.2;
     int stats_pure_skipped = 0;
     int stats_shrink_removed = 0;
@@ -142,6 +144,11 @@ public:
         if(opt_decide_theories){
             printf("\t%" PRId64 " heuristic path recomputations\n", stats_heuristic_recomputes);
         }
+        if(chokepoint_detector){
+            printf("\t%" PRId64 " forced edges, %" PRId64 " dominator tree updates (%" PRId64 " skipped)\n",
+                   stats_forced_edges, chokepoint_detector->dominators.stats_full_updates,
+                   chokepoint_detector->dominators.stats_skipped_updates);
+        }
         if(overapprox_reach_detector){
             printf("\t\tOverapproxReach: ");
             overapprox_reach_detector->printStats();
@@ -194,7 +201,27 @@ public:
 
      OptimalWeightEdgeStatus opt_weight;
      WeightedDijkstra<OptimalWeightEdgeStatus> * opt_path;*/
-    Reach* chokepoint_detector = nullptr;
+    //Edges that are candidates to be forced are those that are still unassigned,
+    //and nodes that must be reached are those with a reach literal assigned true.
+    struct ChokepointStatus {
+        ReachDetector& detector;
+
+        bool mustReach(int node){
+            return node < detector.reach_lits.size() && detector.reach_lits[node] != lit_Undef
+                   && detector.outer->value(detector.reach_lits[node]) == l_True;
+        }
+
+        bool operator()(int edge_id){
+            return detector.outer->value(detector.outer->getEdgeVar(edge_id)) == l_Undef;
+        }
+
+        ChokepointStatus(ReachDetector& _outer) :
+                detector(_outer){
+        }
+    };
+
+    ChokepointStatus* chokepoint_status = nullptr;
+    Chokepoint<Weight, Graph, ChokepointStatus>* chokepoint_detector = nullptr;
 /*	struct CutStatus {
 		int64_t one = 1;
 		int64_t inf = 0xFFFF;
@@ -216,16 +243,6 @@ public:
 
 	} cutStatus;*/
     std::vector<MaxFlowEdge> cut;
-    /*		struct ChokepointStatus{
-     ReachDetector & detector;
-     bool mustReach(int node);
-     bool operator() (int edge_id);
-     ChokepointStatus(ReachDetector & _outer):detector(_outer){
-
-     }
-     }chokepoint_status;
-
-     Chokepoint<ChokepointStatus > chokepoint;*/
 
     //This class can stand in as a reach algorithm if we have encoded reachability directly into the cnf.
     class CNFReachability : public Reach {
@@ -288,6 +305,11 @@ public:
         int index = var(l) - first_reach_var;
         if(index >= 0 && index < reach_lit_map.size() && reach_lit_map[index] != -1){
             int node = reach_lit_map[index];
+            //the node is once again a target of both the under and over approximations
+            if(underapprox_detector)
+                underapprox_detector->setTargetActive(node, true);
+            if(overapprox_reach_detector)
+                overapprox_reach_detector->setTargetActive(node, true);
 
             if(!is_changed_under[node]){
                 changed.push({var(l), node, true});
@@ -311,6 +333,15 @@ public:
         int index = var(l) - first_reach_var;
         if(index >= 0 && index < reach_lit_map.size()){
             int to = reach_lit_map[index];
+            if(to >= 0){
+                //once its reach literal is assigned, the under approximation no longer needs to find out if a node that
+                //must be reachable is reachable (and likewise the over approximation, for a node that must not be).
+                if(!sign(l) && underapprox_detector){
+                    underapprox_detector->setTargetActive(to, false);
+                }else if(sign(l) && overapprox_reach_detector){
+                    overapprox_reach_detector->setTargetActive(to, false);
+                }
+            }
             if(to >= 0 && to < reach_heuristics.size() && reach_heuristics[to]){
                 outer->activateHeuristic(reach_heuristics[to]);
             }
@@ -360,13 +391,18 @@ public:
 
     void dbg_sync_reachability();
 
+    //If reachalg is ALG_BFS_MULTI_SOURCE, the under and over approximate reachability of this detector's source
+    //is computed by the given (shared) engines.
     ReachDetector(int _detectorID, GraphTheorySolver<Weight>* _outer, Graph& g_under, Graph& g_over, Graph& cutGraph,
-                  int _source, double seed = 1);
+                  int _source, double seed = 1, MultiSourceReach<Weight, Graph>* under_engine = nullptr,
+                  MultiSourceReach<Weight, Graph>* over_engine = nullptr);
 
     ~ReachDetector() override{
 
         if(chokepoint_detector)
             delete chokepoint_detector;
+        if(chokepoint_status)
+            delete chokepoint_status;
         if(cutgraph_detector)
             delete cutgraph_detector;
 
@@ -381,7 +417,8 @@ public:
         if(overapprox_path_detector && overapprox_path_detector != overapprox_reach_detector)
             delete overapprox_path_detector;
 
-        if(underapprox_fast_detector && underapprox_fast_detector != underapprox_path_detector){
+        if(underapprox_fast_detector && underapprox_fast_detector != underapprox_path_detector &&
+           underapprox_fast_detector != underapprox_detector){
             delete underapprox_fast_detector;
         }
 
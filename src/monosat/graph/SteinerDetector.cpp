@@ -335,10 +335,6 @@ void SteinerDetector<Weight, Graph>::buildReason(Lit p, vec<Lit>& reason, CRef m
 
 template<typename Weight, typename Graph>
 bool SteinerDetector<Weight, Graph>::propagate(vec<Lit>& conflict){
-    static int it = 0;
-    if(++it == 7){
-        int a = 1;
-    }
     changed_weights.clear();
     double startdreachtime = rtime(2);
     stats_under_updates++;
@@ -122,8 +122,8 @@ public:
         }
 
         q.clear();
-        if(last_history_clear != g.nHistoryClears()){
-            history_qhead = 0;
+        if(last_history_clear != g.nHistoryClears() || history_qhead < g.historyStart()){
+            history_qhead = g.historyStart();
             last_history_clear = g.nHistoryClears();
         }
         //ok, now check if any of the added edges allow for a decrease in distance.
@@ -131,8 +131,8 @@ public:
             assert(g.getChange(
                     i).addition); //NOTE: Currently, this is glitchy in some circumstances - specifically, ./modsat -rinc=1.05 -rnd-restart  -conflict-shortest-path  -no-conflict-min-cut   -rnd-init -rnd-seed=01231 -rnd-freq=0.01 /home/sam/data/gnf/unit_tests/unit_test_17_reduced.gnf can trigger this assertion!
             int edgeID = g.getChange(i).id;
-            int u = g.all_edges[edgeID].from;
-            int v = g.all_edges[edgeID].to;
+            int u = g.getEdge(edgeID).from;
+            int v = g.getEdge(edgeID).to;
             Weight alt = dist[u] + weights[u];
             if(alt < dist[v]){
 
@@ -149,8 +149,8 @@ public:
                 else
                     q.decrease(v);
             }else if(undirected){
-                int v = g.all_edges[edgeID].from;
-                int u = g.all_edges[edgeID].to;
+                int v = g.getEdge(edgeID).from;
+                int u = g.getEdge(edgeID).to;
                 Weight alt = dist[u] + weights[u];
                 if(alt < dist[v]){
 
@@ -214,7 +214,7 @@ public:
     }
 
     void update(){
-        static int iteration = 0;
+        static thread_local int iteration = 0;
         int local_it = ++iteration;
         if(local_it == 17513){
             int a = 1;
@@ -26,6 +26,8 @@
 #include "monosat/dgl/KohliTorr.h"
 #include "monosat/dgl/EdmondsKarpDynamic.h"
 #include "monosat/dgl/Dinics.h"
+#include "monosat/dgl/DinitzDynamic.h"
+#include "monosat/dgl/PushRelabel.h"
 #include "monosat/dgl/DynamicGraph.h"
 #include "monosat/dgl/Graph.h"
 #include "monosat/dgl/DinicsLinkCut.h"
@@ -75,12 +77,15 @@ WeightedDistanceDetector<Weight, Graph>::WeightedDistanceDetector(int _detectorI
     if(outer->hasBitVectorEdges()){
         printf("Note: falling back on Dijkstra for shortest paths, because edge weights are bitvectors\n");
         //ramel reps doesn't support bvs yet
-        underapprox_weighted_distance_detector =
-                new Dijkstra<Weight, Graph, typename WeightedDistanceDetector<Weight, Graph>::DistanceStatus>(from, _g,
-                                                                                                              *positiveDistanceStatus,
-                                                                                                              0);
-        overapprox_weighted_distance_detector = new Dijkstra<Weight, Graph, typename WeightedDistanceDetector<Weight, Graph>::DistanceStatus>(
+        auto* under = new Dijkstra<Weight, Graph, typename WeightedDistanceDetector<Weight, Graph>::DistanceStatus>(from, _g,
+                                                                                                                    *positiveDistanceStatus,
+                                                                                                                    0);
+        auto* over = new Dijkstra<Weight, Graph, typename WeightedDistanceDetector<Weight, Graph>::DistanceStatus>(
                 from, _antig, *negativeDistanceStatus, 0);
+        under->opt_radix_heap = opt_radix_heap;
+        over->opt_radix_heap = opt_radix_heap;
+        underapprox_weighted_distance_detector = under;
+        overapprox_weighted_distance_detector = over;
         underapprox_weighted_path_detector = underapprox_weighted_distance_detector;
     }else if(distalg == DistAlg::ALG_RAMAL_REPS){
 
@@ -94,13 +99,26 @@ WeightedDistanceDetector<Weight, Graph>::WeightedDistanceDetector(int _detectorI
                                                                                                                *(negativeDistanceStatus),
                                                                                                                -2);
         underapprox_weighted_path_detector = underapprox_weighted_distance_detector; //new Dijkstra<Weight>(from, _g);
+    }else if(distalg == DistAlg::ALG_BIDIRECTIONAL){
+        typedef BidirectionalDijkstra<Weight, Graph, typename WeightedDistanceDetector<Weight, Graph>::DistanceStatus> BidirectionalDijkstraT;
+        if(opt_dist_landmarks > 0){
+            landmarks = new ALTLandmarks<Weight, Graph>(_antig, opt_dist_landmarks);
+        }
+        underapprox_weighted_distance_detector = new BidirectionalDijkstraT(from, _g, *positiveDistanceStatus, 0,
+                                                                             landmarks);
+        overapprox_weighted_distance_detector = new BidirectionalDijkstraT(from, _antig, *negativeDistanceStatus, 0,
+                                                                            landmarks);
+        underapprox_weighted_path_detector = underapprox_weighted_distance_detector;
     }else{
-        underapprox_weighted_distance_detector =
-                new Dijkstra<Weight, Graph, typename WeightedDistanceDetector<Weight, Graph>::DistanceStatus>(from, _g,
-                                                                                                              *positiveDistanceStatus,
-                                                                                                              0);
-        overapprox_weighted_distance_detector = new Dijkstra<Weight, Graph, typename WeightedDistanceDetector<Weight, Graph>::DistanceStatus>(
+        auto* under = new Dijkstra<Weight, Graph, typename WeightedDistanceDetector<Weight, Graph>::DistanceStatus>(from, _g,
+                                                                                                                    *positiveDistanceStatus,
+                                                                                                                    0);
+        auto* over = new Dijkstra<Weight, Graph, typename WeightedDistanceDetector<Weight, Graph>::DistanceStatus>(
                 from, _antig, *negativeDistanceStatus, 0);
+        under->opt_radix_heap = opt_radix_heap;
+        over->opt_radix_heap = opt_radix_heap;
+        underapprox_weighted_distance_detector = under;
+        overapprox_weighted_distance_detector = over;
         underapprox_weighted_path_detector = underapprox_weighted_distance_detector;
     }
 
@@ -115,6 +133,10 @@ WeightedDistanceDetector<Weight, Graph>::WeightedDistanceDetector(int _detectorI
             //link-cut tree currently only supports ints
             conflict_flow = new Dinitz<Weight>(cutGraph, source, 0);
 
+        }else if(mincutalg == MinCutAlg::ALG_DINITZ_DYN){
+            conflict_flow = new DinitzDynamic<Weight>(cutGraph, source, 0);
+        }else if(mincutalg == MinCutAlg::ALG_PUSH_RELABEL){
+            conflict_flow = new PushRelabel<Weight>(cutGraph, source, 0);
         }else if(mincutalg == MinCutAlg::ALG_KOHLI_TORR){
             if(opt_use_kt_for_conflicts){
                 conflict_flow = new KohliTorr<Weight>(cutGraph, source, 0,
@@ -153,6 +175,8 @@ void WeightedDistanceDetector<Weight, Graph>::addWeightedShortestPathLit(int fro
         reach_lit_map.push({-1, -1, None});
     }
     reach_lit_map[reach_var - first_reach_var] = {to, weighted_dist_lits.size() - 1, WeightedConstLit};
+    underapprox_weighted_distance_detector->addDestination(to);
+    overapprox_weighted_distance_detector->addDestination(to);
 }
 
 template<typename Weight, typename Graph>
@@ -181,6 +205,8 @@ void WeightedDistanceDetector<Weight, Graph>::addWeightedShortestPathBVLit(int f
         reach_lit_map.push({-1, -1, None});
     }
     reach_lit_map[reach_var - first_reach_var] = {to, weighted_dist_bv_lits.size() - 1, WeightedBVLit};
+    underapprox_weighted_distance_detector->addDestination(to);
+    overapprox_weighted_distance_detector->addDestination(to);
 }
 
 
@@ -205,10 +231,6 @@ template<typename Weight, typename Graph>
 void WeightedDistanceDetector<Weight, Graph>::DistanceOp::analyzeReason(bool compareOver, Comparison op, Weight to,
                                                                         vec<Lit>& conflict){
 //watch out - might need to backtrack the graph theory appropriately, here...
-    static int iter = 0;
-    if(++iter == 46){
-        int a = 1;
-    }
     GraphTheorySolver<Weight>::GraphTheoryOp::analyzeReason(compareOver, op, to, conflict);
     if(!compareOver){
         Lit l = this->comparisonLit;
@@ -421,10 +443,8 @@ void WeightedDistanceDetector<Weight, Graph>::analyzeDistanceGTReason(int to, We
 template<typename Weight, typename Graph>
 void WeightedDistanceDetector<Weight, Graph>::buildDistanceGTReason(int to, Weight& min_distance, vec<Lit>& conflict,
                                                                     bool strictComparison){
-    static int it = 0;
     stats_distance_gt_reasons++;
     stats_over_conflicts++;
-    ++it;
     double starttime = rtime(2);
     int u = to;
     analyzeDistanceGTReason(to, min_distance, conflict, strictComparison);
@@ -564,12 +584,12 @@ void WeightedDistanceDetector<Weight, Graph>::preprocess(){
 template<typename Weight, typename Graph>
 bool WeightedDistanceDetector<Weight, Graph>::propagate(vec<Lit>& conflict){
 
-    static int iter = 0;
-    if(++iter == 29){ //18303
-        int a = 1;
-    }
 
     //printf("iter %d\n",iter);
+    if(landmarks && outer->decisionLevel() == 0){
+        //edges are only disabled above level 0, so landmark distances computed now remain valid lower bounds
+        landmarks->update();
+    }
     bool skipped_positive = false;
     //getChanged().clear();
     if(!opt_detect_pure_theory_lits || unassigned_positives > 0){
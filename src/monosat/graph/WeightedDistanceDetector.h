@@ -29,6 +29,7 @@
 #include "monosat/dgl/Reach.h"
 #include "monosat/dgl/Distance.h"
 #include "monosat/dgl/Dijkstra.h"
+#include "monosat/dgl/BidirectionalDijkstra.h"
 #include "monosat/dgl/BFS.h"
 #include "monosat/dgl/MaxFlow.h"
 #include "monosat/core/SolverTypes.h"
@@ -67,6 +68,8 @@ public:
     Distance<Weight>* underapprox_weighted_distance_detector = nullptr;
     Distance<Weight>* overapprox_weighted_distance_detector = nullptr;
     Distance<Weight>* underapprox_weighted_path_detector = nullptr;
+    //landmark lower bounds for -dist=bidirectional, computed on g_over at decision level 0
+    ALTLandmarks<Weight, Graph>* landmarks = nullptr;
 
 
     //vec<Lit>  reach_lits;
@@ -383,6 +386,8 @@ public:
         if(overapprox_weighted_distance_detector)
             delete overapprox_weighted_distance_detector;
 
+        if(landmarks)
+            delete landmarks;
 
         if(rnd_path)
             delete rnd_path;
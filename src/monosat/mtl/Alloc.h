@@ -22,46 +22,97 @@
 
 #include "monosat/mtl/XAlloc.h"
 #include "monosat/mtl/Vec.h"
+#include <cstdint>
+#include <algorithm>
+
+#ifdef MONOSAT_MMAP_ARENA
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 namespace Monosat {
 
 //=================================================================================================
 // Simple Region-based memory allocator:
+//
+// Build options:
+//  MONOSAT_CREF64     - use 64-bit references, lifting the 2^32 word (16 GB) limit on the region.
+//  MONOSAT_MMAP_ARENA - reserve the address space for the region up front with mmap, and commit
+//                       pages as it grows. The region then never moves (so growing it never copies),
+//                       which also allows clause garbage collection to compact it in place.
+
+#ifndef MONOSAT_ARENA_RESERVE_BYTES
+#ifdef MONOSAT_CREF64
+#define MONOSAT_ARENA_RESERVE_BYTES (((uint64_t) 1) << 40)
+#else
+#define MONOSAT_ARENA_RESERVE_BYTES (((uint64_t) 1) << 34)
+#endif
+#endif
 
 template<class T>
 class RegionAllocator {
-    T* memory;
-    uint32_t sz;
-    uint32_t cap;
-    uint32_t wasted_;
-
-    void capacity(uint32_t min_cap);
-
 public:
     // TODO: make this a class for better type-checking?
+#ifdef MONOSAT_CREF64
+    typedef uint64_t Ref;
+#else
     typedef uint32_t Ref;
+#endif
+    static constexpr Ref Ref_Undef = ~((Ref) 0);
     enum {
-        Ref_Undef = UINT32_MAX
+        Unit_Size = sizeof(uint32_t)
     };
+#ifdef MONOSAT_MMAP_ARENA
     enum {
-        Unit_Size = sizeof(uint32_t)
+        Stable_Memory = 1 //memory is never moved when the region grows
     };
+#else
+    enum {
+        Stable_Memory = 0
+    };
+#endif
 
-    explicit RegionAllocator(uint32_t start_cap = 1024 * 1024) :
+private:
+    T* memory;
+    Ref sz;
+    Ref cap;
+    Ref wasted_;
+#ifdef MONOSAT_MMAP_ARENA
+    Ref reserved;//number of elements of address space reserved at 'memory'
+
+    //Commit in multiples of 2MB, so that transparent huge pages can back the region
+    static constexpr uint64_t commit_bytes = ((uint64_t) 1) << 21;
+
+    void reserve();
+
+    void unreserve();
+#endif
+
+    void capacity(Ref min_cap);
+
+public:
+    explicit RegionAllocator(Ref start_cap = 1024 * 1024) :
             memory(NULL), sz(0), cap(0), wasted_(0){
+#ifdef MONOSAT_MMAP_ARENA
+        reserved = 0;
+#endif
         capacity(start_cap);
     }
 
     ~RegionAllocator(){
+#ifdef MONOSAT_MMAP_ARENA
+        unreserve();
+#else
         if(memory != NULL)
             ::free(memory);
+#endif
     }
 
-    uint32_t size() const{
+    Ref size() const{
         return sz;
     }
 
-    uint32_t wasted() const{
+    Ref wasted() const{
         return wasted_;
     }
 
@@ -98,8 +149,14 @@ public:
     }
 
     void moveTo(RegionAllocator& to){
+#ifdef MONOSAT_MMAP_ARENA
+        to.unreserve();
+        to.reserved = reserved;
+        reserved = 0;
+#else
         if(to.memory != NULL)
             ::free(to.memory);
+#endif
         to.memory = memory;
         to.sz = sz;
         to.cap = cap;
@@ -109,20 +166,104 @@ public:
         sz = cap = wasted_ = 0;
     }
 
+    // Discards everything past 'new_sz', and resets the wasted count.
+    // (Used after the contents of the region have been compacted in place.)
+    void truncate(Ref new_sz);
+
 };
 
 template<class T>
-void RegionAllocator<T>::capacity(uint32_t min_cap){
+constexpr typename RegionAllocator<T>::Ref RegionAllocator<T>::Ref_Undef;
+
+#ifdef MONOSAT_MMAP_ARENA
+
+template<class T>
+void RegionAllocator<T>::reserve(){
+    assert(memory == NULL);
+    uint64_t bytes = MONOSAT_ARENA_RESERVE_BYTES - (MONOSAT_ARENA_RESERVE_BYTES % commit_bytes);
+    if(bytes / sizeof(T) >= Ref_Undef)
+        bytes = ((uint64_t) (Ref_Undef - 1) * sizeof(T)) & ~(commit_bytes - 1);
+    // Over-reserve by one commit unit, then trim, so that the region is aligned for huge pages.
+    void* mem = mmap(NULL, bytes + commit_bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if(mem == MAP_FAILED)
+        throw OutOfMemoryException();
+    uintptr_t start = (uintptr_t) mem;
+    uintptr_t aligned = (start + commit_bytes - 1) & ~((uintptr_t) commit_bytes - 1);
+    if(aligned > start)
+        munmap(mem, aligned - start);
+    if(aligned + bytes < start + bytes + commit_bytes)
+        munmap((void*) (aligned + bytes), (start + bytes + commit_bytes) - (aligned + bytes));
+#ifdef MADV_HUGEPAGE
+    madvise((void*) aligned, bytes, MADV_HUGEPAGE);
+#endif
+    memory = (T*) aligned;
+    reserved = bytes / sizeof(T);
+}
+
+template<class T>
+void RegionAllocator<T>::unreserve(){
+    if(memory != NULL)
+        munmap(memory, reserved * sizeof(T));
+    memory = NULL;
+    reserved = 0;
+}
+
+template<class T>
+void RegionAllocator<T>::capacity(Ref min_cap){
     if(cap >= min_cap)
         return;
+    if(memory == NULL)
+        reserve();
+    if(min_cap > reserved)
+        throw OutOfMemoryException();
 
-    uint32_t prev_cap = cap;
+    //Grow by 3/2 (as there is no copying, there is no need for larger steps), in whole commit units
+    uint64_t new_bytes = std::max((uint64_t) min_cap, (uint64_t) cap + (cap >> 1)) * sizeof(T);
+    new_bytes = (new_bytes + commit_bytes - 1) & ~(commit_bytes - 1);
+    Ref new_cap = std::min((Ref) (new_bytes / sizeof(T)), reserved);
+    uint64_t old_bytes = (uint64_t) cap * sizeof(T);
+    if(mprotect(((char*) memory) + old_bytes, (uint64_t) new_cap * sizeof(T) - old_bytes, PROT_READ | PROT_WRITE) != 0)
+        throw OutOfMemoryException();
+    cap = new_cap;
+}
+
+template<class T>
+void RegionAllocator<T>::truncate(Ref new_sz){
+    assert(new_sz <= sz);
+    sz = new_sz;
+    wasted_ = 0;
+    //Give the committed pages past the end of the region back to the OS
+    uint64_t keep_bytes = ((uint64_t) sz * sizeof(T) + commit_bytes - 1) & ~(commit_bytes - 1);
+    uint64_t cap_bytes = (uint64_t) cap * sizeof(T);
+    if(keep_bytes < cap_bytes){
+        char* tail = ((char*) memory) + keep_bytes;
+        madvise(tail, cap_bytes - keep_bytes, MADV_DONTNEED);
+        mprotect(tail, cap_bytes - keep_bytes, PROT_NONE);
+        cap = keep_bytes / sizeof(T);
+    }
+}
+
+#else
+
+template<class T>
+void RegionAllocator<T>::truncate(Ref new_sz){
+    assert(new_sz <= sz);
+    sz = new_sz;
+    wasted_ = 0;
+}
+
+template<class T>
+void RegionAllocator<T>::capacity(Ref min_cap){
+    if(cap >= min_cap)
+        return;
+
+    Ref prev_cap = cap;
     while(cap < min_cap){
         // NOTE: Multiply by a factor (13/8) without causing overflow, then add 2 and make the
         // result even by clearing the least significant bit. The resulting sequence of capacities
         // is carefully chosen to hit a maximum capacity that is close to the '2^32-1' limit when
         // using 'uint32_t' as indices so that as much as possible of this space can be used.
-        uint32_t delta = ((cap >> 1) + (cap >> 3) + 2) & ~1;
+        Ref delta = ((cap >> 1) + (cap >> 3) + 2) & ~((Ref) 1);
         cap += delta;
 
         if(cap <= prev_cap)
@@ -131,16 +272,18 @@ void RegionAllocator<T>::capacity(uint32_t min_cap){
     // printf(" .. (%p) cap = %u\n", this, cap);
 
     assert(cap > 0);
-    memory = (T*) xrealloc(memory, sizeof(T) * cap);
+    memory = (T*) xrealloc(memory, sizeof(T) * (size_t) cap);
 }
 
+#endif
+
 template<class T>
 typename RegionAllocator<T>::Ref RegionAllocator<T>::alloc(int size){
     // printf("ALLOC called (this = %p, size = %d)\n", this, size); fflush(stdout);
     assert(size > 0);
     capacity(sz + size);
 
-    uint32_t prev_sz = sz;
+    Ref prev_sz = sz;
     sz += size;
 
     // Handle overflow:
@@ -284,7 +284,10 @@ public:
 
         int lev = level(v);
 
-        assert(decisionLevel() <= lev);
+        //With chronological backtracking (-chrono), lev may be lower than decisionLevel(), if the SAT solver assigned l
+        //out of order; l is then recorded at the current level, and re-enqueued by the SAT solver if this theory
+        //backtracks past it.
+        assert(opt_chrono >= 0 || decisionLevel() <= lev);
         if(value(l) != l_Undef)
             return;
         while(lev > trail_lim.size()){
@@ -342,7 +345,7 @@ public:
 
         stats_propagations++;
 
-        static int iter = 0;
+        static thread_local int iter = 0;
         ++iter;
         double startproptime = rtime(2);
 
@@ -413,8 +416,6 @@ public:
             }else if(rhs_val == l_True && overApprox < total){
                 //conflict
                 assert(pbclause.side != ConstraintSide::Lower);
-                static int iter = 0;
-                ++iter;
                 conflict.push(~rhs);
                 buildSumLTReason(clauseID, conflict);
                 dbg_prove(pbclause, conflict);
@@ -1333,10 +1334,6 @@ public:
         stats_reasons++;
 
         int clauseID = reasonMap[marker];
-        static int iter = 0;
-        if(++iter == 13){
-            int a = 1;
-        }
         PbClause& pbclause = clauses[clauseID];
         reason.push(p);
         if(var(p) == var(pbclause.rhs.lit)){
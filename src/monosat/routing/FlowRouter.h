@@ -214,7 +214,7 @@ public:
             auto* over_reach = reach;
             auto* over_path = reach;
 
-            static int iter = 0;
+            static thread_local int iter = 0;
             if(++iter == 109){
                 int a = 1;
             };
@@ -293,7 +293,8 @@ public:
                 return true;
             }
 
-            if(last_over_history_clear != g_over.historyclears || last_under_history_clear != g_under.historyclears){
+            if(last_over_history_clear != g_over.historyclears || last_under_history_clear != g_under.historyclears
+               || over_history_qhead < g_over.historyStart() || under_history_qhead < g_under.historyStart()){
                 over_history_qhead = g_over.historySize();
                 last_over_history_clear = g_over.historyclears;
                 under_history_qhead = g_under.historySize();
@@ -464,10 +465,6 @@ public:
                         assert(false);
                         return lit_Undef;//if the reach lit is unassigned, do not make any decisions here
                     }
-                    static int iter = 0;
-                    if(++iter == 11){
-                        int a = 1;
-                    }
 
                     if(needsRecompute(to)){
                         r->stats_heuristic_recomputes++;
@@ -796,8 +793,6 @@ template<typename Weight>
 bool FlowRouter<Weight>::propagateTheory(vec<Lit>& conflict, bool solve){
     //for each net to be routed, pick one unrouted endpoint (if any).
     //connect it to destination in g.
-    static int iter = 0;
-    ++iter;
 
     if(!maxflow_detector->propagate(conflict)){
         return false;
@@ -560,6 +560,10 @@ bool SimpSolver::eliminateVar(Var v){
         watches[mkLit(v)].clear(true);
     if(watches[~mkLit(v)].size() == 0)
         watches[~mkLit(v)].clear(true);
+    if(watches_bin[mkLit(v)].size() == 0)
+        watches_bin[mkLit(v)].clear(true);
+    if(watches_bin[~mkLit(v)].size() == 0)
+        watches_bin[~mkLit(v)].clear(true);
 
     return backwardSubsumptionCheck();
 }
@@ -760,16 +764,31 @@ void SimpSolver::relocAll(ClauseAllocator& to){
 }
 
 void SimpSolver::garbageCollect(){
+    cleanUpClauses();
+    if(ClauseAllocator::Stable_Memory){
+        // Compact in place (see Solver::garbageCollect); clauses lose their extra field if ca.extra_clause_field is unset.
+        uint64_t old_size = ca.size();
+        ca.beginCompaction();
+        relocAll(ca);
+        Solver::relocAll(ca);
+        ca.forwardCompaction();
+        relocAll(ca);
+        Solver::relocAll(ca);
+        ca.endCompaction();
+        if(verbosity >= 2)
+            printf("|  Garbage collection:   %12" PRIu64 " bytes => %12" PRIu64 " bytes             |\n",
+                   old_size * ClauseAllocator::Unit_Size, (uint64_t) ca.size() * ClauseAllocator::Unit_Size);
+        return;
+    }
     // Initialize the next region to a size corresponding to the estimated utilization degree. This
     // is not precise but should avoid some unnecessary reallocations for the new region:
     ClauseAllocator to(ca.size() - ca.wasted());
 
-    cleanUpClauses();
     to.extra_clause_field = ca.extra_clause_field; // NOTE: this is important to keep (or lose) the extra fields.
     relocAll(to);
     Solver::relocAll(to);
     if(verbosity >= 2)
-        printf("|  Garbage collection:   %12d bytes => %12d bytes             |\n",
-               ca.size() * ClauseAllocator::Unit_Size, to.size() * ClauseAllocator::Unit_Size);
+        printf("|  Garbage collection:   %12" PRIu64 " bytes => %12" PRIu64 " bytes             |\n",
+               (uint64_t) ca.size() * ClauseAllocator::Unit_Size, (uint64_t) to.size() * ClauseAllocator::Unit_Size);
     to.moveTo(ca);
 }
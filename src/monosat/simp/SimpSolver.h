@@ -80,7 +80,7 @@ public:
     // Variable mode:
     //
     void setFrozen(Var v, bool b); // If a variable is frozen it will not be eliminated.
-    bool isEliminated(Var v) const;
+    bool isEliminated(Var v) const override;
 
     // Alternative freeze interface (may replace 'setFrozen()'):
     void freezeVar(Var v);         // Freeze one variable so it will not be eliminated.